@@ -0,0 +1,19 @@
+/**
+ * @file Adafruit_BME280.h
+ * @brief Host replacement for the BME280 driver (env:native only)
+ *
+ * Readings are set with hal_bmeSet().
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class Adafruit_BME280 {
+public:
+    bool begin(uint8_t addr = 0x77, TwoWire* wire = &Wire);
+    float readTemperature();
+    float readHumidity();
+    float readPressure();
+};
@@ -0,0 +1,186 @@
+/**
+ * @file Arduino.h
+ * @brief Host replacement for the Arduino core (env:native only)
+ *
+ * Provides the subset of the Arduino API used by the portable modules.
+ * Time, GPIO, ADC and LEDC are backed by the fake hardware in hal_native.cpp.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define CHANGE  0x03
+#define FALLING 0x02
+#define RISING  0x01
+
+#define HEX 16
+#define DEC 10
+
+#define IRAM_ATTR
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// newlib (ESP32) has strlcpy, older glibc does not
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+// --- Time ---
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+// --- GPIO / ADC / LEDC ---
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+uint16_t analogRead(uint8_t pin);
+int8_t digitalPinToAnalogChannel(uint8_t pin);   // ESP32-S3: GPIO1..10 = ADC1, GPIO11..20 = ADC2
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+/**
+ * @class String
+ * @brief Minimal Arduino String on top of std::string
+ */
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const std::string &s) : s_(s) {}
+    String(char c) : s_(1, c) {}
+    String(int v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(unsigned int v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(long v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(unsigned long v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(unsigned long long v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(unsigned char v, int base = DEC) : s_(fmt((long long)v, base)) {}
+    String(float v, unsigned int decimals = 2) : s_(fmtf(v, decimals)) {}
+    String(double v, unsigned int decimals = 2) : s_(fmtf(v, decimals)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return s_.length(); }
+    char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+
+    String &operator+=(const String &o) { s_ += o.s_; return *this; }
+    String &operator+=(const char* o) { s_ += o; return *this; }
+    String &operator+=(char c) { s_ += c; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+    friend String operator+(const String &a, const char* b) { return String(a.s_ + b); }
+    friend String operator+(const char* a, const String &b) { return String(a + b.s_); }
+    bool operator==(const String &o) const { return s_ == o.s_; }
+    bool operator==(const char* o) const { return s_ == o; }
+    bool operator!=(const String &o) const { return s_ != o.s_; }
+
+    bool startsWith(const String &p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+    bool endsWith(const String &p) const {
+        return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+    }
+    bool equalsIgnoreCase(const String &o) const {
+        return s_.size() == o.s_.size() && strncasecmp(s_.c_str(), o.s_.c_str(), s_.size()) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t p = s_.find(c, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int indexOf(const String &str, unsigned int from = 0) const {
+        size_t p = s_.find(str.s_, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s_.size()) return String();
+        return String(s_.substr(from, to - from));
+    }
+    void remove(unsigned int index, unsigned int count) { if (index < s_.size()) s_.erase(index, count); }
+    void trim() {
+        size_t b = s_.find_first_not_of(" \t\r\n");
+        size_t e = s_.find_last_not_of(" \t\r\n");
+        s_ = (b == std::string::npos) ? std::string() : s_.substr(b, e - b + 1);
+    }
+    long toInt() const { return atol(s_.c_str()); }
+    float toFloat() const { return (float)atof(s_.c_str()); }
+    void reserve(unsigned int n) { s_.reserve(n); }
+
+private:
+    static std::string fmt(long long v, int base) {
+        char buf[32];
+        if (base == HEX) snprintf(buf, sizeof(buf), "%llx", v);
+        else snprintf(buf, sizeof(buf), "%lld", v);
+        return buf;
+    }
+    static std::string fmtf(double v, unsigned int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+
+    std::string s_;
+};
+
+/**
+ * @class Print
+ * @brief Minimal Print interface (stdout based)
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (len--) n += write(*buf++);
+        return n;
+    }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t println(const char* s) { return print(s) + print("\n"); }
+    size_t println(const String &s) { return println(s.c_str()); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port writing to stdout
+ */
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,29 @@
+/**
+ * @file DallasTemperature.h
+ * @brief Host replacement for the DS18B20 driver (env:native only)
+ *
+ * Probes and their readings are set with hal_ds18b20Set().
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <OneWire.h>
+
+#define DEVICE_DISCONNECTED_C -127.0f
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature {
+public:
+    DallasTemperature() {}
+    explicit DallasTemperature(OneWire* wire) { (void)wire; }
+    void setOneWire(OneWire* wire) { (void)wire; }
+    void begin() {}
+    uint8_t getDeviceCount();
+    bool getAddress(uint8_t* address, uint8_t index);
+    bool setResolution(const uint8_t* address, uint8_t bits) { (void)address; (void)bits; return true; }
+    void setWaitForConversion(bool wait) { (void)wait; }
+    void requestTemperatures() {}
+    float getTempC(const uint8_t* address);
+};
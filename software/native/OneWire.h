@@ -0,0 +1,17 @@
+/**
+ * @file OneWire.h
+ * @brief Host replacement for the 1-Wire driver (env:native only)
+ *
+ * Only a placeholder for DallasTemperature, the probes are simulated there.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class OneWire {
+public:
+    OneWire() {}
+    explicit OneWire(uint8_t pin) { (void)pin; }
+    void begin(uint8_t pin) { (void)pin; }
+};
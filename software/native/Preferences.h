@@ -0,0 +1,61 @@
+/**
+ * @file Preferences.h
+ * @brief Host replacement for the ESP32 Preferences (NVS) API (env:native only)
+ *
+ * Keys live in memory for the lifetime of the process, like an erased
+ * NVS partition after every start of the simulation.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @class Preferences
+ * @brief One opened NVS namespace
+ */
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        ns_ = name;
+        readOnly_ = readOnly;
+        return true;
+    }
+
+    void end() {}
+
+    size_t getBytesLength(const char* key) {
+        auto it = store().find(ns_ + "/" + key);
+        return it == store().end() ? 0 : it->second.size();
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = store().find(ns_ + "/" + key);
+        if (it == store().end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (readOnly_) return 0;
+        const uint8_t* p = static_cast<const uint8_t*>(value);
+        store()[ns_ + "/" + key] = std::vector<uint8_t>(p, p + len);
+        return len;
+    }
+
+    bool remove(const char* key) {
+        return !readOnly_ && store().erase(ns_ + "/" + key) > 0;
+    }
+
+private:
+    static std::map<std::string, std::vector<uint8_t>> &store() {
+        static std::map<std::string, std::vector<uint8_t>> s;
+        return s;
+    }
+
+    std::string ns_;
+    bool readOnly_ = false;
+};
@@ -0,0 +1,80 @@
+/**
+ * @file SD.h
+ * @brief Host replacement for the ESP32 SD/FS API (env:native only)
+ *
+ * The SD card root is mapped to a host directory, set with
+ * hal_setSdRoot() (default: ./sdcard).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <dirent.h>
+#include <time.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+typedef enum { CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC, CARD_UNKNOWN } sdcard_type_t;
+
+/**
+ * @class File
+ * @brief File or directory handle on the host file system
+ */
+class File : public Print {
+public:
+    File() {}
+    File(FILE* f, DIR* d, const std::string &path, const std::string &name)
+        : f_(f), d_(d), path_(path), name_(name) {}
+
+    explicit operator bool() const { return f_ != nullptr || d_ != nullptr; }
+
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t* buf, size_t len);
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    void flush();
+    bool seek(uint32_t pos);
+    size_t position();
+    size_t size();
+    time_t getLastWrite();
+    void close();
+
+    String readString();
+    String readStringUntil(char terminator);
+
+    const char* name() const { return name_.c_str(); }
+    const char* path() const { return path_.c_str(); }
+    bool isDirectory() const { return d_ != nullptr; }
+    File openNextFile();
+
+private:
+    FILE* f_ = nullptr;
+    DIR* d_ = nullptr;
+    std::string path_;
+    std::string name_;
+};
+
+/**
+ * @class SDFS
+ * @brief SD card object
+ */
+class SDFS {
+public:
+    bool begin(uint8_t ssPin, SPIClass &spi);
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    bool exists(const char* path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    File open(const char* path, const char* mode = FILE_READ);
+    File open(const String &path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+};
+
+extern SDFS SD;
@@ -0,0 +1,18 @@
+/**
+ * @file SPI.h
+ * @brief Host replacement for the ESP32 SPI class (env:native only)
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define FSPI 0
+
+class SPIClass {
+public:
+    explicit SPIClass(uint8_t bus = 0) { (void)bus; }
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+        (void)sck; (void)miso; (void)mosi; (void)ss;
+    }
+};
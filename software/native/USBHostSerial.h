@@ -0,0 +1,20 @@
+/**
+ * @file USBHostSerial.h
+ * @brief Host replacement for the CH341 USB host driver (env:native only)
+ *
+ * Received bytes are injected with hal_usbInject(), written commands
+ * are collected and can be read back with hal_usbTakeWritten().
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class USBHostSerial {
+public:
+    bool begin(int baud, int stopbits, int parity, int databits);
+    void end() {}
+    size_t available();
+    uint8_t read();
+    size_t write(const uint8_t* data, size_t len);
+};
@@ -0,0 +1,43 @@
+/**
+ * @file ledc.h
+ * @brief Host replacement for the ESP-IDF LEDC driver (env:native only)
+ *
+ * Duty and hpoint of each channel are kept in hal_native.cpp
+ * (hal_getLedc(), hal_getLedcHpoint()).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+typedef enum { LEDC_LOW_SPEED_MODE = 0 } ledc_mode_t;
+typedef int ledc_channel_t;
+typedef int ledc_timer_t;
+typedef int ledc_timer_bit_t;
+typedef enum { LEDC_AUTO_CLK = 0 } ledc_clk_cfg_t;
+typedef enum { LEDC_INTR_DISABLE = 0 } ledc_intr_type_t;
+
+typedef struct {
+    ledc_mode_t speed_mode;
+    ledc_timer_bit_t duty_resolution;
+    ledc_timer_t timer_num;
+    uint32_t freq_hz;
+    ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+    int gpio_num;
+    ledc_mode_t speed_mode;
+    ledc_channel_t channel;
+    ledc_intr_type_t intr_type;
+    ledc_timer_t timer_sel;
+    uint32_t duty;
+    int hpoint;
+} ledc_channel_config_t;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* timer);
+esp_err_t ledc_channel_config(const ledc_channel_config_t* channel);
+esp_err_t ledc_set_duty_with_hpoint(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint);
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel);
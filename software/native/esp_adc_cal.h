@@ -0,0 +1,29 @@
+/**
+ * @file esp_adc_cal.h
+ * @brief Host replacement for the ESP-IDF ADC calibration (env:native only)
+ *
+ * The fake ADC is ideal: 0..4095 maps linearly to 0..3300 mV, like the
+ * raw values given to hal_setAnalog().
+ */
+
+#pragma once
+
+#include <driver/adc.h>
+
+typedef enum {
+    ESP_ADC_CAL_VAL_EFUSE_VREF = 0,
+    ESP_ADC_CAL_VAL_EFUSE_TP,
+    ESP_ADC_CAL_VAL_DEFAULT_VREF,
+    ESP_ADC_CAL_VAL_EFUSE_TP_FIT
+} esp_adc_cal_value_t;
+
+typedef struct {
+    adc_unit_t adc_num;
+    adc_atten_t atten;
+    adc_bits_width_t bit_width;
+    uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width,
+                                             uint32_t default_vref, esp_adc_cal_characteristics_t* chars);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t* chars);
@@ -0,0 +1,413 @@
+/**
+ * @file hal_native.cpp
+ * @brief Fake hardware state behind the native Arduino/library headers
+ */
+
+#include "hal_native.h"
+#include <SD.h>
+#include <Wire.h>
+#include <USBHostSerial.h>
+#include <Adafruit_BME280.h>
+#include <DallasTemperature.h>
+#include <driver/ledc.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <deque>
+
+#define HAL_PIN_COUNT 64
+#define HAL_LEDC_COUNT 16
+
+static uint32_t nowMs = 0;
+static int digitalLevel[HAL_PIN_COUNT];
+static int digitalOut[HAL_PIN_COUNT];
+static uint8_t pinModes[HAL_PIN_COUNT];
+static uint16_t analogRaw[HAL_PIN_COUNT];
+static uint16_t analogNoise = 0;
+static void (*pinIsr[HAL_PIN_COUNT])();
+static uint32_t ledcDuty[HAL_LEDC_COUNT];
+static uint32_t ledcHpoint[HAL_LEDC_COUNT];
+
+// Continuous ADC
+static adc_digi_pattern_config_t adcPattern[SOC_ADC_MAX_CHANNEL_NUM];
+static uint32_t adcPatternCount = 0;
+static uint32_t adcRate = 0;
+static uint32_t adcBufferResults = 0;
+static uint32_t adcNext = 0;            // next pattern entry
+static uint32_t adcLastMs = 0;
+static bool adcRunning = false;
+
+static std::string sdRoot = "sdcard";
+static bool sdPresent = true;
+
+static bool usbConnected = true;
+static std::deque<uint8_t> usbRx;
+static std::string usbTx;
+
+static bool bmePresent = true;
+static float bmeTemp = 20.0f;
+static float bmeHum = 50.0f;
+static float bmePres = 1013.0f;
+
+#define HAL_DS18B20_COUNT 4
+static float ds18b20Temp[HAL_DS18B20_COUNT] = { NAN, NAN, NAN, NAN };
+
+HardwareSerial Serial;
+TwoWire Wire;
+SDFS SD;
+
+// ---------------- Control API ----------------
+
+void hal_setMillis(uint32_t ms) { nowMs = ms; }
+void hal_advanceMillis(uint32_t ms) { nowMs += ms; }
+
+void hal_setDigital(uint8_t pin, int level) {
+    if (pin >= HAL_PIN_COUNT) return;
+    bool changed = digitalLevel[pin] != level;
+    digitalLevel[pin] = level;
+    if (changed && pinIsr[pin]) pinIsr[pin]();
+}
+
+int hal_getDigital(uint8_t pin) { return pin < HAL_PIN_COUNT ? digitalOut[pin] : LOW; }
+void hal_setAnalog(uint8_t pin, uint16_t raw) { if (pin < HAL_PIN_COUNT) analogRaw[pin] = raw; }
+void hal_setAnalogNoise(uint16_t counts) { analogNoise = counts; }
+
+/**
+ * @brief One conversion of an analog pin with the configured noise
+ */
+static uint16_t convert(uint8_t pin) {
+    int32_t v = pin < HAL_PIN_COUNT ? analogRaw[pin] : 0;
+    if (analogNoise > 0) v += rand() % (2 * analogNoise + 1) - analogNoise;
+    return (uint16_t)constrain(v, 0, 4095);
+}
+uint32_t hal_getLedc(uint8_t channel) { return channel < HAL_LEDC_COUNT ? ledcDuty[channel] : 0; }
+uint32_t hal_getLedcHpoint(uint8_t channel) { return channel < HAL_LEDC_COUNT ? ledcHpoint[channel] : 0; }
+
+void hal_setSdRoot(const char* dir) { sdRoot = dir; }
+void hal_setSdPresent(bool present) { sdPresent = present; }
+
+void hal_usbSetConnected(bool connected) { usbConnected = connected; }
+void hal_usbInject(const char* data, size_t len) { usbRx.insert(usbRx.end(), data, data + len); }
+
+String hal_usbTakeWritten() {
+    String out(usbTx);
+    usbTx.clear();
+    return out;
+}
+
+void hal_bmeSetPresent(bool present) { bmePresent = present; }
+
+void hal_bmeSet(float tempC, float humidity, float pressure) {
+    bmeTemp = tempC;
+    bmeHum = humidity;
+    bmePres = pressure;
+}
+
+void hal_ds18b20Set(uint8_t index, float tempC) {
+    if (index < HAL_DS18B20_COUNT) ds18b20Temp[index] = tempC;
+}
+
+// ---------------- Arduino core ----------------
+
+uint32_t millis() { return nowMs; }
+uint32_t micros() { return nowMs * 1000; }
+void delay(uint32_t ms) { nowMs += ms; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= HAL_PIN_COUNT) return;
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP) digitalLevel[pin] = HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= HAL_PIN_COUNT) return LOW;
+    // Outputs read back their driven level, like on the ESP32
+    return pinModes[pin] == OUTPUT ? digitalOut[pin] : digitalLevel[pin];
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < HAL_PIN_COUNT) digitalOut[pin] = val; }
+uint16_t analogRead(uint8_t pin) { return convert(pin); }
+
+int8_t digitalPinToAnalogChannel(uint8_t pin) { return pin >= 1 && pin <= 20 ? (int8_t)(pin - 1) : -1; }
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution) {
+    (void)channel; (void)resolution;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) { (void)pin; (void)channel; }
+void ledcWrite(uint8_t channel, uint32_t duty) { if (channel < HAL_LEDC_COUNT) ledcDuty[channel] = duty; }
+uint32_t ledcRead(uint8_t channel) { return hal_getLedc(channel); }
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* timer) { (void)timer; return 0; }
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* channel) {
+    return ledc_set_duty_with_hpoint(channel->speed_mode, channel->channel, channel->duty, channel->hpoint);
+}
+
+esp_err_t ledc_set_duty_with_hpoint(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint) {
+    (void)mode;
+    if (channel < 0 || channel >= HAL_LEDC_COUNT) return -1;
+    ledcDuty[channel] = duty;
+    ledcHpoint[channel] = hpoint;
+    return 0;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel) { (void)mode; (void)channel; return 0; }
+
+// ---------------- ADC driver ----------------
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init_config) {
+    adcBufferResults = init_config->max_store_buf_size / sizeof(adc_digi_output_data_t);
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+    if (config->pattern_num == 0 || config->pattern_num > SOC_ADC_MAX_CHANNEL_NUM) return ESP_ERR_INVALID_STATE;
+    memcpy(adcPattern, config->adc_pattern, config->pattern_num * sizeof(adc_digi_pattern_config_t));
+    adcPatternCount = config->pattern_num;
+    adcRate = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_start() {
+    adcRunning = true;
+    adcLastMs = nowMs;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_stop() { adcRunning = false; return ESP_OK; }
+esp_err_t adc_digi_deinitialize() { adcRunning = false; adcPatternCount = 0; return ESP_OK; }
+
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    *out_length = 0;
+    if (!adcRunning) return ESP_ERR_INVALID_STATE;
+
+    // Conversions since the last read, at most what the driver buffer holds
+    uint32_t pending = (nowMs - adcLastMs) * adcRate / 1000;
+    bool overflow = pending > adcBufferResults;
+    if (overflow) pending = adcBufferResults;
+    uint32_t n = length_max / sizeof(adc_digi_output_data_t);
+    if (n > pending) n = pending;
+    if (n == 0) return ESP_ERR_TIMEOUT;
+    adcLastMs = nowMs - (pending - n) * 1000 / adcRate;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const adc_digi_pattern_config_t &p = adcPattern[adcNext];
+        adcNext = (adcNext + 1) % adcPatternCount;
+        adc_digi_output_data_t r;
+        r.val = 0;
+        r.type2.channel = p.channel;
+        r.type2.unit = 0;
+        r.type2.data = convert(p.channel + 1);
+        memcpy(buf + i * sizeof(r), &r, sizeof(r));
+    }
+    *out_length = n * sizeof(adc_digi_output_data_t);
+    return overflow ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width,
+                                             uint32_t default_vref, esp_adc_cal_characteristics_t* chars) {
+    chars->adc_num = adc_num;
+    chars->atten = atten;
+    chars->bit_width = bit_width;
+    chars->vref = default_vref;
+    return ESP_ADC_CAL_VAL_EFUSE_TP_FIT;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t* chars) {
+    (void)chars;
+    return (adc_reading * 3300 + 2047) / 4095;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    (void)mode;
+    if (pin < HAL_PIN_COUNT) pinIsr[pin] = isr;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)buf, strlen(buf));
+}
+
+// ---------------- SD card ----------------
+
+static std::string hostPath(const char* path) {
+    return sdRoot + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool SDFS::begin(uint8_t ssPin, SPIClass &spi) {
+    (void)ssPin; (void)spi;
+    if (!sdPresent) return false;
+    ::mkdir(sdRoot.c_str(), 0755);
+    return true;
+}
+
+sdcard_type_t SDFS::cardType() { return sdPresent ? CARD_SDHC : CARD_NONE; }
+uint64_t SDFS::cardSize() { return 8ULL * 1024 * 1024 * 1024; }
+
+bool SDFS::exists(const char* path) {
+    struct stat st;
+    return ::stat(hostPath(path).c_str(), &st) == 0;
+}
+
+File SDFS::open(const char* path, const char* mode) {
+    std::string hp = hostPath(path);
+    const char* slash = strrchr(path, '/');
+    std::string name = slash ? slash + 1 : path;
+
+    struct stat st;
+    if (::stat(hp.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR* d = opendir(hp.c_str());
+        return d ? File(nullptr, d, path, name) : File();
+    }
+
+    FILE* f = fopen(hp.c_str(), mode);
+    return f ? File(f, nullptr, path, name) : File();
+}
+
+bool SDFS::remove(const char* path) { return ::remove(hostPath(path).c_str()) == 0; }
+bool SDFS::rename(const char* from, const char* to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+bool SDFS::mkdir(const char* path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+
+int File::available() {
+    if (!f_) return 0;
+    long pos = ftell(f_);
+    fseek(f_, 0, SEEK_END);
+    long end = ftell(f_);
+    fseek(f_, pos, SEEK_SET);
+    return (int)(end - pos);
+}
+
+int File::read() { return f_ ? fgetc(f_) : -1; }
+
+int File::peek() {
+    if (!f_) return -1;
+    int c = fgetc(f_);
+    if (c != EOF) ungetc(c, f_);
+    return c;
+}
+
+size_t File::read(uint8_t* buf, size_t len) { return f_ ? fread(buf, 1, len, f_) : 0; }
+size_t File::write(uint8_t c) { return f_ ? fwrite(&c, 1, 1, f_) : 0; }
+size_t File::write(const uint8_t* buf, size_t len) { return f_ ? fwrite(buf, 1, len, f_) : 0; }
+void File::flush() { if (f_) fflush(f_); }
+bool File::seek(uint32_t pos) { return f_ && fseek(f_, pos, SEEK_SET) == 0; }
+size_t File::position() { return f_ ? ftell(f_) : 0; }
+
+size_t File::size() {
+    struct stat st;
+    return ::stat(hostPath(path_.c_str()).c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+time_t File::getLastWrite() {
+    struct stat st;
+    return ::stat(hostPath(path_.c_str()).c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+void File::close() {
+    if (f_) fclose(f_);
+    if (d_) closedir(d_);
+    f_ = nullptr;
+    d_ = nullptr;
+}
+
+String File::readString() {
+    std::string s;
+    int c;
+    while ((c = read()) >= 0) s += (char)c;
+    return String(s);
+}
+
+String File::readStringUntil(char terminator) {
+    std::string s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) s += (char)c;
+    return String(s);
+}
+
+File File::openNextFile() {
+    if (!d_) return File();
+    struct dirent* e;
+    while ((e = readdir(d_)) != nullptr) {
+        if (e->d_name[0] == '.') continue;
+        std::string child = path_ + (path_.size() && path_.back() == '/' ? "" : "/") + e->d_name;
+        return SD.open(child.c_str(), FILE_READ);
+    }
+    return File();
+}
+
+// ---------------- USB host serial ----------------
+
+bool USBHostSerial::begin(int baud, int stopbits, int parity, int databits) {
+    (void)baud; (void)stopbits; (void)parity; (void)databits;
+    return usbConnected;
+}
+
+size_t USBHostSerial::available() { return usbConnected ? usbRx.size() : 0; }
+
+uint8_t USBHostSerial::read() {
+    if (usbRx.empty()) return 0;
+    uint8_t c = usbRx.front();
+    usbRx.pop_front();
+    return c;
+}
+
+size_t USBHostSerial::write(const uint8_t* data, size_t len) {
+    if (!usbConnected) return 0;
+    usbTx.append((const char*)data, len);
+    return len;
+}
+
+// ---------------- BME280 ----------------
+
+bool Adafruit_BME280::begin(uint8_t addr, TwoWire* wire) {
+    (void)addr; (void)wire;
+    return bmePresent;
+}
+
+float Adafruit_BME280::readTemperature() { return bmeTemp; }
+float Adafruit_BME280::readHumidity() { return bmeHum; }
+float Adafruit_BME280::readPressure() { return bmePres * 100.0f; }
+
+// ---------------- DS18B20 ----------------
+// Address: family code 0x28, byte 1 = index in ds18b20Temp
+
+uint8_t DallasTemperature::getDeviceCount() {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < HAL_DS18B20_COUNT; i++) {
+        if (!isnan(ds18b20Temp[i])) n++;
+    }
+    return n;
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t index) {
+    for (uint8_t i = 0; i < HAL_DS18B20_COUNT; i++) {
+        if (isnan(ds18b20Temp[i])) continue;
+        if (index-- == 0) {
+            memset(address, 0, 8);
+            address[0] = 0x28;
+            address[1] = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+float DallasTemperature::getTempC(const uint8_t* address) {
+    if (address[0] != 0x28 || address[1] >= HAL_DS18B20_COUNT || isnan(ds18b20Temp[address[1]])) {
+        return DEVICE_DISCONNECTED_C;
+    }
+    return roundf(ds18b20Temp[address[1]] * 16.0f) / 16.0f;   // 12 bit
+}
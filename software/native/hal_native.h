@@ -0,0 +1,122 @@
+/**
+ * @file hal_native.h
+ * @brief Fake hardware of the native host build
+ *
+ * The portable modules use the regular Arduino/library API. In env:native
+ * those headers are replaced by the ones in this directory, which are
+ * backed by the state below. Host programs drive the simulation with
+ * these functions.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+// --- Time ---
+
+/**
+ * @brief Sets the simulated time (ms since boot).
+ */
+void hal_setMillis(uint32_t ms);
+
+/**
+ * @brief Advances the simulated time.
+ */
+void hal_advanceMillis(uint32_t ms);
+
+/**
+ * @brief Runs the task manager jobs for a simulated duration.
+ *
+ * Time jumps from deadline to deadline, so simulating hours takes
+ * milliseconds. Jobs of all tasks run in one host thread.
+ */
+void hal_runTasks(uint32_t durationMs);
+
+// --- GPIO / ADC / LEDC ---
+
+/**
+ * @brief Sets the level returned by digitalRead() and fires attached interrupts.
+ */
+void hal_setDigital(uint8_t pin, int level);
+
+/**
+ * @brief Returns the last level written with digitalWrite().
+ */
+int hal_getDigital(uint8_t pin);
+
+/**
+ * @brief Sets the raw value of an analog pin (0..4095 = 0..3.3 V).
+ *
+ * Returned by analogRead() and by the continuous ADC driver.
+ */
+void hal_setAnalog(uint8_t pin, uint16_t raw);
+
+/**
+ * @brief Adds uniform noise of +-counts to every conversion (default 0).
+ */
+void hal_setAnalogNoise(uint16_t counts);
+
+/**
+ * @brief Returns the last duty written to an LEDC channel.
+ */
+uint32_t hal_getLedc(uint8_t channel);
+
+/**
+ * @brief Returns the hpoint (start of the on-period) of an LEDC channel.
+ */
+uint32_t hal_getLedcHpoint(uint8_t channel);
+
+// --- SD card ---
+
+/**
+ * @brief Sets the host directory used as SD card root.
+ */
+void hal_setSdRoot(const char* dir);
+
+/**
+ * @brief Simulates a missing SD card (SD.begin() fails).
+ */
+void hal_setSdPresent(bool present);
+
+// --- USB host serial ---
+
+/**
+ * @brief Controls whether USBHostSerial::begin() finds a device.
+ */
+void hal_usbSetConnected(bool connected);
+
+/**
+ * @brief Queues bytes as if received from the cover.
+ */
+void hal_usbInject(const char* data, size_t len);
+
+/**
+ * @brief Returns and clears everything written to the cover.
+ */
+String hal_usbTakeWritten();
+
+// --- BME280 ---
+
+/**
+ * @brief Controls whether the BME280 answers on the bus.
+ */
+void hal_bmeSetPresent(bool present);
+
+/**
+ * @brief Sets the BME280 readings.
+ *
+ * @param tempC    Temperature (°C)
+ * @param humidity Relative humidity (%)
+ * @param pressure Pressure (hPa)
+ */
+void hal_bmeSet(float tempC, float humidity, float pressure);
+
+// --- DS18B20 ---
+
+/**
+ * @brief Sets the reading of a DS18B20 on the 1-Wire bus.
+ *
+ * @param index Position in bus search order (0..3)
+ * @param tempC Temperature (°C), NAN = probe not connected
+ */
+void hal_ds18b20Set(uint8_t index, float tempC);
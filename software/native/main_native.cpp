@@ -0,0 +1,243 @@
+/**
+ * @file main_native.cpp
+ * @brief Host simulation of the controller (env:native)
+ *
+ * Boots the portable modules against the fake hardware and runs a
+ * night in simulated time: the cover streams its status once per second,
+ * humidity rises towards the dew point and a button is pressed.
+ *
+ * Both heaters drive a simulated optic (first-order, with radiative
+ * cooling below ambient). At the end the heater energy and the time the
+ * optics spent below the dew point are printed, to compare the dew modes.
+ * "probe" adds lens probes (DS18B20 on heater 1, NTC on heater 2) and
+ * regulates both heaters with the PID loop. The time both heaters are
+ * switched on together (peak current) is printed with and without the
+ * phase offset of heater 2.
+ *
+ * The 12 V supply is a battery that discharges during the night
+ * (SIM_BATTERY_*), so the low-voltage shedding of the power budget acts
+ * towards the end of a long run. All analog inputs carry
+ * SIM_ADC_NOISE, like the real ADC.
+ *
+ * Usage: program [minutes] [ramp|mpc|probe]   (default 30, mode from config)
+ */
+
+// The test runner brings its own main() (pio test -e native)
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include "hal_native.h"
+#include "pins.h"
+#include "analog_input.h"
+#include "sdcard.h"
+#include "config_manager.h"
+#include "config_parser.h"
+#include "led_manager.h"
+#include "button_manager.h"
+#include "power_control.h"
+#include "web_log.h"
+#include "log_spool.h"
+#include "bme280_manager.h"
+#include "dew_controller.h"
+#include "usb_manager.h"
+#include "task_manager.h"
+#include "lens_probe.h"
+#include "power_budget.h"
+
+/**
+ * @brief Simulated optic behind one heater
+ */
+struct SimOptic {
+    float tau;          ///< s
+    float gain;         ///< °C above ambient at 100 %
+    float temp;         ///< °C
+    float energyWh;
+    uint32_t foggedS;   ///< Seconds below the dew point
+};
+
+// Heater power at 100 % (12 V, 1 A) and radiative cooling of the optics
+#define SIM_HEATER_W    12.0f
+#define SIM_RADIATIVE_C 1.0f
+
+// Battery: open-circuit voltage falls linearly over SIM_BATTERY_HOURS
+#define SIM_BATTERY_FULL_V  12.7f
+#define SIM_BATTERY_EMPTY_V 11.2f
+#define SIM_BATTERY_HOURS   2.0f
+#define SIM_BATTERY_OHM     0.25f
+#define SIM_PANEL_W         6.0f
+
+// ADC noise (+- counts per conversion), removed by the oversampling
+#define SIM_ADC_NOISE       24
+
+// Deliberately different from the model defaults (DEW_MODEL_GAIN/TAU_S)
+static SimOptic optic1 = { 420.0f, 10.0f, 0, 0, 0 };   // main optics
+static SimOptic optic2 = { 200.0f,  6.0f, 0, 0, 0 };   // guide scope
+
+/**
+ * @brief Advances one optic by one second.
+ */
+static void simOptic(SimOptic &o, float ambient, float dewPoint, uint16_t q16) {
+    float duty = (float)q16 / POWER_DUTY_FULL;
+    float target = ambient - SIM_RADIATIVE_C + o.gain * duty;
+    o.temp += (target - o.temp) / o.tau;
+    o.energyWh += duty * SIM_HEATER_W / 3600.0f;
+    if (o.temp < dewPoint) o.foggedS++;
+}
+
+/**
+ * @brief Dew point as in dew_controller.cpp
+ */
+static float simDewPoint(float t, float h) {
+    float gamma = (17.62f * t) / (243.12f + t) + logf(h / 100.0f);
+    return (243.12f * gamma) / (17.62f - gamma);
+}
+
+/**
+ * @brief Share of the PWM period in which both heaters are on (0..1)
+ *
+ * @param staggered Use the hpoint of heater 2, otherwise both start at 0
+ */
+static float simOverlap(bool staggered) {
+    uint32_t d1 = hal_getLedc(PWM_CHANNEL_DEW1);
+    uint32_t d2 = hal_getLedc(PWM_CHANNEL_DEW2);
+    uint32_t h2 = staggered ? hal_getLedcHpoint(PWM_CHANNEL_DEW2) : 0;
+    uint32_t start = max((uint32_t)hal_getLedcHpoint(PWM_CHANNEL_DEW1), h2);
+    uint32_t end = min(hal_getLedcHpoint(PWM_CHANNEL_DEW1) + d1, h2 + d2);
+    return end > start ? (float)(end - start) / (1UL << PWM_RESOLUTION) : 0.0f;
+}
+
+/**
+ * @brief Terminal voltage under the current load, written to the 12 V sense
+ */
+static float simBattery(uint32_t seconds) {
+    float open = SIM_BATTERY_FULL_V - (SIM_BATTERY_FULL_V - SIM_BATTERY_EMPTY_V) * seconds / (SIM_BATTERY_HOURS * 3600.0f);
+    float load = (SIM_HEATER_W * (power_getDuty(POWER_DEW1) + power_getDuty(POWER_DEW2)) +
+                  SIM_PANEL_W * power_getDuty(POWER_PANEL)) / POWER_DUTY_FULL;
+    float v = open - SIM_BATTERY_OHM * load / 12.0f;
+    const float divider = (100000.0f + 22000.0f) / 22000.0f;
+    hal_setAnalog(PIN_VIN_12V_SENSE, (uint16_t)constrain(v / divider / 3.3f * 4095.0f, 0.0f, 4095.0f));
+    return v;
+}
+
+/**
+ * @brief ADC value of the NTC divider at a temperature (see lens_probe.h)
+ */
+static uint16_t simNtcRaw(float tempC) {
+    float r = NTC_R25_OHM * expf(NTC_BETA * (1.0f / (tempC + 273.15f) - 1.0f / 298.15f));
+    return (uint16_t)(4095.0f * r / (r + NTC_SERIES_OHM) + 0.5f);
+}
+
+static const char* COVER_STATUS = "WandererCoverV4A20240101A10.5A270.0A10.5A12.3A0A0A1\n";
+
+/**
+ * @brief Button handling as in main.cpp (open/close only)
+ */
+static void simButtonActions() {
+    if (buttonClicked(BTN_OPEN)) usb_manager_open_cover();
+    if (buttonClicked(BTN_CLOSE)) usb_manager_close_cover();
+}
+
+/**
+ * @brief Log sink: replaces the /log page of the web server
+ */
+static void stdoutSink(const LogRecord &rec, const char* line) {
+    printf("[%8lu] %s\n", (unsigned long)rec.timestamp, line);
+}
+
+/**
+ * @brief Cover simulation: one status line per second
+ */
+static void simCover() {
+    hal_usbInject(COVER_STATUS, strlen(COVER_STATUS));
+}
+
+int main(int argc, char** argv) {
+    uint32_t minutes = argc > 1 ? (uint32_t)atol(argv[1]) : 30;
+    const char* mode = argc > 2 ? argv[2] : nullptr;
+
+    log_begin();
+    log_addSink(stdoutSink);
+    log_spool_begin();
+    initPins();
+    hal_setAnalogNoise(SIM_ADC_NOISE);
+    analog_init();
+    initLeds();
+    power_init();
+    initButtons();
+    setButtonEventHandler(simButtonActions);
+    bool sdAvailable = initSD();
+    if (sdAvailable) log_spool_mount();
+    config_begin(sdAvailable);
+    bme_init();
+    dew_init();
+    powerbudget_init();
+    usb_manager_begin();
+    task_start();
+
+    bool probes = mode != nullptr && strcmp(mode, "probe") == 0;
+    if (mode != nullptr) {
+        ConfigData c = config_get();
+        ConfigDiagCode problem;
+        bool ok = probes ? cparser_set(c, "lens1_probe", "ds18b20", problem) &&
+                           cparser_set(c, "lens2_probe", "ntc", problem)
+                         : cparser_set(c, "dew_mode", mode, problem);
+        if (!ok) {
+            fprintf(stderr, "dew mode %s: %s\n", mode, cparser_diagText(problem));
+            return 1;
+        }
+        config_update(c);
+    }
+
+    optic1.temp = optic2.temp = 12.0f - SIM_RADIATIVE_C;
+    float overlapS = 0;
+    float overlapUnstaggeredS = 0;
+    float minVoltage = SIM_BATTERY_FULL_V;
+    power_setPanel(true);
+
+    for (uint32_t m = 0; m < minutes; m++) {
+        // Temperature drops by 0.2 °C per minute at constant absolute humidity
+        float t = 12.0f - 0.2f * m;
+        float h = min(100.0f, 70.0f * powf(1.07f, 12.0f - t));
+        hal_bmeSet(t, h, 1000.0f);
+        float td = simDewPoint(t, h);
+
+        if (m == 1) {
+            hal_setDigital(PIN_BTN_OPEN, LOW);
+            hal_runTasks(100);
+            hal_setDigital(PIN_BTN_OPEN, HIGH);
+        }
+
+        for (int s = 0; s < 60; s++) {
+            simCover();
+            minVoltage = min(minVoltage, simBattery(m * 60 + s));
+            hal_runTasks(1000);
+            simOptic(optic1, t, td, power_getDuty(POWER_DEW1));
+            simOptic(optic2, t, td, power_getDuty(POWER_DEW2));
+            overlapS += simOverlap(true);
+            overlapUnstaggeredS += simOverlap(false);
+            if (probes) {
+                hal_ds18b20Set(0, optic1.temp);
+                hal_setAnalog(PIN_NTC_LENS2, simNtcRaw(optic2.temp));
+            }
+        }
+
+        DewStatus dew = dew_getStatus();
+        PowerBudgetStatus budget = powerbudget_getStatus();
+        WandererStatus cover = usb_manager_get_parsed_status();
+        printf("t=%3lu min  T=%5.1fC RH=%5.1f%% Td=%5.1fC  dew1=%3d%% (%5.1fC) dew2=%3d%% (%5.1fC)  %5.2fV %4.1fW shed=%u  cover=%s pos=%.1f  tx=\"%s\"\n",
+               (unsigned long)m, dew.temperature, dew.humidity, dew.dewPoint,
+               power_getDew1Level(), optic1.temp, power_getDew2Level(), optic2.temp,
+               budget.voltage, budget.totalWatts, budget.shedLevel,
+               cover.connection_status ? "ok" : "--", cover.current_position,
+               hal_usbTakeWritten().c_str());
+    }
+
+    printf("dew mode %s%s: heater 1 %.2f Wh, fogged %lu s; heater 2 %.2f Wh, fogged %lu s\n",
+           dew_getStatus().mode == DEW_MODE_MPC ? "mpc" : "ramp", probes ? " + lens probes" : "",
+           optic1.energyWh, (unsigned long)optic1.foggedS, optic2.energyWh, (unsigned long)optic2.foggedS);
+    printf("lowest supply %.2f V\n", minVoltage);
+    printf("both heaters on: %.0f s (%.0f s without phase offset)\n", overlapS, overlapUnstaggeredS);
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
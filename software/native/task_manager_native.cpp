@@ -0,0 +1,71 @@
+/**
+ * @file task_manager_native.cpp
+ * @brief Single-threaded task manager for the native host build
+ *
+ * Same API as task_manager.cpp, but all task schedulers are run from
+ * hal_runTasks() in simulated time instead of FreeRTOS tasks.
+ */
+
+#include "task_manager.h"
+#include "scheduler.h"
+#include "hal_native.h"
+
+static Scheduler scheds[TASK_COUNT];
+static uint32_t overruns[TASK_COUNT];
+static bool started = false;
+
+TaskJobId task_register(TaskGroup group, const char* name, TaskHandlerFn fn, uint32_t intervalMs) {
+    if (group >= TASK_COUNT) return TASK_JOB_INVALID;
+    int index = sched_add(scheds[group], name, fn, intervalMs, millis());
+    return index < 0 ? TASK_JOB_INVALID : (TaskJobId)((group << 8) | index);
+}
+
+void task_start() {
+    started = true;
+}
+
+bool task_started() {
+    return started;
+}
+
+void task_trigger(TaskJobId job) {
+    if (job < 0 || (job >> 8) >= TASK_COUNT) return;
+    sched_trigger(scheds[job >> 8], job & 0xFF);
+}
+
+void task_triggerFromISR(TaskJobId job) {
+    task_trigger(job);
+}
+
+void task_runIn(TaskJobId job, uint32_t delayMs) {
+    if (job < 0 || (job >> 8) >= TASK_COUNT) return;
+    sched_runIn(scheds[job >> 8], job & 0xFF, delayMs, millis());
+}
+
+uint32_t task_getOverruns(TaskGroup group) {
+    return group < TASK_COUNT ? overruns[group] : 0;
+}
+
+void hal_runTasks(uint32_t durationMs) {
+    uint32_t end = millis() + durationMs;
+
+    for (;;) {
+        for (uint8_t g = 0; g < TASK_COUNT; g++) {
+            for (uint8_t n = 0; n < scheds[g].count; n++) {
+                int i = sched_nextDue(scheds[g], millis());
+                if (i < 0) break;
+                scheds[g].jobs[i].fn();
+            }
+        }
+
+        uint32_t wait = SCHED_NO_DEADLINE;
+        for (uint8_t g = 0; g < TASK_COUNT; g++) {
+            uint32_t w = sched_timeToNext(scheds[g], millis());
+            if (w < wait) wait = w;
+        }
+
+        int32_t left = (int32_t)(end - millis());
+        if (left <= 0) return;
+        hal_advanceMillis(wait < (uint32_t)left ? (wait ? wait : 1) : (uint32_t)left);
+    }
+}
@@ -0,0 +1,113 @@
+"""
+Embeds the web UI (software/web/*) as gzipped PROGMEM blobs.
+
+Generates src/web_assets.h with one entry per file:
+  web/index.html  -> "/"
+  web/<name>.html -> "/<name>"
+  web/<file>      -> "/<file>"
+
+Runs as a PlatformIO pre-build script and can also be called directly:
+  python scripts/embed_web.py
+The header is only rewritten if its content changes.
+"""
+
+import gzip
+import hashlib
+import os
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+
+def url_for(name):
+    base, ext = os.path.splitext(name)
+    if name == "index.html":
+        return "/"
+    if ext == ".html":
+        return "/" + base
+    return "/" + name
+
+
+def symbol_for(name):
+    return "WEB_" + "".join(c.upper() if c.isalnum() else "_" for c in name) + "_GZ"
+
+
+def generate(project_dir):
+    web_dir = os.path.join(project_dir, "web")
+    out_path = os.path.join(project_dir, "src", "web_assets.h")
+
+    lines = [
+        "/**",
+        " * @file web_assets.h",
+        " * @brief Gzipped web UI, generated by scripts/embed_web.py from web/ - do not edit",
+        " */",
+        "",
+        "#pragma once",
+        "#include <Arduino.h>",
+        "",
+        "/**",
+        " * @struct WebAsset",
+        " * @brief One embedded file",
+        " */",
+        "struct WebAsset {",
+        "    const char* url;            ///< Request path",
+        "    const char* contentType;    ///< MIME type of the uncompressed file",
+        "    const char* etag;           ///< Quoted hash of the compressed data",
+        "    const uint8_t* data;        ///< Gzipped content (flash)",
+        "    size_t length;              ///< Bytes in data",
+        "};",
+        "",
+    ]
+
+    entries = []
+    for name in sorted(os.listdir(web_dir)):
+        path = os.path.join(web_dir, name)
+        ext = os.path.splitext(name)[1]
+        if not os.path.isfile(path) or ext not in CONTENT_TYPES:
+            continue
+
+        with open(path, "rb") as f:
+            raw = f.read()
+        # mtime=0 keeps the output (and the ETag) reproducible
+        data = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = '"' + hashlib.sha256(data).hexdigest()[:16] + '"'
+        symbol = symbol_for(name)
+
+        lines.append("// %s: %d bytes, %d gzipped" % (name, len(raw), len(data)))
+        lines.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+        for i in range(0, len(data), 16):
+            lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        entries.append('    { "%s", "%s", "%s", %s, sizeof(%s) },'
+                       % (url_for(name), CONTENT_TYPES[ext], etag.replace('"', '\\"'), symbol, symbol))
+
+    lines.append("static const WebAsset WEB_ASSETS[] = {")
+    lines.extend(entries)
+    lines.append("};")
+    lines.append("")
+    lines.append("#define WEB_ASSET_COUNT (sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]))")
+    lines.append("")
+
+    content = "\n".join(lines)
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path, "r") as f:
+            old = f.read()
+    if content != old:
+        with open(out_path, "w") as f:
+            f.write(content)
+        print("embed_web: generated %s (%d files)" % (out_path, len(entries)))
+
+
+try:
+    Import("env")  # noqa: F821 (PlatformIO)
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,205 @@
+#define LOG_MODULE LOG_MOD_POWER
+
+#include "analog_input.h"
+#include "pins.h"
+#include "web_log.h"
+#include "task_manager.h"
+#include "snapshot.h"
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <string.h>
+
+#define ANALOG_RAW_MAX 4095
+
+// Used by esp_adc_cal only on chips without eFuse calibration
+#define ANALOG_DEFAULT_VREF_MV 1100
+
+// Calibrated points used for the interpolation (counts apart)
+#define ANALOG_CAL_STEP 16
+
+// Bytes per conversion result in the DMA buffer
+#define ANALOG_RESULT_BYTES ((uint32_t)sizeof(adc_digi_output_data_t))
+
+// Results per DMA interrupt, and driver buffer for 4 update intervals
+#define ANALOG_FRAME_BYTES (64 * ANALOG_RESULT_BYTES)
+#define ANALOG_DMA_BUFFER_BYTES (ANALOG_SAMPLE_RATE_HZ * ANALOG_UPDATE_INTERVAL_MS / 1000 * 4 * ANALOG_RESULT_BYTES)
+
+/**
+ * @struct AnalogInput
+ * @brief Pin and filter of one channel
+ */
+struct AnalogInput {
+    const uint8_t* pin;
+    float filter;       ///< IIR coefficient per run (1 = unfiltered)
+};
+
+static const AnalogInput INPUTS[ANALOG_CHANNEL_COUNT] = {
+    { &PIN_VIN_12V_SENSE, 0.3f },   // ~140 ms, the power budget filters again
+    { &PIN_POT_LIGHT,     0.5f },   // ~70 ms, follows the knob without lag
+    { &PIN_NTC_LENS1,     0.1f },   // ~500 ms, read every LENS_PROBE_INTERVAL_MS
+    { &PIN_NTC_LENS2,     0.1f },
+};
+
+/**
+ * @struct AnalogStatus
+ * @brief Filtered values of all channels
+ */
+struct AnalogStatus {
+    float raw[ANALOG_CHANNEL_COUNT];    ///< Counts
+    float mv[ANALOG_CHANNEL_COUNT];     ///< Calibrated mV
+};
+
+static AnalogStatus status;                     // sensor task only
+static Snapshot<AnalogStatus> published;        // read by all tasks
+static bool filterStarted[ANALOG_CHANNEL_COUNT];
+
+static esp_adc_cal_characteristics_t calibration;
+static int8_t inputOf[SOC_ADC_MAX_CHANNEL_NUM];    // ADC1 channel -> AnalogChannel, -1 = unused
+static bool continuous = false;
+
+// ---------------- Conversion ----------------
+
+/**
+ * @brief Calibrated mV of an oversampled raw value.
+ *
+ * esp_adc_cal works on whole counts and returns whole mV, so the value is
+ * interpolated between two calibrated points ANALOG_CAL_STEP apart.
+ */
+static float toMillivolts(float raw)
+{
+    uint32_t lo = (uint32_t)raw / ANALOG_CAL_STEP * ANALOG_CAL_STEP;
+    if (lo > ANALOG_RAW_MAX - ANALOG_CAL_STEP) lo = ANALOG_RAW_MAX - ANALOG_CAL_STEP;
+    float a = esp_adc_cal_raw_to_voltage(lo, &calibration);
+    float b = esp_adc_cal_raw_to_voltage(lo + ANALOG_CAL_STEP, &calibration);
+    return a + (b - a) * (raw - lo) / ANALOG_CAL_STEP;
+}
+
+// ---------------- Sampling ----------------
+
+/**
+ * @brief Sums up all results waiting in the DMA buffer, never waits.
+ */
+static void drainDma(uint32_t sum[], uint16_t count[])
+{
+    static uint8_t buf[ANALOG_FRAME_BYTES];
+
+    // Bounded: at most the driver buffer plus what arrives meanwhile
+    for (uint8_t reads = 0; reads < ANALOG_DMA_BUFFER_BYTES / ANALOG_FRAME_BYTES + 2; reads++) {
+        uint32_t len = 0;
+        esp_err_t err = adc_digi_read_bytes(buf, sizeof(buf), &len, 0);
+        // ESP_ERR_INVALID_STATE: the buffer overflowed before, the data is valid
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) break;
+
+        for (uint32_t i = 0; i + ANALOG_RESULT_BYTES <= len; i += ANALOG_RESULT_BYTES) {
+            const adc_digi_output_data_t* r = reinterpret_cast<const adc_digi_output_data_t*>(&buf[i]);
+            if (r->type2.unit != 0 || r->type2.channel >= SOC_ADC_MAX_CHANNEL_NUM) continue;
+            int8_t ch = inputOf[r->type2.channel];
+            if (ch < 0) continue;
+            sum[ch] += r->type2.data;
+            count[ch]++;
+        }
+        if (len < sizeof(buf)) break;
+    }
+}
+
+/**
+ * @brief Single conversions, only if the continuous mode is not running.
+ */
+static void readSingle(uint32_t sum[], uint16_t count[])
+{
+    for (uint8_t ch = 0; ch < ANALOG_CHANNEL_COUNT; ch++) {
+        for (uint8_t i = 0; i < ANALOG_FALLBACK_SAMPLES; i++) {
+            sum[ch] += analogRead(*INPUTS[ch].pin);
+            count[ch]++;
+        }
+    }
+}
+
+// ---------------- Init ----------------
+void analog_init()
+{
+    adc_digi_pattern_config_t pattern[ANALOG_CHANNEL_COUNT];
+    uint32_t mask = 0;
+    uint8_t patterns = 0;
+
+    memset(inputOf, -1, sizeof(inputOf));
+    for (uint8_t ch = 0; ch < ANALOG_CHANNEL_COUNT; ch++) {
+        int8_t adc = digitalPinToAnalogChannel(*INPUTS[ch].pin);
+        if (adc < 0 || adc >= SOC_ADC_MAX_CHANNEL_NUM) {
+            LOG_WARN("ADC: GPIO%u is not on ADC1, not sampled", *INPUTS[ch].pin);
+            continue;
+        }
+        inputOf[adc] = ch;
+        mask |= 1UL << adc;
+        pattern[patterns].atten = ADC_ATTEN_DB_11;
+        pattern[patterns].channel = adc;
+        pattern[patterns].unit = 0;
+        pattern[patterns].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patterns++;
+    }
+
+    esp_adc_cal_value_t source = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                                          ANALOG_DEFAULT_VREF_MV, &calibration);
+    if (source == ESP_ADC_CAL_VAL_DEFAULT_VREF) LOG_WARN("ADC: no eFuse calibration, using nominal reference");
+    else LOG("ADC: eFuse calibration loaded");
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = ANALOG_DMA_BUFFER_BYTES;
+    init.conv_num_each_intr = ANALOG_FRAME_BYTES;
+    init.adc1_chan_mask = mask;
+    init.adc2_chan_mask = 0;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.pattern_num = patterns;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ANALOG_SAMPLE_RATE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    continuous = patterns > 0 &&
+                 adc_digi_initialize(&init) == ESP_OK &&
+                 adc_digi_controller_configure(&config) == ESP_OK &&
+                 adc_digi_start() == ESP_OK;
+    if (continuous) {
+        LOGF("ADC: %u channels continuous at %d Hz", patterns, ANALOG_SAMPLE_RATE_HZ);
+    } else {
+        adc_digi_deinitialize();
+        LOG_WARN("ADC: continuous mode not available, using single conversions");
+    }
+
+    task_register(TASK_SENSOR, "adc", analog_update, ANALOG_UPDATE_INTERVAL_MS);
+}
+
+// ---------------- Update ----------------
+void analog_update()
+{
+    uint32_t sum[ANALOG_CHANNEL_COUNT] = {};
+    uint16_t count[ANALOG_CHANNEL_COUNT] = {};
+
+    if (continuous) drainDma(sum, count);
+    else readSingle(sum, count);
+
+    bool changed = false;
+    for (uint8_t ch = 0; ch < ANALOG_CHANNEL_COUNT; ch++) {
+        if (count[ch] == 0) continue;
+
+        float mean = (float)sum[ch] / count[ch];
+        if (filterStarted[ch]) status.raw[ch] += INPUTS[ch].filter * (mean - status.raw[ch]);
+        else status.raw[ch] = mean;
+        filterStarted[ch] = true;
+        status.mv[ch] = toMillivolts(status.raw[ch]);
+        changed = true;
+    }
+    if (changed) published.publish(status);
+}
+
+float analog_getRaw(AnalogChannel ch)
+{
+    return ch < ANALOG_CHANNEL_COUNT ? published.read().raw[ch] : 0.0f;
+}
+
+float analog_getMillivolts(AnalogChannel ch)
+{
+    return ch < ANALOG_CHANNEL_COUNT ? published.read().mv[ch] : 0.0f;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file analog_input.h
+ * @brief Shared sampling of all analog inputs (supply sense, poti, NTC probes)
+ *
+ * ADC1 runs in continuous (DMA) mode over all channels in ANALOG_PINS at
+ * ANALOG_SAMPLE_RATE_HZ. A job of the sensor task drains the DMA buffer
+ * every ANALOG_UPDATE_INTERVAL_MS without waiting, averages the samples
+ * of each channel (oversampling), converts the mean with the eFuse
+ * calibration of the chip (esp_adc_cal, interpolated between two counts)
+ * and smooths it with a first-order IIR filter per channel.
+ *
+ * The results are published as a snapshot: readers in any task get the
+ * cached value and never start a conversion themselves. analogRead() must
+ * not be used on ADC1 pins while the continuous mode is running.
+ *
+ * If the continuous mode cannot be started, the job falls back to
+ * ANALOG_FALLBACK_SAMPLES single conversions per channel.
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Interval between two drains of the DMA buffer (ms)
+ */
+#define ANALOG_UPDATE_INTERVAL_MS 50
+
+/**
+ * @brief Conversions per second over all channels
+ */
+#define ANALOG_SAMPLE_RATE_HZ 4000
+
+/**
+ * @brief Single conversions per channel and run without continuous mode
+ */
+#define ANALOG_FALLBACK_SAMPLES 8
+
+/**
+ * @enum AnalogChannel
+ * @brief Sampled inputs
+ */
+enum AnalogChannel : uint8_t {
+    ANALOG_SUPPLY = 0,      ///< 12 V sense divider
+    ANALOG_POTI,            ///< Panel brightness potentiometer
+    ANALOG_NTC1,            ///< Lens probe of heater 1
+    ANALOG_NTC2,            ///< Lens probe of heater 2
+    ANALOG_CHANNEL_COUNT
+};
+
+/**
+ * @brief Starts the continuous conversion and registers the sampling job.
+ *
+ * Must be called after initPins() and before task_start().
+ */
+void analog_init();
+
+/**
+ * @brief Job of the sensor task: drains the DMA buffer and publishes new values.
+ */
+void analog_update();
+
+/**
+ * @brief Filtered raw value of a channel (any task).
+ *
+ * @return 0..4095 with the fractional part from oversampling, 0 before the first run
+ */
+float analog_getRaw(AnalogChannel ch);
+
+/**
+ * @brief Filtered, calibrated voltage at the pin (any task).
+ *
+ * @return mV, 0 before the first run
+ */
+float analog_getMillivolts(AnalogChannel ch);
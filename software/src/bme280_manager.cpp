@@ -1,47 +1,60 @@
+#define LOG_MODULE LOG_MOD_BME
+
 #include "bme280_manager.h"
 #include "web_log.h"
 #include <Wire.h>
 #include <Adafruit_BME280.h>
 #include "pins.h"
+#include "task_manager.h"
+#include "snapshot.h"
+#include "metrics.h"
 
 #define BME_ADDR 0x76
 
 static Adafruit_BME280 bme;
-static BmeStatus status;
-static unsigned long lastRead = 0;
+static BmeStatus status;                // working copy, sensor task only
+static Snapshot<BmeStatus> published;   // read by other tasks
+
+// I2C read of all three values, in microseconds
+static const uint32_t READ_BOUNDS_US[] = { 500, 1000, 2000, 5000, 10000, 20000, 50000 };
+static MetricHistogram readTime;
 
 void bme_init() {
     Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
     scanI2C();
     
     if (!bme.begin(BME_ADDR)) {
-        LOG("BME280 not found");
+        LOG_WARN("BME280 not found");
         status.present = false;
+        published.publish(status);
         return;
     }
 
     status.present = true;
+    published.publish(status);
+    metrics_register("cover_bme_read_duration_us", "BME280 read duration", nullptr, readTime, READ_BOUNDS_US);
+    task_register(TASK_SENSOR, "bme", bme_loop, BME_READ_INTERVAL_MS);
     LOG("BME280 initialized");
 }
 
 void bme_loop() {
     if (!status.present) return;
 
-    if (millis() - lastRead < 2000) return; // 2s Intervall
-    lastRead = millis();
-
+    uint32_t start = micros();
     status.temperature = bme.readTemperature();
     status.humidity    = bme.readHumidity();
     status.pressure    = bme.readPressure() / 100.0f;
+    metric_observe(readTime, micros() - start);
+    published.publish(status);
 
-    LOGF("BME280 T=%.1fC H=%.1f%% P=%.1fhPa",
+    LOG_DEBUG("BME280 T=%.1fC H=%.1f%% P=%.1fhPa",
          status.temperature,
          status.humidity,
          status.pressure);
 }
 
 BmeStatus bme_getStatus() {
-    return status; // Kopie
+    return published.read(); // konsistente Kopie, aus jedem Task
 }
 
 #include <Wire.h>
@@ -50,7 +63,7 @@ void scanI2C() {
     for (uint8_t addr = 1; addr < 127; addr++) {
         Wire.beginTransmission(addr);
         if (Wire.endTransmission() == 0) {
-            LOG("I2C device at 0x" + String(addr, HEX));
+            LOG_DEBUG("I2C device at 0x%02X", addr);
         }
     }
 }
@@ -8,6 +8,11 @@ struct BmeStatus {
     float pressure;      // hPa
 };
 
+/**
+ * @brief Interval between two sensor reads (ms)
+ */
+#define BME_READ_INTERVAL_MS 2000
+
 void bme_init();
 void bme_loop();
 BmeStatus bme_getStatus();
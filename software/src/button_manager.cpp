@@ -1,6 +1,8 @@
 #include "button_manager.h"
 #include "pins.h"
 #include "usb_manager.h"
+#include "task_manager.h"
+#include "analog_input.h"
 
 /**
  * @brief Array of GPIO pins for each button.
@@ -17,8 +19,15 @@ static const uint8_t buttonPins[BUTTON_COUNT] = {
  */
 static const uint32_t DEBOUNCE_MS = 40;
 
-static uint32_t lastPoticheck = 0;
-#define POTI_CHECK_INTERVAL_MS 500
+/**
+ * @brief Scheduler job running updateButtons()
+ */
+static TaskJobId buttonJob = TASK_JOB_INVALID;
+
+/**
+ * @brief Callback for detected button events
+ */
+static ButtonEventHandler eventHandler = nullptr;
 
 /**
  * @struct ButtonState
@@ -37,11 +46,20 @@ struct ButtonState {
  */
 static ButtonState btn[BUTTON_COUNT];
 
+/**
+ * @brief Edge interrupt of all buttons: wakes the UI task.
+ */
+static void IRAM_ATTR buttonIsr() {
+    task_triggerFromISR(buttonJob);
+}
+
 /**
  * @brief Initializes all button inputs and debouncing logic.
  *
  * Sets up the button pins as inputs with pull-up resistors and initializes their states.
  * Also initializes the potentiometer input pin.
+ * Buttons are not polled: an edge interrupt triggers updateButtons(),
+ * which re-schedules itself until the debounce time has passed.
  */
 void initButtons() {
     for (int i = 0; i < BUTTON_COUNT; i++) {
@@ -54,8 +72,19 @@ void initButtons() {
         btn[i].event = BUTTON_NONE;
     }
 
-    // Initialize potentiometer pin
-    pinMode(PIN_POT_LIGHT, INPUT);
+    buttonJob = task_register(TASK_UI, "buttons", updateButtons, 0);
+    task_register(TASK_UI, "poti", updatePoti, POTI_UPDATE_INTERVAL_MS);
+
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        attachInterrupt(digitalPinToInterrupt(buttonPins[i]), buttonIsr, CHANGE);
+    }
+}
+
+/**
+ * @brief Sets the callback invoked after updateButtons() detected an event.
+ */
+void setButtonEventHandler(ButtonEventHandler handler) {
+    eventHandler = handler;
 }
 
 /**
@@ -63,13 +92,16 @@ void initButtons() {
  *
  * Reads the raw state of each button, applies debouncing logic,
  * and updates the event type for each button.
- * Should be called regularly in the main loop.
+ * While a button is bouncing the job is re-run after DEBOUNCE_MS.
  */
 void updateButtons() {
     uint32_t now = millis();
+    bool settling = false;
+    bool anyEvent = false;
 
     for (int i = 0; i < BUTTON_COUNT; i++) {
         bool raw = digitalRead(buttonPins[i]);
+        btn[i].event = BUTTON_NONE;
 
         if (raw != btn[i].rawState) {
             btn[i].rawState = raw;
@@ -91,11 +123,20 @@ void updateButtons() {
                 }
 
                 btn[i].lastReportedState = raw;
-            } else {
-                btn[i].event = BUTTON_NONE;
+                anyEvent = true;
             }
+        } else {
+            settling = true;
         }
     }
+
+    if (settling) {
+        task_runIn(buttonJob, DEBOUNCE_MS);
+    }
+
+    if (anyEvent && eventHandler != nullptr) {
+        eventHandler();
+    }
 }
 
 /**
@@ -146,15 +187,15 @@ static uint8_t lastSentBrightness = 255; // impossible value → forces first up
 /**
  * @brief Updates the potentiometer value.
  *
- * Reads the analog value from the potentiometer pin, applies a noise filter,
+ * Takes the filtered value sampled by analog_input, ignores small changes
  * and scales the value to a range of 0–255 for brightness control.
  * Should be called regularly to keep the brightness value updated.
  */
 void updatePoti() {
-    int raw = analogRead(PIN_POT_LIGHT);  // 0..4095
+    int raw = lroundf(analog_getRaw(ANALOG_POTI));  // 0..4095, oversampled and filtered
 
-    // Noise filter: only update if change > 8 ADC counts
-    if (abs(raw - lastRaw) < 8) {
+    // Hysteresis against toggling between two brightness steps
+    if (abs(raw - lastRaw) < 4) {
         return;
     }
 
@@ -179,11 +220,5 @@ uint8_t getPotiBrightness() {
  * @return void
  */
 void handlePotiBrightness() {
-    uint32_t now = millis();
-    if( now - lastPoticheck < POTI_CHECK_INTERVAL_MS ) {
-        return;
-    }
-    lastPoticheck = now;
     usb_manager_set_brightness(getPotiBrightness());
-    
 }
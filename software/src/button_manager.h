@@ -24,17 +24,41 @@ enum ButtonEvent {
     BUTTON_CLICK      ///< Button was clicked (short press)
 };
 
+/**
+ * @brief Interval for reading the potentiometer (ms)
+ */
+#define POTI_UPDATE_INTERVAL_MS 100
+
+/**
+ * @brief Interval for forwarding the poti brightness to the panel (ms)
+ */
+#define POTI_CHECK_INTERVAL_MS 500
+
+/**
+ * @brief Callback invoked after a button event was detected
+ */
+typedef void (*ButtonEventHandler)();
+
 /**
  * @brief Initializes all button inputs and debouncing logic.
+ * Attaches the edge interrupts and registers the button and poti jobs
+ * with the UI task.
  */
 void initButtons();
 
 /**
  * @brief Updates the button states and processes debouncing.
- * Should be called regularly in the main loop.
+ * Runs as a UI task job, triggered by the button edge interrupts.
  */
 void updateButtons();
 
+/**
+ * @brief Sets the callback invoked after updateButtons() detected an event.
+ * Events are valid until the next call of updateButtons().
+ * @param handler Callback (nullptr to disable)
+ */
+void setButtonEventHandler(ButtonEventHandler handler);
+
 /**
  * @brief Checks if the specified button was pressed.
  * @param id Logical button identifier.
@@ -67,7 +91,7 @@ bool buttonIsDown(ButtonId id);
 
 /**
  * @brief Updates the potentiometer value.
- * Should be called regularly to read the current brightness setting.
+ * Runs as a UI task job every POTI_UPDATE_INTERVAL_MS.
  */
 void updatePoti();
 
@@ -79,6 +103,7 @@ uint8_t getPotiBrightness();
 
 /**
  * @brief Updates the panel brightness, if panel was switched on
+ * Intended as a job with period POTI_CHECK_INTERVAL_MS.
  * @return void
  */
 void handlePotiBrightness();
\ No newline at end of file
@@ -1,6 +1,6 @@
 /**
  * @file config_manager.cpp
- * @brief Implementation of the configuration parser
+ * @brief Configuration store (NVS) and config.txt import/export
  *
  * Supported entries in config.txt:
  * - wifi=SSID;PASS
@@ -11,133 +11,357 @@
  * - autoclose_time=HH:MM
  * - dew1_level=0..100 Percent PWM level for dew heater 1
  * - dew2_level=0..100 Percent PWM level for dew heater 2
+ * - dew_mode=ramp|mpc Dew heater control (fixed ramp or model-predictive)
+ * - lens1_probe=none|ds18b20|ntc Lens temperature probe of heater 1 (PID control)
+ * - lens2_probe=none|ds18b20|ntc Lens temperature probe of heater 2
+ * - dew_target_offset=1..10 °C the lens is kept above the dew point (with probe)
+ * - dew_slew_rate=0..100 Maximum change of the heater PWM in %/s (0 = no limit)
+ * - panel_slew_rate=0..100 Same for the flat panel (soft start)
+ * - dew1_watts / dew2_watts / panel_watts=0..255 Rated power of the outputs at 12 V
+ * - power_budget=0..255 Maximum total power of the outputs in W (0 = no limit)
+ * - low_voltage=0..25.5 V below which panel, heater 2, heater 1 are shed (0 = off)
+ * - critical_voltage=0..25.5 V below which all outputs are switched off (0 = off)
+ *
+ * Keys are case-insensitive, the schema is CONFIG_KEYS in config_parser.cpp.
+ * Unknown keys, invalid values and duplicates are logged with their line.
  */
 
+#define LOG_MODULE LOG_MOD_CONFIG
+
 #include "config_manager.h"
+#include "config_parser.h"
 #include "sdcard.h"
 #include "web_log.h"
+#include "crc32.h"
+#include "snapshot.h"
+#include <Preferences.h>
+#include <stddef.h>
+#include <atomic>
+
+#define CONFIG_NVS_NAMESPACE "config"
+#define CONFIG_NVS_KEY       "data"
+#define CONFIG_MAGIC         0x47464343UL    // "CCFG"
+
+/**
+ * @struct ConfigBlob
+ * @brief NVS representation: header, data, import stamp and CRC over all before it
+ */
+struct ConfigBlob {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;          ///< sizeof(ConfigData) when written
+    ConfigData data;
+    uint32_t srcSize;       ///< config.txt the data was imported from (0 = none)
+    uint32_t srcTime;
+    uint32_t crc;
+};
+
+/**
+ * @struct ConfigSubscription
+ * @brief Listener of one key
+ */
+struct ConfigSubscription {
+    uint8_t key;                ///< Index in CONFIG_KEYS
+    ConfigListener listener;
+};
+
+static ConfigData defaults();
 
 // --------------------
-// Global configuration values
+// Current configuration
 // --------------------
 
-WifiEntry wifiList[10];
-int wifiCount = 0;
+static ConfigData current = defaults();         // writer only
+static Snapshot<ConfigData> published(current); // read by all tasks
+
+static ConfigSubscription subscriptions[CONFIG_MAX_LISTENERS];
+static std::atomic<uint8_t> subscriptionCount(0);
+
+// Stamp of the config.txt the stored data came from
+static uint32_t importedSize = 0;
+static uint32_t importedTime = 0;
+
+static ConfigData defaults() {
+    ConfigData c;
+    config_setDefaults(c);
+    return c;
+}
+
+void config_setDefaults(ConfigData &c) {
+    memset(&c, 0, sizeof(c));
+    strlcpy(c.otaPassword, "update123", sizeof(c.otaPassword));
+    c.ledBrightnessNormal = 80;
+    c.ledBrightnessDark   = 20;
+    c.autoCloseCover  = false; // autoclose disabled by default
+    c.autoCloseHour   = 5;     // autoclose default time 05:00
+    c.autoCloseMinute = 0;
+    c.dew1Level = 70;          // default PWM to 70%
+    c.dew2Level = 70;
+    c.dewMode = 0;             // ramp
+    c.lens1Probe = 0;          // no lens probes
+    c.lens2Probe = 0;
+    c.dewTargetOffset = 3;
+    c.dewSlewRate = 20;        // 0 -> 100 % in 5 s
+    c.panelSlewRate = 50;      // soft start in 2 s
+    c.dew1Watts = 12;          // 12 V / 1 A heater strips
+    c.dew2Watts = 12;
+    c.panelWatts = 6;
+    c.powerBudget = 0;         // no budget
+    c.lowVoltage = 115;        // 11.5 V
+    c.criticalVoltage = 105;   // 10.5 V
+}
+
+/**
+ * @brief Compares the value of one key in two configurations.
+ */
+static bool keyDiffers(const ConfigKey &k, const ConfigData &a, const ConfigData &b) {
+    const uint8_t* va = reinterpret_cast<const uint8_t*>(&a) + k.offset;
+    const uint8_t* vb = reinterpret_cast<const uint8_t*>(&b) + k.offset;
+
+    switch (k.type) {
+    case CKEY_STRING:
+        return strncmp(reinterpret_cast<const char*>(va), reinterpret_cast<const char*>(vb), k.size) != 0;
+    case CKEY_TIME:
+        return memcmp(va, vb, 2) != 0;      // hour and minute
+    case CKEY_WIFI:
+        if (a.wifiCount != b.wifiCount) return true;
+        for (uint8_t i = 0; i < a.wifiCount; i++) {
+            if (strcmp(a.wifi[i].ssid, b.wifi[i].ssid) != 0 ||
+                strcmp(a.wifi[i].password, b.wifi[i].password) != 0) return true;
+        }
+        return false;
+    default:
+        return memcmp(va, vb, k.size) != 0;
+    }
+}
+
+/**
+ * @brief Publishes next and notifies the subscribers of the changed keys.
+ */
+static void commit(const ConfigData &next) {
+    uint32_t changed = 0;
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (keyDiffers(CONFIG_KEYS[i], current, next)) {
+            changed |= 1UL << i;
+            LOG_DEBUG("Config: %s changed", CONFIG_KEYS[i].name);
+        }
+    }
+
+    current = next;
+    published.publish(current);
 
-String otaPassword = "update123";
+    uint8_t count = subscriptionCount.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < count; i++) {
+        if (changed & (1UL << subscriptions[i].key)) subscriptions[i].listener(current);
+    }
+}
 
-uint8_t ledBrightnessNormal = 80;
-uint8_t ledBrightnessDark   = 20;
+ConfigData config_get() {
+    return published.read();
+}
 
-bool autoCloseCover = false; // autoclose disabled by default
-int autoCloseHour = 5; // autoclose default time 05:00
-int autoCloseMinute = 0;
+bool config_subscribe(const char* key, ConfigListener listener) {
+    int k = cparser_findKey(key);
+    uint8_t count = subscriptionCount.load(std::memory_order_relaxed);
+    if (k < 0 || count >= CONFIG_MAX_LISTENERS) {
+        LOG_ERROR("Cannot subscribe to config key %s", key);
+        return false;
+    }
 
-int dew1Level = 70; // default PWM to 70%
-int dew2Level = 70;
+    subscriptions[count] = { (uint8_t)k, listener };
+    subscriptionCount.store(count + 1, std::memory_order_release);
+    listener(config_get());
+    return true;
+}
 
+// --------------------
+// NVS
 // --------------------
 
-bool loadConfigFromSD() {
-    File file = openConfigFile();
-    if (!file) {
-        LOG("No config.txt found");
+/**
+ * @brief Reads and validates the blob.
+ * @param out Stored configuration
+ * @return false if missing, of another version or corrupt
+ */
+static bool loadFromNvs(ConfigData &out) {
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NVS_NAMESPACE, true)) return false;
+
+    ConfigBlob blob;
+    size_t len = prefs.getBytes(CONFIG_NVS_KEY, &blob, sizeof(blob));
+    prefs.end();
+
+    if (len != sizeof(blob)) return false;
+    if (blob.magic != CONFIG_MAGIC || blob.version != CONFIG_VERSION || blob.size != sizeof(ConfigData)) {
+        LOG_WARN("Stored config has another layout, ignored");
+        return false;
+    }
+    if (blob.crc != crc32(&blob, offsetof(ConfigBlob, crc))) {
+        LOG_ERROR("Stored config is corrupt (CRC)");
         return false;
     }
 
-    wifiCount = 0;
+    out = blob.data;
+    importedSize = blob.srcSize;
+    importedTime = blob.srcTime;
+    return true;
+}
 
-    while (file.available()) {
-        String line = file.readStringUntil('\n');
-        line.trim();
+static bool saveToNvs() {
+    ConfigBlob blob;
+    memset(&blob, 0, sizeof(blob));     // padding is part of the CRC
+    blob.magic = CONFIG_MAGIC;
+    blob.version = CONFIG_VERSION;
+    blob.size = sizeof(ConfigData);
+    blob.data = current;
+    blob.srcSize = importedSize;
+    blob.srcTime = importedTime;
+    blob.crc = crc32(&blob, offsetof(ConfigBlob, crc));
 
-        // Ignore comments and empty lines
-        if (line.length() == 0 || line.startsWith("#")) {
-            continue;
-        }
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NVS_NAMESPACE, false)) {
+        LOG_ERROR("Cannot open NVS for config");
+        return false;
+    }
+    bool ok = prefs.putBytes(CONFIG_NVS_KEY, &blob, sizeof(blob)) == sizeof(blob);
+    prefs.end();
 
-        // WiFi
-        if (line.startsWith("wifi=")) {
-            if (wifiCount >= 10) continue;
+    if (!ok) LOG_ERROR("Config could not be stored in NVS");
+    return ok;
+}
 
-            line.remove(0, 5);
-            int sep = line.indexOf(';');
-            if (sep < 0) continue;
+// --------------------
+// config.txt
+// --------------------
 
-            wifiList[wifiCount].ssid = line.substring(0, sep);
-            wifiList[wifiCount].password = line.substring(sep + 1);
-            wifiList[wifiCount].ssid.trim();
-            wifiList[wifiCount].password.trim();
+/**
+ * @brief Parses config.txt into c (starting from the defaults) and logs every problem.
+ */
+static void parseConfigFile(File &file, ConfigData &c) {
+    static ConfigParser parser;     // ~400 bytes, kept off the task stack
+    uint8_t chunk[64];
 
-            wifiCount++;
-            continue;
-        }
+    cparser_begin(parser, c);
+    size_t n;
+    while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+        cparser_feed(parser, reinterpret_cast<const char*>(chunk), n);
+    }
+    cparser_end(parser);
 
-        // OTA password
-        if (line.startsWith("ota_password=")) {
-            otaPassword = line.substring(strlen("ota_password="));
-            otaPassword.trim();
-            continue;
-        }
+    for (uint8_t i = 0; i < parser.diagCount; i++) {
+        const ConfigDiag &d = parser.diags[i];
+        LOG_WARN("config.txt:%u: %s%s%s", d.line, cparser_diagText(d.code),
+                 d.key[0] ? " - " : "", d.key);
+    }
+    if (parser.problems > parser.diagCount) {
+        LOG_WARN("config.txt: %u more problems", parser.problems - parser.diagCount);
+    }
+}
 
-        // LED normal brightness
-        if (line.startsWith("led_brightness=")) {
-            ledBrightnessNormal = constrain(
-                line.substring(strlen("led_brightness=")).toInt(), 0, 255);
-            continue;
-        }
+/**
+ * @brief Takes over size and time of config.txt, it matches the stored data.
+ */
+static bool stampConfigFile() {
+    File f = SD.open(CONFIG_FILE_PATH, FILE_READ);
+    if (!f) return false;
+    importedSize = f.size();
+    importedTime = (uint32_t)f.getLastWrite();
+    f.close();
+    return true;
+}
 
-        // LED dark mode brightness
-        if (line.startsWith("led_brightness_dark=")) {
-            ledBrightnessDark = constrain(
-                line.substring(strlen("led_brightness_dark=")).toInt(), 0, 255);
-            continue;
-        }
+bool loadConfigFromSD() {
+    File file = openConfigFile();
+    if (!file) {
+        LOG("No config.txt found");
+        return false;
+    }
 
-        // Enable/disable AutoClose
-        if (line.startsWith("autoclose_cover=")) {
-            String val = line.substring(strlen("autoclose_cover="));
-            val.trim();
-            autoCloseCover = (val == "1" || val.equalsIgnoreCase("true"));
-            continue;
-        }
+    static ConfigData parsed;       // writer only, kept off the task stack
+    parseConfigFile(file, parsed);
+    importedSize = file.size();
+    importedTime = (uint32_t)file.getLastWrite();
+    file.close();
 
-        // AutoClose time (HH:MM)
-        if (line.startsWith("autoclose_time=")) {
-            String val = line.substring(strlen("autoclose_time="));
-            val.trim();
+    commit(parsed);
+    saveToNvs();
+    LOG("Config imported from config.txt");
+    return true;
+}
 
-            int sep = val.indexOf(':');
-            if (sep > 0) {
-                autoCloseHour   = val.substring(0, sep).toInt();
-                autoCloseMinute = val.substring(sep + 1).toInt();
+bool config_exportToSD() {
+    ConfigWriter out;
+    if (!configWriteBegin(out)) return false;
 
-                // Safety: limit values
-                autoCloseHour   = constrain(autoCloseHour,   0, 23);
-                autoCloseMinute = constrain(autoCloseMinute, 0, 59);
+    char value[72];
+    out.file.print("# Exported from the stored configuration\n");
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const ConfigKey &k = CONFIG_KEYS[i];
+        if (k.type == CKEY_WIFI) {
+            for (uint8_t w = 0; w < current.wifiCount; w++) {
+                out.file.printf("%s=%s;%s\n", k.name, current.wifi[w].ssid, current.wifi[w].password);
             }
             continue;
         }
-        
-        // Dew Heater 1 Level (0-100%)
-        if (line.startsWith("dew1_level=")) {
-            dew1Level = constrain(
-                line.substring(strlen("dew1_level=")).toInt(), 0, 100
-            );
-            continue;
-        }
+        cparser_formatValue(k, current, value, sizeof(value));
+        out.file.printf("%s=%s\n", k.name, value);
+    }
+    if (!configWriteCommit(out)) return false;
 
-        // Dew Heater 2 Level (0-100%)
-        if (line.startsWith("dew2_level=")) {
-            dew2Level = constrain(
-                line.substring(strlen("dew2_level=")).toInt(), 0, 100
-            );
-            continue;
-        }
+    // The file now matches the stored data, no re-import on the next boot
+    if (stampConfigFile()) saveToNvs();
+    LOG("Config exported to config.txt");
+    return true;
+}
+
+bool config_importParsed(const ConfigData &parsed) {
+    stampConfigFile();
+    commit(parsed);
+    bool stored = saveToNvs();
+    LOG("Config imported from upload");
+    return stored;
+}
 
+bool config_update(const ConfigData &next) {
+    commit(next);
+    return saveToNvs();
+}
+
+// --------------------
+// Boot
+// --------------------
+
+bool config_begin(bool sdAvailable) {
+    static ConfigData stored;
+    uint32_t start = micros();
+    bool loaded = loadFromNvs(stored);
+    if (loaded) {
+        LOGF("Config loaded from NVS in %luus", (unsigned long)(micros() - start));
+        commit(stored);
+    }
+
+    if (!sdAvailable) {
+        if (!loaded) LOG_WARN("No stored config and no SD card, using defaults");
+        return loaded;
     }
+    recoverConfigFile();
 
+    // Checksum and stat only, config.txt is parsed only when it changed
+    File file = openConfigFile();
+    if (!file) {
+        // Missing or corrupt: rewrite it from NVS, or fall back to a previous version
+        if (loaded) {
+            config_exportToSD();
+            return true;
+        }
+        return restoreConfigGeneration() && loadConfigFromSD();
+    }
+    uint32_t size = file.size();
+    uint32_t time = (uint32_t)file.getLastWrite();
     file.close();
-    LOG("Config loaded");
+
+    if (!loaded || size != importedSize || time != importedTime) {
+        return loadConfigFromSD();
+    }
     return true;
 }
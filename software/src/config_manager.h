@@ -2,8 +2,22 @@
  * @file config_manager.h
  * @brief Central configuration management
  *
- * Reads all configuration values from config.txt (SD card)
- * and makes them available globally.
+ * The configuration is a typed, fixed-size struct (ConfigData). It is
+ * persisted in NVS as a binary blob with version and CRC, so it is
+ * available at boot without the SD card and without text parsing.
+ *
+ * config.txt on the SD card is the import/export format:
+ *  - it is imported when it changed since the last import (size or
+ *    modification time), and by /save_config and /reload_config
+ *  - it is written from the stored configuration if it is missing
+ *
+ * The current configuration is published as a whole (Snapshot): readers
+ * in any task get a consistent copy with config_get() and never see a
+ * half-applied import. Modules that must react to a change subscribe to
+ * single keys with config_subscribe().
+ *
+ * Writers (config_begin, loadConfigFromSD, config_importParsed, config_update)
+ * run in setup() and afterwards only in the web server task.
  *
  * Does NOT contain logic for WiFi, OTA, or LEDs.
  */
@@ -14,45 +28,131 @@
 #include <Arduino.h>
 
 /**
+ * @brief Maximum number of WiFi networks in config.txt
+ */
+#define WIFI_LIST_SIZE 10
+
+/**
+ * @brief Layout version of ConfigData, stored blobs of another version are ignored
+ */
+#define CONFIG_VERSION 5
+
+/**
+ * @struct WifiEntry
  * @brief WiFi credentials
  */
 struct WifiEntry {
-    String ssid;
-    String password;
+    char ssid[33];
+    char password[65];
 };
 
-extern WifiEntry wifiList[10];
-extern int wifiCount;
+/**
+ * @struct ConfigData
+ * @brief All settings, trivially copyable
+ */
+struct ConfigData {
+    WifiEntry wifi[WIFI_LIST_SIZE];
+    uint8_t wifiCount;
+
+    char otaPassword[33];           ///< OTA password (plain text from config.txt)
+
+    uint8_t ledBrightnessNormal;    ///< LED brightness for normal and dark mode
+    uint8_t ledBrightnessDark;
+
+    bool autoCloseCover;            ///< Auto Close Cover at a defined time
+    uint8_t autoCloseHour;          ///< 0–23
+    uint8_t autoCloseMinute;        ///< 0–59
+
+    uint8_t dew1Level;              ///< PWM default values for DEW1/2 (0–100 %)
+    uint8_t dew2Level;
+
+    uint8_t dewMode;                ///< DewMode: 0 = ramp, 1 = mpc
+    uint8_t lens1Probe;             ///< LensProbeType of heater 1/2: 0 = none, 1 = ds18b20, 2 = ntc
+    uint8_t lens2Probe;
+    uint8_t dewTargetOffset;        ///< Lens probe: target above the dew point (°C)
+
+    uint8_t dewSlewRate;            ///< Maximum change of the heater/panel PWM (%/s, 0 = no limit)
+    uint8_t panelSlewRate;
+
+    uint8_t dew1Watts;              ///< Rated power of the outputs at 12 V and 100 % (W)
+    uint8_t dew2Watts;
+    uint8_t panelWatts;
+    uint8_t powerBudget;            ///< Maximum total power of the outputs (W, 0 = no limit)
+    uint8_t lowVoltage;             ///< Supply voltage below which outputs are shed (0.1 V, 0 = off)
+    uint8_t criticalVoltage;        ///< Below this everything is switched off at once (0.1 V, 0 = off)
+};
 
 /**
- * @brief OTA password (plain text from config.txt)
+ * @brief Maximum number of config_subscribe() registrations
  */
-extern String otaPassword;
+#define CONFIG_MAX_LISTENERS 24
 
 /**
- * @brief LED brightness for normal and dark mode
+ * @brief Change notification, gets the new configuration.
+ *
+ * Runs in the task that changed the configuration (setup or web server):
+ * store the value or call task_trigger(), do not block.
  */
-extern uint8_t ledBrightnessNormal;
-extern uint8_t ledBrightnessDark;
+typedef void (*ConfigListener)(const ConfigData &c);
 
 /**
- * @brief Auto Close Cover at a defined time
+ * @brief Returns a consistent copy of the current configuration (any task).
  */
-extern bool autoCloseCover;     // true/false
-extern int autoCloseHour;       // 0–23
-extern int autoCloseMinute;     // 0–59
-    
+ConfigData config_get();
+
 /**
- * @brief PWM default values for DEW1/2
+ * @brief Calls listener now and whenever the value of key changes.
+ *
+ * @param key      Key as in config.txt (case-insensitive)
+ * @param listener Callback
+ * @return false if the key is unknown or the table is full
+ */
+bool config_subscribe(const char* key, ConfigListener listener);
+
+/**
+ * @brief Replaces the configuration, stores it in NVS and notifies the
+ *        subscribers of the changed keys. config.txt is not touched.
+ *
+ * @param next New configuration (e.g. config_get() with some keys changed)
+ * @return false if it could not be stored (it is applied anyway)
+ */
+bool config_update(const ConfigData &next);
+
+/**
+ * @brief Fills a configuration with the compiled defaults.
+ */
+void config_setDefaults(ConfigData &c);
+
+/**
+ * @brief Loads the configuration at boot.
+ *
+ * NVS first; config.txt is imported only if NVS is empty or invalid or
+ * the file changed, and exported if it is missing.
+ *
+ * @param sdAvailable SD card is mounted
+ * @return false if the compiled defaults are used
  */
-extern int dew1Level;
-extern int dew2Level;
+bool config_begin(bool sdAvailable);
 
 /**
- * @brief Loads config.txt from SD card
+ * @brief Imports config.txt from SD card and stores it in NVS
  * @return true if successful
  */
 bool loadConfigFromSD();
 
+/**
+ * @brief Applies a config.txt that was parsed while it was written
+ *        (upload) and stores it in NVS, without reading it back from SD.
+ *
+ * @param parsed Result of the parser, starting from the defaults
+ * @return false if it could not be stored (it is applied anyway)
+ */
+bool config_importParsed(const ConfigData &parsed);
+
+/**
+ * @brief Writes the current configuration to config.txt
+ * @return true if successful
+ */
+bool config_exportToSD();
 
 #endif
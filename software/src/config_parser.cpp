@@ -0,0 +1,405 @@
+/**
+ * @file config_parser.cpp
+ * @brief config.txt schema and parser implementation
+ */
+
+#include "config_parser.h"
+#include <string.h>
+#include <stdio.h>
+
+#define KEY(name, type, min, max, member) \
+    { name, type, min, max, offsetof(ConfigData, member), sizeof(ConfigData::member), nullptr }
+#define KEY_CHOICE(name, choices, member) \
+    { name, CKEY_CHOICE, 0, 0, offsetof(ConfigData, member), sizeof(ConfigData::member), choices }
+
+constexpr ConfigKey CONFIG_KEYS[] = {
+    KEY("wifi",                CKEY_WIFI,   0, 0,   wifi),
+    KEY("ota_password",        CKEY_STRING, 0, 0,   otaPassword),
+    KEY("led_brightness",      CKEY_UINT8,  0, 255, ledBrightnessNormal),
+    KEY("led_brightness_dark", CKEY_UINT8,  0, 255, ledBrightnessDark),
+    KEY("autoclose_cover",     CKEY_BOOL,   0, 0,   autoCloseCover),
+    KEY("autoclose_time",      CKEY_TIME,   0, 0,   autoCloseHour),
+    KEY("dew1_level",          CKEY_UINT8,  0, 100, dew1Level),
+    KEY("dew2_level",          CKEY_UINT8,  0, 100, dew2Level),
+    KEY_CHOICE("dew_mode",     "ramp|mpc",          dewMode),
+    KEY_CHOICE("lens1_probe",  "none|ds18b20|ntc",  lens1Probe),
+    KEY_CHOICE("lens2_probe",  "none|ds18b20|ntc",  lens2Probe),
+    KEY("dew_target_offset",   CKEY_UINT8,  1, 10,  dewTargetOffset),
+    KEY("dew_slew_rate",       CKEY_UINT8,  0, 100, dewSlewRate),
+    KEY("panel_slew_rate",     CKEY_UINT8,  0, 100, panelSlewRate),
+    KEY("dew1_watts",          CKEY_UINT8,  0, 255, dew1Watts),
+    KEY("dew2_watts",          CKEY_UINT8,  0, 255, dew2Watts),
+    KEY("panel_watts",         CKEY_UINT8,  0, 255, panelWatts),
+    KEY("power_budget",        CKEY_UINT8,  0, 255, powerBudget),
+    KEY("low_voltage",         CKEY_DECI,   0, 255, lowVoltage),
+    KEY("critical_voltage",    CKEY_DECI,   0, 255, criticalVoltage),
+};
+
+const uint8_t CONFIG_KEY_COUNT = sizeof(CONFIG_KEYS) / sizeof(CONFIG_KEYS[0]);
+
+// --- Compile-time checks of the schema ---
+
+constexpr bool isLowerKey(const char* s) {
+    for (; *s; s++) {
+        if (*s >= 'A' && *s <= 'Z') return false;
+    }
+    return true;
+}
+
+constexpr bool sameKey(const char* a, const char* b) {
+    for (; *a && *a == *b; a++, b++) {}
+    return *a == *b;
+}
+
+constexpr bool schemaValid() {
+    for (size_t i = 0; i < sizeof(CONFIG_KEYS) / sizeof(CONFIG_KEYS[0]); i++) {
+        const ConfigKey &k = CONFIG_KEYS[i];
+        if (!isLowerKey(k.name)) return false;
+        if (k.type == CKEY_BOOL && k.size != sizeof(bool)) return false;
+        if ((k.type == CKEY_UINT8 || k.type == CKEY_TIME || k.type == CKEY_CHOICE || k.type == CKEY_DECI) &&
+            k.size != sizeof(uint8_t)) return false;
+        if ((k.type == CKEY_UINT8 || k.type == CKEY_DECI) && k.min > k.max) return false;
+        if (k.type == CKEY_CHOICE && (k.choices == nullptr || !isLowerKey(k.choices))) return false;
+        for (size_t j = 0; j < i; j++) {
+            if (sameKey(k.name, CONFIG_KEYS[j].name)) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(schemaValid(), "CONFIG_KEYS: keys must be lower case and unique, types must match the members");
+static_assert(sizeof(CONFIG_KEYS) / sizeof(CONFIG_KEYS[0]) <= 32, "CONFIG_KEYS: duplicate mask has 32 bits");
+static_assert(offsetof(ConfigData, autoCloseMinute) == offsetof(ConfigData, autoCloseHour) + 1,
+              "CKEY_TIME expects minute right after hour");
+
+// --- Helpers ---
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief Case-insensitive compare of s[0..len) with a lower case key
+ */
+static bool keyEquals(const char* s, size_t len, const char* key) {
+    for (size_t i = 0; i < len; i++, key++) {
+        if (*key == '\0' || lower(s[i]) != *key) return false;
+    }
+    return *key == '\0';
+}
+
+/**
+ * @brief Case-insensitive compare of a null-terminated value with a lower case word
+ */
+static bool wordEquals(const char* s, const char* word) {
+    return keyEquals(s, strlen(s), word);
+}
+
+/**
+ * @brief Decimal number without sign, at most 5 digits
+ */
+static bool parseNumber(const char* s, uint32_t &value) {
+    uint8_t digits = 0;
+    value = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9' || ++digits > 5) return false;
+        value = value * 10 + (uint32_t)(*s - '0');
+    }
+    return digits > 0;
+}
+
+/**
+ * @brief Index in CONFIG_KEYS of s[0..len), -1 if unknown
+ */
+static int findKey(const char* s, size_t len) {
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (keyEquals(s, len, CONFIG_KEYS[i].name)) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Index of value in a '|' separated list of lower case names, -1 if not found
+ */
+static int findChoice(const char* choices, const char* value) {
+    size_t len = strlen(value);
+    for (int i = 0; *choices; i++) {
+        const char* end = strchr(choices, '|');
+        size_t n = end ? (size_t)(end - choices) : strlen(choices);
+        if (n == len) {
+            size_t j = 0;
+            while (j < n && lower(value[j]) == choices[j]) j++;
+            if (j == n) return i;
+        }
+        if (end == nullptr) break;
+        choices = end + 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Name with the given index in a '|' separated list, length in len
+ */
+static const char* choiceName(const char* choices, uint8_t index, int &len) {
+    for (; index > 0; index--) {
+        const char* end = strchr(choices, '|');
+        if (end == nullptr) break;
+        choices = end + 1;
+    }
+    const char* end = strchr(choices, '|');
+    len = end ? (int)(end - choices) : (int)strlen(choices);
+    return choices;
+}
+
+static void report(ConfigParser &p, ConfigDiagCode code, const char* key, size_t keyLen) {
+    p.problems++;
+    if (p.diagCount >= CPARSER_MAX_DIAGS) return;
+
+    ConfigDiag &d = p.diags[p.diagCount++];
+    d.line = p.lineNo;
+    d.code = code;
+    if (keyLen >= sizeof(d.key)) keyLen = sizeof(d.key) - 1;
+    memcpy(d.key, key, keyLen);
+    d.key[keyLen] = '\0';
+}
+
+static inline bool reject(ConfigDiagCode &problem, ConfigDiagCode code) {
+    problem = code;
+    return false;
+}
+
+/**
+ * @brief Converts and stores one value.
+ *
+ * @return false if the value was rejected, the reason is in problem
+ */
+static bool applyValue(ConfigData &c, const ConfigKey &k, char* value, ConfigDiagCode &problem) {
+    uint8_t* target = reinterpret_cast<uint8_t*>(&c) + k.offset;
+    uint32_t n;
+
+    switch (k.type) {
+    case CKEY_BOOL:
+        if (wordEquals(value, "1") || wordEquals(value, "true") || wordEquals(value, "yes") || wordEquals(value, "on")) {
+            *reinterpret_cast<bool*>(target) = true;
+        } else if (wordEquals(value, "0") || wordEquals(value, "false") || wordEquals(value, "no") || wordEquals(value, "off")) {
+            *reinterpret_cast<bool*>(target) = false;
+        } else {
+            return reject(problem, CDIAG_INVALID);
+        }
+        break;
+
+    case CKEY_UINT8:
+        if (!parseNumber(value, n)) return reject(problem, CDIAG_INVALID);
+        if (n < k.min || n > k.max) return reject(problem, CDIAG_RANGE);
+        *target = (uint8_t)n;
+        break;
+
+    case CKEY_STRING:
+        if (strlen(value) >= k.size) return reject(problem, CDIAG_RANGE);
+        strcpy(reinterpret_cast<char*>(target), value);
+        break;
+
+    case CKEY_DECI: {
+        // "11", "11.5" or "11,5"
+        char* sep = strpbrk(value, ".,");
+        uint32_t tenths = 0;
+        if (sep != nullptr) {
+            if (sep[1] < '0' || sep[1] > '9' || sep[2] != '\0') return reject(problem, CDIAG_INVALID);
+            tenths = (uint32_t)(sep[1] - '0');
+            *sep = '\0';
+        }
+        if (!parseNumber(value, n)) return reject(problem, CDIAG_INVALID);
+        n = n * 10 + tenths;
+        if (n < k.min || n > k.max) return reject(problem, CDIAG_RANGE);
+        *target = (uint8_t)n;
+        break;
+    }
+
+    case CKEY_CHOICE: {
+        int i = findChoice(k.choices, value);
+        if (i < 0) return reject(problem, CDIAG_INVALID);
+        *target = (uint8_t)i;
+        break;
+    }
+
+    case CKEY_TIME: {
+        char* sep = strchr(value, ':');
+        if (sep == nullptr) return reject(problem, CDIAG_INVALID);
+        *sep = '\0';
+        uint32_t hour, minute;
+        if (!parseNumber(value, hour) || !parseNumber(sep + 1, minute)) return reject(problem, CDIAG_INVALID);
+        if (hour > 23 || minute > 59) return reject(problem, CDIAG_RANGE);
+        target[0] = (uint8_t)hour;
+        target[1] = (uint8_t)minute;
+        break;
+    }
+
+    case CKEY_WIFI: {
+        char* sep = strchr(value, ';');
+        if (sep == nullptr) return reject(problem, CDIAG_INVALID);
+
+        // Spaces around the separator are not part of SSID/password
+        char* ssidEnd = sep;
+        while (ssidEnd > value && isSpace(ssidEnd[-1])) ssidEnd--;
+        *ssidEnd = '\0';
+        char* pass = sep + 1;
+        while (isSpace(*pass)) pass++;
+
+        if (value[0] == '\0') return reject(problem, CDIAG_INVALID);
+        if (strlen(value) >= sizeof(c.wifi[0].ssid) || strlen(pass) >= sizeof(c.wifi[0].password)) {
+            return reject(problem, CDIAG_RANGE);
+        }
+        if (c.wifiCount >= WIFI_LIST_SIZE) return reject(problem, CDIAG_LIST_FULL);
+
+        strcpy(c.wifi[c.wifiCount].ssid, value);
+        strcpy(c.wifi[c.wifiCount].password, pass);
+        c.wifiCount++;
+        break;
+    }
+    }
+    return true;
+}
+
+/**
+ * @brief Handles one complete line (p.line, p.length).
+ */
+static void processLine(ConfigParser &p) {
+    p.lineNo++;
+
+    if (p.overflow) {
+        report(p, CDIAG_TOO_LONG, "", 0);
+        return;
+    }
+
+    char* s = p.line;
+    char* end = p.line + p.length;
+    while (s < end && isSpace(*s)) s++;
+    while (end > s && isSpace(end[-1])) end--;
+    *end = '\0';
+
+    // Empty lines and comments
+    if (s == end || *s == '#') return;
+
+    char* eq = strchr(s, '=');
+    if (eq == nullptr) {
+        report(p, CDIAG_SYNTAX, "", 0);
+        return;
+    }
+
+    char* keyEnd = eq;
+    while (keyEnd > s && isSpace(keyEnd[-1])) keyEnd--;
+    size_t keyLen = keyEnd - s;
+    char* value = eq + 1;
+    while (isSpace(*value)) value++;
+
+    int i = findKey(s, keyLen);
+    if (i < 0) {
+        report(p, CDIAG_UNKNOWN_KEY, s, keyLen);
+        return;
+    }
+
+    const ConfigKey &k = CONFIG_KEYS[i];
+    if (k.type != CKEY_WIFI) {
+        if (p.seen & (1UL << i)) report(p, CDIAG_DUPLICATE, s, keyLen);
+        p.seen |= (1UL << i);
+    }
+
+    ConfigDiagCode problem;
+    if (!applyValue(*p.out, k, value, problem)) report(p, problem, s, keyLen);
+}
+
+// --- API ---
+
+void cparser_begin(ConfigParser &p, ConfigData &out) {
+    memset(&p, 0, sizeof(p));
+    p.out = &out;
+    config_setDefaults(out);
+}
+
+void cparser_feed(ConfigParser &p, const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            processLine(p);
+            p.length = 0;
+            p.overflow = false;
+        } else if (p.length < CPARSER_MAX_LINE) {
+            p.line[p.length++] = (c == '\0') ? ' ' : c;
+        } else {
+            p.overflow = true;
+        }
+    }
+}
+
+void cparser_end(ConfigParser &p) {
+    if (p.length > 0 || p.overflow) {
+        processLine(p);
+        p.length = 0;
+        p.overflow = false;
+    }
+}
+
+int cparser_findKey(const char* name) {
+    return findKey(name, strlen(name));
+}
+
+bool cparser_set(ConfigData &c, const char* key, const char* value, ConfigDiagCode &problem) {
+    int i = cparser_findKey(key);
+    if (i < 0) return reject(problem, CDIAG_UNKNOWN_KEY);
+
+    // applyValue() works in place
+    char buf[CPARSER_MAX_LINE + 1];
+    size_t len = strlen(value);
+    if (len >= sizeof(buf)) return reject(problem, CDIAG_TOO_LONG);
+    memcpy(buf, value, len + 1);
+
+    return applyValue(c, CONFIG_KEYS[i], buf, problem);
+}
+
+bool cparser_clearList(ConfigData &c, const char* key, ConfigDiagCode &problem) {
+    int i = cparser_findKey(key);
+    if (i < 0) return reject(problem, CDIAG_UNKNOWN_KEY);
+    if (CONFIG_KEYS[i].type != CKEY_WIFI) return reject(problem, CDIAG_INVALID);
+
+    memset(c.wifi, 0, sizeof(c.wifi));
+    c.wifiCount = 0;
+    return true;
+}
+
+const char* cparser_diagText(ConfigDiagCode code) {
+    switch (code) {
+    case CDIAG_SYNTAX:      return "missing '='";
+    case CDIAG_TOO_LONG:    return "line too long";
+    case CDIAG_UNKNOWN_KEY: return "unknown key";
+    case CDIAG_INVALID:     return "invalid value";
+    case CDIAG_RANGE:       return "value out of range";
+    case CDIAG_DUPLICATE:   return "duplicate key, last value used";
+    case CDIAG_LIST_FULL:   return "too many entries";
+    }
+    return "?";
+}
+
+size_t cparser_formatValue(const ConfigKey &key, const ConfigData &c, char* buf, size_t size) {
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(&c) + key.offset;
+    int n = 0;
+
+    switch (key.type) {
+    case CKEY_BOOL:   n = snprintf(buf, size, "%d", *reinterpret_cast<const bool*>(src) ? 1 : 0); break;
+    case CKEY_UINT8:  n = snprintf(buf, size, "%u", src[0]);                                       break;
+    case CKEY_STRING: n = snprintf(buf, size, "%s", reinterpret_cast<const char*>(src));           break;
+    case CKEY_TIME:   n = snprintf(buf, size, "%02u:%02u", src[0], src[1]);                        break;
+    case CKEY_DECI:   n = snprintf(buf, size, "%u.%u", src[0] / 10, src[0] % 10);                  break;
+    case CKEY_WIFI:   if (size > 0) buf[0] = '\0';                                                 break;
+    case CKEY_CHOICE: {
+        int len;
+        const char* name = choiceName(key.choices, src[0], len);
+        n = snprintf(buf, size, "%.*s", len, name);
+        break;
+    }
+    }
+    return (n > 0 && (size_t)n < size) ? (size_t)n : 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file config_parser.h
+ * @brief Schema-driven parser for config.txt
+ *
+ * Every key is described once in CONFIG_KEYS (name, type, range, target
+ * member of ConfigData). The parser is fed the file in chunks of any size
+ * and works in one pass over a fixed line buffer: no String, no heap.
+ *
+ * Keys are case-insensitive. Problems are collected with their line
+ * number instead of being ignored silently:
+ *  - lines without '=' and lines longer than CPARSER_MAX_LINE
+ *  - unknown keys
+ *  - values that are no number/bool/time/choice or are out of range
+ *    (the value is not applied, the previous value stays)
+ *  - keys given twice (the last value wins)
+ *  - more wifi= lines than WIFI_LIST_SIZE
+ *
+ * This file has no Arduino dependency.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "config_manager.h"
+
+/**
+ * @brief Maximum line length (without line end)
+ */
+#define CPARSER_MAX_LINE 160
+
+/**
+ * @brief Number of diagnostics kept, further ones are only counted
+ */
+#define CPARSER_MAX_DIAGS 8
+
+/**
+ * @enum ConfigKeyType
+ * @brief Value format of a key
+ */
+enum ConfigKeyType : uint8_t {
+    CKEY_BOOL,      ///< 0/1, true/false, yes/no, on/off
+    CKEY_UINT8,     ///< Decimal number in [min, max]
+    CKEY_STRING,    ///< Text, at most size - 1 characters
+    CKEY_TIME,      ///< HH:MM into two consecutive uint8_t (hour, minute)
+    CKEY_WIFI,      ///< SSID;PASSWORD, appended to config.wifi
+    CKEY_CHOICE,    ///< One of the names in choices, stored as its index (uint8_t)
+    CKEY_DECI       ///< Number with at most one decimal (e.g. 11.5), stored in tenths (uint8_t, [min, max])
+};
+
+/**
+ * @struct ConfigKey
+ * @brief One key of config.txt
+ */
+struct ConfigKey {
+    const char* name;       ///< Lower case
+    ConfigKeyType type;
+    uint8_t min;            ///< CKEY_UINT8 and CKEY_DECI only
+    uint8_t max;
+    uint16_t offset;        ///< Target member in ConfigData
+    uint16_t size;          ///< Size of the target member
+    const char* choices;    ///< CKEY_CHOICE only: lower case names separated by '|'
+};
+
+/**
+ * @brief Schema of config.txt, in export order
+ */
+extern const ConfigKey CONFIG_KEYS[];
+extern const uint8_t CONFIG_KEY_COUNT;
+
+/**
+ * @enum ConfigDiagCode
+ * @brief Kind of problem in a line
+ */
+enum ConfigDiagCode : uint8_t {
+    CDIAG_SYNTAX,       ///< No '=' in the line
+    CDIAG_TOO_LONG,     ///< Line longer than CPARSER_MAX_LINE
+    CDIAG_UNKNOWN_KEY,
+    CDIAG_INVALID,      ///< Value has the wrong format
+    CDIAG_RANGE,        ///< Value out of range or too long
+    CDIAG_DUPLICATE,    ///< Key given more than once
+    CDIAG_LIST_FULL     ///< More than WIFI_LIST_SIZE wifi entries
+};
+
+/**
+ * @struct ConfigDiag
+ * @brief One reported problem
+ */
+struct ConfigDiag {
+    uint16_t line;          ///< 1-based
+    ConfigDiagCode code;
+    char key[24];           ///< Key as written (truncated), empty for line errors
+};
+
+/**
+ * @struct ConfigParser
+ * @brief Parser state
+ */
+struct ConfigParser {
+    ConfigData* out;
+    char line[CPARSER_MAX_LINE + 1];
+    uint16_t length;        ///< Characters in line
+    uint16_t lineNo;
+    bool overflow;          ///< Current line is too long, rest is skipped
+    uint32_t seen;          ///< Bit per CONFIG_KEYS entry (duplicates)
+    ConfigDiag diags[CPARSER_MAX_DIAGS];
+    uint8_t diagCount;      ///< Entries in diags
+    uint16_t problems;      ///< All problems, including those not kept
+};
+
+/**
+ * @brief Starts parsing into out, which is set to the defaults first.
+ */
+void cparser_begin(ConfigParser &p, ConfigData &out);
+
+/**
+ * @brief Feeds the next chunk of the file.
+ */
+void cparser_feed(ConfigParser &p, const char* data, size_t len);
+
+/**
+ * @brief Processes a last line without line end.
+ */
+void cparser_end(ConfigParser &p);
+
+/**
+ * @brief Looks up a key (case-insensitive).
+ *
+ * @return Index in CONFIG_KEYS, -1 if unknown
+ */
+int cparser_findKey(const char* name);
+
+/**
+ * @brief Sets one key with the same validation as a line "key=value".
+ *
+ * A CKEY_WIFI value ("SSID;PASSWORD") is appended to the list. On error
+ * c is unchanged.
+ *
+ * @param c       Configuration to change
+ * @param key     Key name
+ * @param value   Value as in config.txt
+ * @param problem Reason if false is returned
+ * @return true if the value was applied
+ */
+bool cparser_set(ConfigData &c, const char* key, const char* value, ConfigDiagCode &problem);
+
+/**
+ * @brief Removes all entries of a list key (CKEY_WIFI).
+ *
+ * @return false if the key is unknown or no list (problem is set)
+ */
+bool cparser_clearList(ConfigData &c, const char* key, ConfigDiagCode &problem);
+
+/**
+ * @brief Returns a short English description of a diagnostic.
+ */
+const char* cparser_diagText(ConfigDiagCode code);
+
+/**
+ * @brief Formats the value of a key as in config.txt.
+ *
+ * @param key  Key (not CKEY_WIFI, which has one line per entry)
+ * @param c    Configuration
+ * @param buf  Destination
+ * @param size Size of buf
+ * @return Length written (without terminator)
+ */
+size_t cparser_formatValue(const ConfigKey &key, const ConfigData &c, char* buf, size_t size);
@@ -0,0 +1,35 @@
+/**
+ * @file crc32.h
+ * @brief CRC-32 (IEEE 802.3, as zlib) for stored blobs
+ *
+ * Nibble table: 64 bytes of flash, two lookups per byte.
+ * This file has no Arduino dependency.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Computes or continues a CRC-32.
+ *
+ * @param data Data
+ * @param len  Length in bytes
+ * @param crc  Result of the previous block, 0 for the first
+ * @return CRC-32 of all blocks so far
+ */
+inline uint32_t crc32(const void* data, size_t len, uint32_t crc = 0) {
+    static const uint32_t TABLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    }
+    return ~crc;
+}
@@ -1,12 +1,18 @@
+#define LOG_MODULE LOG_MOD_DEW
+
 #include "dew_controller.h"
 #include "bme280_manager.h"   // liefert bme_getTemperature(), bme_getHumidity(), bme_isAvailable()
 #include "power_control.h"
-#include "config_manager.h"    // dew1Level / dew2Level
+#include "config_manager.h"    // dew1_level / dew2_level
 #include "web_log.h"
+#include "task_manager.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include "dew_model.h"
+#include "lens_probe.h"
 #include <math.h>
+#include <atomic>
 
-// Update-Intervall in Millisekunden
-#define DEW_UPDATE_INTERVAL 5000
 #define DEW_FULL_ON_DELTA 2.0f  // ΔT 100% PWM erreicht wird
 #define DEW_START_DELTA    4.0f   // ab 3°C Abstand anfangen
 
@@ -17,10 +23,43 @@ static DewStatus status = {
     .dewPoint = 0,
     .dew1Power = 0,
     .dew2Power = 0,
+    .dew1Max = 0,
+    .dew2Max = 0,
+    .mode = DEW_MODE_RAMP,
+    .spreadSlope = 0,
+    .lens1Temp = NAN,
+    .lens2Temp = NAN,
     .active = false,
     .lastUpdateMs = 0
 };
 
+// Veröffentlichter Status für andere Tasks (Webserver, OLED)
+static Snapshot<DewStatus> published(status);
+
+// Obergrenzen aus der Konfiguration, gesetzt vom Webserver-Task
+static std::atomic<uint8_t> maxLevel1(0);
+static std::atomic<uint8_t> maxLevel2(0);
+static std::atomic<uint8_t> dewMode(DEW_MODE_RAMP);
+static std::atomic<uint8_t> targetOffset(3);
+static TaskJobId dewJob = TASK_JOB_INVALID;
+
+/**
+ * @brief Regelzustand einer Heizung
+ */
+struct DewHeater {
+    DewModel model;
+    DewPid pid;
+    bool pidActive;     ///< Linsenfühler liefert Werte, PID regelt
+};
+
+// Modell pro Heizung und Taupunkttrend, nur im Sensor-Task benutzt.
+// Das Modell läuft in jeder Betriebsart mit, damit ein Wechsel ohne
+// Einschwingen möglich ist; mit Linsenfühler wird es angepasst.
+static DewTrend trend;
+static DewHeater heater1;
+static DewHeater heater2;
+static unsigned long lastModelMs = 0;
+
 // ---------------- Taupunkt-Berechnung ----------------
 static float calculateDewPoint(float tempC, float humidity)
 {
@@ -33,12 +72,92 @@ static float calculateDewPoint(float tempC, float humidity)
     return (b * gamma) / (a - gamma);
 }
 
+// Umrechnung % <-> Festkomma-Tastgrad von power_control
+static inline float dutyToPercent(uint16_t duty) { return duty * 100.0f / POWER_DUTY_FULL; }
+static inline uint16_t percentToDuty(float percent) { return (uint16_t)lroundf(constrain(percent, 0.0f, 100.0f) * POWER_DUTY_FULL / 100.0f); }
+
+// ---------------- Metrics ----------------
+// Tatsächlicher PWM-Wert in %, gelesen erst beim Scrape
+static float dew1Duty() { return dutyToPercent(power_getDuty(POWER_DEW1)); }
+static float dew2Duty() { return dutyToPercent(power_getDuty(POWER_DEW2)); }
+
+// ---------------- Konfiguration ----------------
+// Neue Obergrenze sofort anwenden, nicht erst beim nächsten Intervall
+static void onLevelChanged(const ConfigData &c)
+{
+    maxLevel1.store(c.dew1Level, std::memory_order_relaxed);
+    maxLevel2.store(c.dew2Level, std::memory_order_relaxed);
+    task_trigger(dewJob);
+}
+
+static void onModeChanged(const ConfigData &c)
+{
+    dewMode.store(c.dewMode == DEW_MODE_MPC ? DEW_MODE_MPC : DEW_MODE_RAMP, std::memory_order_relaxed);
+    task_trigger(dewJob);
+}
+
+static void onOffsetChanged(const ConfigData &c)
+{
+    targetOffset.store(c.dewTargetOffset, std::memory_order_relaxed);
+    task_trigger(dewJob);
+}
+
+// ---------------- Leistung einer Heizung ----------------
+/**
+ * @param lens    Linsentemperatur, NAN ohne Fühler
+ * @param applied Bisherige Leistung in %
+ * @param dt      Zeit seit dem letzten Aufruf in s
+ */
+static float heaterPower(uint8_t n, DewHeater &heater, float lens, float applied, int max,
+                       float td, float delta, float slope, float dt)
+{
+    // Mit Fühler: PID auf Taupunkt + Offset
+    if (!isnan(lens)) {
+        if (!heater.pidActive) {
+            dewpid_start(heater.pid, applied, lens);
+            heater.pidActive = true;
+            LOGF("DewCtrl: heater %u PID on lens probe", n);
+        }
+        float target = td + targetOffset.load(std::memory_order_relaxed);
+        return dewpid_update(heater.pid, target, lens, dt, max);
+    }
+
+    // Ohne Fühler: Regelung über die Umgebungstemperatur
+    if (heater.pidActive) {
+        heater.pidActive = false;
+        LOG_WARN("DewCtrl: heater %u lens probe missing, ambient control", n);
+    }
+
+    if (status.mode == DEW_MODE_MPC) {
+        // Kleinste Leistung, die die Optik über den Horizont DEW_MPC_MARGIN über Td hält
+        return dewmodel_minDuty(heater.model, delta, slope, DEW_MPC_MARGIN, max / 100.0f) * 100.0f;
+    }
+    if (delta < DEW_START_DELTA) {
+        float factor = (DEW_START_DELTA - delta) / DEW_FULL_ON_DELTA;
+        return constrain(factor * max, 0.0f, (float)max);
+    }
+    return 0.0f;
+}
+
 // ---------------- Init ----------------
 bool dew_init()
 {
+    // Auch ohne Sensor registrieren: dew_update() hält die Heizungen dann aus
+    dewJob = task_register(TASK_SENSOR, "dew", dew_update, DEW_UPDATE_INTERVAL);
+    config_subscribe("dew1_level", onLevelChanged);
+    config_subscribe("dew2_level", onLevelChanged);
+    config_subscribe("dew_mode", onModeChanged);
+    config_subscribe("dew_target_offset", onOffsetChanged);
+    dewtrend_reset(trend);
+    dewmodel_init(heater1.model);
+    dewmodel_init(heater2.model);
+    lensprobe_init();
+    metrics_register("cover_dew_duty_percent", "Dew heater PWM duty", "heater=\"1\"", dew1Duty);
+    metrics_register("cover_dew_duty_percent", "Dew heater PWM duty", "heater=\"2\"", dew2Duty);
+
     BmeStatus bme = bme_getStatus();
     if (!bme.present) {
-        LOG("DewCtrl: BME280 not available");
+        LOG_WARN("DewCtrl: BME280 not available");
         power_setDew1(0);
         power_setDew2(0);
         return false;
@@ -51,15 +170,20 @@ bool dew_init()
 // ---------------- Update ----------------
 void dew_update()
 {
-    unsigned long now = millis();
-    if (now - status.lastUpdateMs < DEW_UPDATE_INTERVAL) return;
-    status.lastUpdateMs = now;
+    status.lastUpdateMs = millis();
+    status.dew1Max = constrain(maxLevel1.load(std::memory_order_relaxed), 0, 100);
+    status.dew2Max = constrain(maxLevel2.load(std::memory_order_relaxed), 0, 100);
+    status.mode = (DewMode)dewMode.load(std::memory_order_relaxed);
+    status.lens1Temp = lensprobe_get(1);
+    status.lens2Temp = lensprobe_get(2);
+
     BmeStatus bme = bme_getStatus();
 
     if (!bme.present) {
         power_setDew1(0);
         power_setDew2(0);
         status.active = false;
+        published.publish(status);
         return;
     }
 
@@ -70,43 +194,50 @@ void dew_update()
         power_setDew1(0);
         power_setDew2(0);
         status.active = false;
-        LOG("DewCtrl: Invalid BME reading");
+        published.publish(status);
+        LOG_WARN("DewCtrl: Invalid BME reading");
         return;
     }
 
     float td = calculateDewPoint(t, h);
     float delta = t - td;  // Temperatur nähert sich Taupunkt
 
-    int max1 = constrain(dew1Level, 0, 100);
-    int max2 = constrain(dew2Level, 0, 100);
+    // Modell mit der Leistung fortschreiben, die seit dem letzten Aufruf anlag
+    float applied1 = dutyToPercent(power_getDuty(POWER_DEW1));
+    float applied2 = dutyToPercent(power_getDuty(POWER_DEW2));
+    float dt = lastModelMs != 0 ? (status.lastUpdateMs - lastModelMs) / 1000.0f : 0.0f;
+    dewmodel_step(heater1.model, applied1 / 100.0f, dt, status.lens1Temp - t);
+    dewmodel_step(heater2.model, applied2 / 100.0f, dt, status.lens2Temp - t);
+    lastModelMs = status.lastUpdateMs;
 
-    int p1 = 0;
-    int p2 = 0;
+    dewtrend_add(trend, status.lastUpdateMs, delta);
+    float slope = dewtrend_slope(trend);
 
-    if (delta < DEW_START_DELTA) {
-        float factor = (DEW_START_DELTA - delta) / DEW_FULL_ON_DELTA;
-        p1 = constrain(factor * max1, 0, max1);
-        p2 = constrain(factor *  max2, 0, max2);
-    }
+    // Leistung in voller Auflösung, nicht auf ganze Prozent gerundet
+    float p1 = heaterPower(1, heater1, status.lens1Temp, applied1, status.dew1Max, td, delta, slope, dt);
+    float p2 = heaterPower(2, heater2, status.lens2Temp, applied2, status.dew2Max, td, delta, slope, dt);
 
-    power_setDew1(p1);
-    power_setDew2(p2);
+    power_setDuty(POWER_DEW1, percentToDuty(p1));
+    power_setDuty(POWER_DEW2, percentToDuty(p2));
 
     status.temperature = t;
     status.humidity = h;
     status.dewPoint = td;
-    status.dew1Power = p1;
-    status.dew2Power = p2;
-    status.active = (p1 > 0 || p2 > 0);
-
-    LOGF(
-        "DewCtrl: T=%.1fC RH=%.1f%% Td=%.1fC Δ=%.2f → D1=%d%% D2=%d%%",
-        t, h, td, delta, p1, p2
+    status.dew1Power = lroundf(p1);
+    status.dew2Power = lroundf(p2);
+    status.spreadSlope = slope * 3600.0f;
+    status.active = (p1 > 0.0f || p2 > 0.0f);
+    published.publish(status);
+
+    LOG_DEBUG(
+        "DewCtrl: T=%.1fC RH=%.1f%% Td=%.1fC Δ=%.2f (%+.2f/h) %s L1=%.1fC L2=%.1fC → D1=%.1f%% D2=%.1f%%",
+        t, h, td, delta, status.spreadSlope, status.mode == DEW_MODE_MPC ? "mpc" : "ramp",
+        status.lens1Temp, status.lens2Temp, p1, p2
     );
 }
 
 // ---------------- Status Getter ----------------
 DewStatus dew_getStatus()
 {
-    return status;
+    return published.read();
 }
@@ -1,6 +1,14 @@
 #pragma once
 #include <Arduino.h>
 
+/**
+ * @brief Regelverfahren (config.txt: dew_mode)
+ */
+enum DewMode : uint8_t {
+    DEW_MODE_RAMP = 0,   ///< Feste Rampe über den Taupunktabstand
+    DEW_MODE_MPC  = 1    ///< Kleinste Leistung laut Modell und Taupunkttrend
+};
+
 /**
  * @brief Status der Dew-Heater-Regelung
  */
@@ -10,24 +18,37 @@ struct DewStatus {
     float dewPoint;      ///< °C
     int dew1Power;       ///< %
     int dew2Power;       ///< %
+    int dew1Max;         ///< % Obergrenze (dew1_level)
+    int dew2Max;         ///< % Obergrenze (dew2_level)
+    DewMode mode;
+    float spreadSlope;   ///< Trend von T - Td in °C/h
+    float lens1Temp;     ///< °C Linsenfühler Heizung 1, NAN ohne Fühler
+    float lens2Temp;     ///< °C Linsenfühler Heizung 2, NAN ohne Fühler
     bool active;         ///< true = Heizung aktiv
     unsigned long lastUpdateMs;
 };
 
+// Update-Intervall in Millisekunden
+#define DEW_UPDATE_INTERVAL 5000
+
 /**
  * @brief Initialisiert die Dew-Regelung.
  *        Der BME280 muss vorher über bme280_manager initiiert worden sein.
+ *        Registriert dew_update() und die Linsenfühler beim Sensor-Task.
  * @return true wenn Sensor verfügbar
  */
 bool dew_init();
 
 /**
- * @brief Muss zyklisch aufgerufen werden (z.B. alle 1s)
+ * @brief Wird als Job des Sensor-Tasks alle DEW_UPDATE_INTERVAL ms aufgerufen
  *        Führt Messung, Taupunktberechnung und PWM-Regelung aus.
+ *        Heizungen mit Linsenfühler (lens_probe.h) regeln per PID auf
+ *        Taupunkt + dew_target_offset, ohne Fühler nach dew_mode.
  */
 void dew_update();
 
 /**
  * @brief Liefert den aktuellen Status der Dew-Heater-Regelung
+ *        Konsistente Kopie, kann aus jedem Task aufgerufen werden.
  */
 DewStatus dew_getStatus();
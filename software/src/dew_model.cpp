@@ -0,0 +1,155 @@
+/**
+ * @file dew_model.cpp
+ * @brief Thermal model, predictive duty calculation and PID for the dew heaters
+ */
+
+#include "dew_model.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief RLS forgetting factor (~100 samples memory)
+ */
+#define DEW_FIT_FORGET 0.99f
+
+// Plausible model range, the fit is clamped to it
+#define DEW_TAU_MIN_S  30.0f
+#define DEW_TAU_MAX_S  3600.0f
+#define DEW_GAIN_MIN   1.0f
+#define DEW_GAIN_MAX   50.0f
+
+// --- Trend ---
+
+void dewtrend_reset(DewTrend &t) {
+    memset(&t, 0, sizeof(t));
+}
+
+void dewtrend_add(DewTrend &t, uint32_t ms, float spread) {
+    t.spread[t.next] = spread;
+    t.ms[t.next] = ms;
+    t.next = (t.next + 1) % DEW_TREND_SAMPLES;
+    if (t.count < DEW_TREND_SAMPLES) t.count++;
+}
+
+float dewtrend_slope(const DewTrend &t) {
+    if (t.count < 3) return 0.0f;
+
+    // Time relative to the newest sample keeps the floats small
+    uint8_t newest = (t.next + DEW_TREND_SAMPLES - 1) % DEW_TREND_SAMPLES;
+    float sx = 0, sy = 0;
+    for (uint8_t i = 0; i < t.count; i++) {
+        sx += (int32_t)(t.ms[i] - t.ms[newest]) / 1000.0f;
+        sy += t.spread[i];
+    }
+    float mx = sx / t.count;
+    float my = sy / t.count;
+
+    float sxy = 0, sxx = 0;
+    for (uint8_t i = 0; i < t.count; i++) {
+        float dx = (int32_t)(t.ms[i] - t.ms[newest]) / 1000.0f - mx;
+        sxy += dx * (t.spread[i] - my);
+        sxx += dx * dx;
+    }
+    return sxx > 0 ? sxy / sxx : 0.0f;
+}
+
+// --- Model ---
+
+void dewmodel_init(DewModel &m) {
+    memset(&m, 0, sizeof(m));
+    m.gain = DEW_MODEL_GAIN;
+    m.tau = DEW_MODEL_TAU_S;
+    m.theta[0] = 1.0f / DEW_MODEL_TAU_S;
+    m.theta[1] = DEW_MODEL_GAIN / DEW_MODEL_TAU_S;
+    // Prior uncertainty in the order of the parameters themselves
+    m.cov[0][0] = 1e-4f;
+    m.cov[1][1] = 1e-3f;
+}
+
+/**
+ * @brief One RLS step for d(excess)/dt = -excess/tau + gain/tau * duty.
+ */
+static void fit(DewModel &m, float rate, float excess, float duty) {
+    float phi[2] = { -excess, duty };
+    if (fabsf(phi[0]) < 0.05f && phi[1] < 0.01f) return;   // no information, avoid covariance windup
+
+    float pphi[2] = {
+        m.cov[0][0] * phi[0] + m.cov[0][1] * phi[1],
+        m.cov[1][0] * phi[0] + m.cov[1][1] * phi[1]
+    };
+    float denom = DEW_FIT_FORGET + phi[0] * pphi[0] + phi[1] * pphi[1];
+    float k[2] = { pphi[0] / denom, pphi[1] / denom };
+    float err = rate - (phi[0] * m.theta[0] + phi[1] * m.theta[1]);
+
+    m.theta[0] += k[0] * err;
+    m.theta[1] += k[1] * err;
+    for (uint8_t i = 0; i < 2; i++) {
+        for (uint8_t j = 0; j < 2; j++) {
+            m.cov[i][j] = (m.cov[i][j] - k[i] * pphi[j]) / DEW_FIT_FORGET;
+        }
+    }
+    m.fitSamples++;
+
+    if (m.theta[0] <= 0 || m.theta[1] <= 0) return;     // not yet meaningful, keep the last model
+    float tau = 1.0f / m.theta[0];
+    float gain = m.theta[1] / m.theta[0];
+    m.tau = tau < DEW_TAU_MIN_S ? DEW_TAU_MIN_S : (tau > DEW_TAU_MAX_S ? DEW_TAU_MAX_S : tau);
+    m.gain = gain < DEW_GAIN_MIN ? DEW_GAIN_MIN : (gain > DEW_GAIN_MAX ? DEW_GAIN_MAX : gain);
+}
+
+void dewmodel_step(DewModel &m, float duty, float dtS, float measuredExcess) {
+    if (dtS <= 0) return;
+
+    if (!isnan(measuredExcess)) {
+        if (m.measured) fit(m, (measuredExcess - m.excess) / dtS, m.excess, duty);
+        m.excess = measuredExcess;
+        m.measured = true;
+        return;
+    }
+
+    float a = expf(-dtS / m.tau);
+    m.excess = m.excess * a + m.gain * duty * (1.0f - a);
+    m.measured = false;
+}
+
+float dewmodel_minDuty(const DewModel &m, float spread, float spreadSlope, float margin, float maxDuty) {
+    float duty = 0.0f;
+    for (uint8_t j = 1; j <= DEW_MPC_POINTS; j++) {
+        float h = DEW_MPC_HORIZON_S * j / DEW_MPC_POINTS;
+        float a = expf(-h / m.tau);
+
+        // Rise still needed at h after the current excess has decayed
+        float need = margin - (spread + spreadSlope * h) - m.excess * a;
+        if (need <= 0) continue;
+
+        float d = need / (m.gain * (1.0f - a));
+        if (d > duty) duty = d;
+    }
+    return duty > maxDuty ? maxDuty : duty;
+}
+
+// --- PID ---
+
+void dewpid_start(DewPid &p, float output, float input) {
+    p.integral = output;
+    p.lastInput = input;
+}
+
+float dewpid_update(DewPid &p, float setpoint, float input, float dtS, float outMax) {
+    float error = setpoint - input;
+    float derivative = dtS > 0 ? -(input - p.lastInput) / dtS : 0.0f;
+    p.lastInput = input;
+
+    float out = DEW_PID_KP * error + p.integral + DEW_PID_KD * derivative;
+
+    // Anti-windup: integrate only if the output is not pushed further into a limit
+    if (!(out >= outMax && error > 0) && !(out <= 0 && error < 0)) {
+        p.integral += DEW_PID_KI * error * dtS;
+        if (p.integral > outMax) p.integral = outMax;
+        if (p.integral < 0) p.integral = 0;
+        out = DEW_PID_KP * error + p.integral + DEW_PID_KD * derivative;
+    }
+
+    if (out > outMax) return outMax;
+    return out < 0 ? 0.0f : out;
+}
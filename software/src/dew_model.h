@@ -0,0 +1,140 @@
+/**
+ * @file dew_model.h
+ * @brief Thermal model, predictive duty calculation and PID for the dew heaters
+ *
+ * The optics are modelled as a first-order system relative to ambient:
+ *
+ *     d(excess)/dt = (gain * duty - excess) / tau
+ *
+ * with excess = lens temperature - ambient, duty in 0..1, gain = steady
+ * state rise at 100 % and tau = time constant. Without a lens probe the
+ * excess is only estimated from the applied duty; with one, gain and tau
+ * are fitted online (recursive least squares) and the estimate is
+ * replaced by the measurement.
+ *
+ * The trend of the spread (ambient - dew point) is a least-squares line
+ * over the recent samples. dewmodel_minDuty() returns the smallest
+ * constant duty that keeps lens - dew point >= margin at every point of
+ * the prediction horizon (one move, re-evaluated at every update).
+ *
+ * With a lens probe the duty comes from a PID loop on the lens
+ * temperature instead (DewPid): setpoint dew point + offset, derivative
+ * on the measurement, no integration while the output is saturated.
+ *
+ * This file has no Arduino dependency.
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Samples used for the spread trend (at DEW_UPDATE_INTERVAL)
+ */
+#define DEW_TREND_SAMPLES 24
+
+/**
+ * @brief Lens temperature to keep above the dew point (°C)
+ */
+#define DEW_MPC_MARGIN 2.0f
+
+/**
+ * @brief Prediction horizon (s) and number of points checked in it
+ */
+#define DEW_MPC_HORIZON_S 900.0f
+#define DEW_MPC_POINTS 6
+
+/**
+ * @brief Model before the fit has data: rise at 100 % (°C) and time constant (s)
+ */
+#define DEW_MODEL_GAIN 8.0f
+#define DEW_MODEL_TAU_S 300.0f
+
+/**
+ * @brief PID gains, output in % (tuned for DEW_MODEL_GAIN/TAU_S, lambda 300 s)
+ */
+#define DEW_PID_KP 12.5f     ///< % per °C
+#define DEW_PID_KI 0.04f     ///< % per °C and s
+#define DEW_PID_KD 60.0f     ///< % per °C/s
+
+/**
+ * @struct DewTrend
+ * @brief Recent spread samples (ring buffer)
+ */
+struct DewTrend {
+    float spread[DEW_TREND_SAMPLES];    ///< Ambient - dew point (°C)
+    uint32_t ms[DEW_TREND_SAMPLES];
+    uint8_t count;
+    uint8_t next;
+};
+
+/**
+ * @struct DewModel
+ * @brief Thermal model of one heater
+ */
+struct DewModel {
+    float excess;       ///< Lens - ambient (°C), estimated or measured
+    float gain;         ///< °C at 100 %
+    float tau;          ///< s
+    float theta[2];     ///< Fit parameters: 1/tau, gain/tau
+    float cov[2][2];    ///< RLS covariance
+    bool measured;      ///< excess came from a probe at the last step
+    uint32_t fitSamples;
+};
+
+/**
+ * @struct DewPid
+ * @brief PID state of one heater
+ */
+struct DewPid {
+    float integral;     ///< %
+    float lastInput;    ///< °C
+};
+
+void dewtrend_reset(DewTrend &t);
+void dewtrend_add(DewTrend &t, uint32_t ms, float spread);
+
+/**
+ * @brief Slope of the spread (°C/s), 0 with fewer than 3 samples.
+ */
+float dewtrend_slope(const DewTrend &t);
+
+void dewmodel_init(DewModel &m);
+
+/**
+ * @brief Advances the model by dt with the duty applied during it.
+ *
+ * @param duty           Duty of the past interval (0..1)
+ * @param dtS            Length of the interval (s)
+ * @param measuredExcess Lens - ambient from a probe, NAN if there is none
+ */
+void dewmodel_step(DewModel &m, float duty, float dtS, float measuredExcess);
+
+/**
+ * @brief Smallest duty that keeps the margin over the horizon.
+ *
+ * @param spread      Ambient - dew point now (°C)
+ * @param spreadSlope Trend of the spread (°C/s)
+ * @param margin      Lens - dew point to keep (°C)
+ * @param maxDuty     Upper limit (0..1)
+ * @return Duty 0..maxDuty
+ */
+float dewmodel_minDuty(const DewModel &m, float spread, float spreadSlope, float margin, float maxDuty);
+
+/**
+ * @brief Starts the loop bumpless from the current output.
+ *
+ * @param output Duty applied now (%)
+ * @param input  Lens temperature now (°C)
+ */
+void dewpid_start(DewPid &p, float output, float input);
+
+/**
+ * @brief One PID step.
+ *
+ * @param setpoint Lens temperature to reach (°C)
+ * @param input    Lens temperature (°C)
+ * @param dtS      Time since the last step (s)
+ * @param outMax   Upper limit (%)
+ * @return Duty 0..outMax (%)
+ */
+float dewpid_update(DewPid &p, float setpoint, float input, float dtS, float outMax);
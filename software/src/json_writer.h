@@ -0,0 +1,169 @@
+/**
+ * @file json_writer.h
+ * @brief Streaming JSON output for fixed schemas
+ *
+ * JsonWriter writes keys and values directly into any Print (a web
+ * response stream, Serial or a JsonBuffer) while the caller walks its
+ * schema. There is no document tree, no String and no heap allocation;
+ * numbers are formatted into a small stack buffer.
+ *
+ * The caller is responsible for a valid structure (balanced
+ * beginObject/endObject, at most JSON_WRITER_DEPTH levels).
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+/**
+ * @brief Maximum nesting depth
+ */
+#define JSON_WRITER_DEPTH 4
+
+/**
+ * @class JsonBuffer
+ * @brief Print into a caller-provided char array (null-terminated)
+ */
+class JsonBuffer : public Print {
+public:
+    JsonBuffer(char* buf, size_t size) : buf_(buf), size_(size), len_(0), overflow_(false) {
+        if (size_ > 0) buf_[0] = '\0';
+    }
+
+    size_t write(uint8_t c) override {
+        if (len_ + 1 >= size_) {
+            overflow_ = true;
+            return 0;
+        }
+        buf_[len_++] = (char)c;
+        buf_[len_] = '\0';
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        if (len_ + len >= size_) {
+            overflow_ = true;
+            return 0;
+        }
+        memcpy(&buf_[len_], data, len);
+        len_ += len;
+        buf_[len_] = '\0';
+        return len;
+    }
+
+    const char* c_str() const { return buf_; }
+    size_t length() const { return len_; }
+    bool overflow() const { return overflow_; }
+
+private:
+    char* buf_;
+    size_t size_;
+    size_t len_;
+    bool overflow_;
+};
+
+/**
+ * @class JsonWriter
+ * @brief Writes one JSON document to a Print
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(Print &out) : out_(out), depth_(0) {}
+
+    /**
+     * @brief Opens an object, as member "key" or at top level (key = nullptr).
+     */
+    void beginObject(const char* key = nullptr) {
+        member(key);
+        out_.write((uint8_t)'{');
+        if (depth_ < JSON_WRITER_DEPTH) first_[depth_++] = true;
+    }
+
+    void endObject() {
+        out_.write((uint8_t)'}');
+        if (depth_ > 0) depth_--;
+    }
+
+    void field(const char* key, bool value) {
+        member(key);
+        raw(value ? "true" : "false");
+    }
+
+    void field(const char* key, int32_t value) {
+        char buf[12];
+        member(key);
+        raw(buf, snprintf(buf, sizeof(buf), "%ld", (long)value));
+    }
+
+    void field(const char* key, uint32_t value) {
+        char buf[12];
+        member(key);
+        raw(buf, snprintf(buf, sizeof(buf), "%lu", (unsigned long)value));
+    }
+
+    /**
+     * @brief Float with fixed decimals, NaN/Inf and values too wide for the buffer as null
+     */
+    void field(const char* key, float value, uint8_t decimals) {
+        char buf[24];
+        member(key);
+        int n = (isnan(value) || isinf(value)) ? 0 : snprintf(buf, sizeof(buf), "%.*f", (int)decimals, (double)value);
+        if (n <= 0 || n >= (int)sizeof(buf)) {
+            raw("null");
+            return;
+        }
+        raw(buf, n);
+    }
+
+    void field(const char* key, const char* value) {
+        member(key);
+        string(value);
+    }
+
+private:
+    /**
+     * @brief Comma (if not the first member) and "key":
+     */
+    void member(const char* key) {
+        if (depth_ > 0) {
+            if (!first_[depth_ - 1]) out_.write((uint8_t)',');
+            first_[depth_ - 1] = false;
+        }
+        if (key != nullptr) {
+            string(key);
+            out_.write((uint8_t)':');
+        }
+    }
+
+    void raw(const char* s) {
+        out_.write((const uint8_t*)s, strlen(s));
+    }
+
+    void raw(const char* s, int len) {
+        if (len > 0) out_.write((const uint8_t*)s, (size_t)len);
+    }
+
+    /**
+     * @brief Quoted string, escapes quotes, backslashes and control characters
+     */
+    void string(const char* s) {
+        out_.write((uint8_t)'"');
+        const char* run = s;
+        for (; *s; s++) {
+            uint8_t c = (uint8_t)*s;
+            if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+            raw(run, (int)(s - run));
+            char esc[8];
+            if (c == '"' || c == '\\') raw(esc, snprintf(esc, sizeof(esc), "\\%c", c));
+            else raw(esc, snprintf(esc, sizeof(esc), "\\u%04x", c));
+            run = s + 1;
+        }
+        raw(run, (int)(s - run));
+        out_.write((uint8_t)'"');
+    }
+
+    Print &out_;
+    uint8_t depth_;
+    bool first_[JSON_WRITER_DEPTH];
+};
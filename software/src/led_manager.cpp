@@ -1,5 +1,9 @@
 #include "led_manager.h"
 #include "pins.h"
+#include "task_manager.h"
+
+#define LED_BLINK_SLOW_MS 500
+#define LED_BLINK_FAST_MS 150
 
 /**
  * @struct LedState
@@ -30,6 +34,11 @@ static LedState leds[LED_COUNT] = {
  */
 static uint8_t globalBrightness = 255;
 
+/**
+ * @brief Scheduler job running updateLeds()
+ */
+static TaskJobId ledJob = TASK_JOB_INVALID;
+
 /**
  * @brief Initializes LEDC and attaches pins
  */
@@ -39,6 +48,8 @@ void initLeds() {
         ledcAttachPin(leds[i].pin, leds[i].channel);
         ledcWrite(leds[i].channel, 0);
     }
+
+    ledJob = task_register(TASK_UI, "leds", updateLeds, 0);
 }
 
 /**
@@ -51,6 +62,7 @@ void setLedMode(LedId led, LedMode mode) {
     leds[led].mode = mode;
     leds[led].lastToggle = millis();
     leds[led].state = false;
+    task_trigger(ledJob);
 }
 
 /**
@@ -69,6 +81,7 @@ LedMode getLedMode(LedId led) {
  */
 void setGlobalLedBrightness(uint8_t brightness) {
     globalBrightness = brightness;
+    task_trigger(ledJob);
 }
 
 /**
@@ -76,6 +89,7 @@ void setGlobalLedBrightness(uint8_t brightness) {
  */
 void updateLeds() {
     uint32_t now = millis();
+    uint32_t nextToggle = UINT32_MAX;   // time until the next blink toggle
 
     for (uint8_t i = 0; i < LED_COUNT; i++) {
         LedState &led = leds[i];
@@ -91,20 +105,31 @@ void updateLeds() {
             break;
 
         case LED_MODE_BLINK_SLOW:
-            if (now - led.lastToggle >= 500) {
+            if (now - led.lastToggle >= LED_BLINK_SLOW_MS) {
                 led.lastToggle = now;
                 led.state = !led.state;
             }
             ledcWrite(led.channel, led.state ? globalBrightness : 0);
+            if (LED_BLINK_SLOW_MS - (now - led.lastToggle) < nextToggle) {
+                nextToggle = LED_BLINK_SLOW_MS - (now - led.lastToggle);
+            }
             break;
 
         case LED_MODE_BLINK_FAST:
-            if (now - led.lastToggle >= 150) {
+            if (now - led.lastToggle >= LED_BLINK_FAST_MS) {
                 led.lastToggle = now;
                 led.state = !led.state;
             }
             ledcWrite(led.channel, led.state ? globalBrightness : 0);
+            if (LED_BLINK_FAST_MS - (now - led.lastToggle) < nextToggle) {
+                nextToggle = LED_BLINK_FAST_MS - (now - led.lastToggle);
+            }
             break;
         }
     }
+
+    // Steady LEDs need no further updates until the next mode change
+    if (nextToggle != UINT32_MAX) {
+        task_runIn(ledJob, nextToggle);
+    }
 }
@@ -42,6 +42,7 @@ enum LedMode {
  *
  * Must be called once in setup(),
  * after initPins() has been executed.
+ * Registers updateLeds() with the UI task.
  */
 void initLeds();
 
@@ -63,7 +64,9 @@ void setGlobalLedBrightness(uint8_t brightness);
 /**
  * @brief Updates all LEDs (blink logic, PWM)
  *
- * Must be called cyclically in loop().
+ * Runs as an event-driven job of the UI task (registered by initLeds()).
+ * It is triggered by mode/brightness changes and re-schedules itself
+ * only while an LED is blinking.
  * This function is completely non-blocking.
  */
 void updateLeds();
@@ -0,0 +1,211 @@
+#define LOG_MODULE LOG_MOD_DEW
+
+#include "lens_probe.h"
+#include "pins.h"
+#include "config_manager.h"
+#include "web_log.h"
+#include "task_manager.h"
+#include "analog_input.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <math.h>
+#include <atomic>
+
+#define LENS_PROBE_COUNT 2
+
+// Raw ADC values closer than this to the ends mean open or shorted NTC
+#define NTC_RAW_MARGIN 20
+
+/**
+ * @struct LensProbeStatus
+ * @brief Readings of both probes
+ */
+struct LensProbeStatus {
+    float temp[LENS_PROBE_COUNT];   ///< °C, NAN = no reading
+};
+
+static LensProbeStatus status = { { NAN, NAN } };   // sensor task only
+static Snapshot<LensProbeStatus> published(status); // read by all tasks
+
+// Configuration, set by the web server task
+static std::atomic<uint8_t> probeType[LENS_PROBE_COUNT];
+static std::atomic<bool> rescan(true);
+static TaskJobId probeJob = TASK_JOB_INVALID;
+
+// 1-Wire bus, sensor task only
+static OneWire oneWire;
+static DallasTemperature dallas;
+static bool busStarted = false;
+static bool conversionPending[LENS_PROBE_COUNT];    // requested since the probe was assigned
+static DeviceAddress address[LENS_PROBE_COUNT];
+static bool addressValid[LENS_PROBE_COUNT];
+static uint32_t lastScan = 0;
+
+static const AnalogChannel NTC_CHANNELS[LENS_PROBE_COUNT] = { ANALOG_NTC1, ANALOG_NTC2 };
+
+// ---------------- Metrics ----------------
+static float lens1Temp() { return lensprobe_get(1); }
+static float lens2Temp() { return lensprobe_get(2); }
+
+// ---------------- Configuration ----------------
+static void onProbeChanged(const ConfigData &c)
+{
+    probeType[0].store(c.lens1Probe, std::memory_order_relaxed);
+    probeType[1].store(c.lens2Probe, std::memory_order_relaxed);
+    rescan.store(true, std::memory_order_relaxed);
+    task_trigger(probeJob);
+}
+
+// ---------------- Probes ----------------
+
+/**
+ * @brief NTC temperature from the calibrated divider voltage
+ */
+static float readNtc(AnalogChannel ch)
+{
+    // The raw value shows open/shorted, the ADC saturates below 3.3 V
+    float raw = analog_getRaw(ch);
+    if (raw < NTC_RAW_MARGIN || raw > 4095 - NTC_RAW_MARGIN) return NAN;
+
+    float mv = analog_getMillivolts(ch);
+    if (mv >= NTC_SUPPLY_MV) return NAN;
+    float r = NTC_SERIES_OHM * mv / (NTC_SUPPLY_MV - mv);
+    float invT = 1.0f / 298.15f + logf(r / NTC_R25_OHM) / NTC_BETA;
+    return 1.0f / invT - 273.15f;
+}
+
+/**
+ * @brief True if another heater already has the probe with this address
+ */
+static bool addressInUse(const uint8_t* a)
+{
+    for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+        if (addressValid[i] && memcmp(address[i], a, sizeof(DeviceAddress)) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Assigns DS18B20 on the bus to the heaters configured for one.
+ *
+ * Heaters that already have a probe keep it and its pending conversion,
+ * the others get the next unassigned probe in search order.
+ *
+ * @param reassign Start over and log heaters without a probe (after boot
+ *                 or a config change)
+ */
+static void scanBus(bool reassign)
+{
+    if (!busStarted) {
+        oneWire.begin(PIN_ONEWIRE);
+        dallas.setOneWire(&oneWire);
+        dallas.setWaitForConversion(false);
+        busStarted = true;
+    }
+    if (reassign) {
+        for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+            addressValid[i] = false;
+            conversionPending[i] = false;
+        }
+    }
+    dallas.begin();
+
+    uint8_t found = dallas.getDeviceCount();
+    uint8_t next = 0;
+    for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+        if (probeType[i].load(std::memory_order_relaxed) != LENS_PROBE_DS18B20 || addressValid[i]) continue;
+
+        DeviceAddress a;
+        bool assigned = false;
+        while (!assigned && next < found) {
+            if (dallas.getAddress(a, next++) && !addressInUse(a)) assigned = true;
+        }
+        if (assigned) {
+            memcpy(address[i], a, sizeof(DeviceAddress));
+            dallas.setResolution(address[i], 12);
+            addressValid[i] = true;
+            conversionPending[i] = false;   // first reading after the next request
+            LOGF("Lens probe %u: DS18B20 %02X%02X%02X%02X%02X%02X%02X%02X", i + 1,
+                 address[i][0], address[i][1], address[i][2], address[i][3],
+                 address[i][4], address[i][5], address[i][6], address[i][7]);
+        } else if (reassign) {
+            LOG_WARN("Lens probe %u: no DS18B20 found", i + 1);
+        }
+    }
+}
+
+// ---------------- Init ----------------
+void lensprobe_init()
+{
+    probeJob = task_register(TASK_SENSOR, "lens", lensprobe_update, LENS_PROBE_INTERVAL_MS);
+    config_subscribe("lens1_probe", onProbeChanged);
+    config_subscribe("lens2_probe", onProbeChanged);
+    metrics_register("cover_lens_temperature_celsius", "Lens probe temperature", "heater=\"1\"", lens1Temp);
+    metrics_register("cover_lens_temperature_celsius", "Lens probe temperature", "heater=\"2\"", lens2Temp);
+}
+
+// ---------------- Update ----------------
+void lensprobe_update()
+{
+    uint8_t type[LENS_PROBE_COUNT];
+    bool anyDs = false;
+    bool dsMissing = false;
+    for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+        type[i] = probeType[i].load(std::memory_order_relaxed);
+        if (type[i] == LENS_PROBE_DS18B20) {
+            anyDs = true;
+            if (!addressValid[i]) dsMissing = true;
+        }
+    }
+
+    // Missing DS18B20 are searched again now and then (hot-plug)
+    bool reassign = rescan.exchange(false, std::memory_order_relaxed);
+    uint32_t now = millis();
+    if (anyDs && (reassign || (dsMissing && now - lastScan >= LENS_PROBE_RESCAN_MS))) {
+        scanBus(reassign);
+        lastScan = now;
+    }
+
+    for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+        float t = NAN;
+
+        if (type[i] == LENS_PROBE_NTC) {
+            t = readNtc(NTC_CHANNELS[i]);
+        } else if (type[i] == LENS_PROBE_DS18B20 && addressValid[i]) {
+            if (conversionPending[i]) {
+                t = dallas.getTempC(address[i]);
+                if (t == DEVICE_DISCONNECTED_C) {
+                    t = NAN;
+                    addressValid[i] = false;
+                }
+            } else {
+                t = status.temp[i];     // just assigned, first conversion not yet requested
+            }
+        }
+
+        if (type[i] != LENS_PROBE_NONE && isnan(t) != isnan(status.temp[i])) {
+            if (isnan(t)) LOG_WARN("Lens probe %u: lost", i + 1);
+            else LOGF("Lens probe %u: %.1fC", i + 1, t);
+        }
+        status.temp[i] = t;
+    }
+
+    // One request converts on all probes of the bus
+    bool request = false;
+    for (uint8_t i = 0; i < LENS_PROBE_COUNT; i++) {
+        conversionPending[i] = type[i] == LENS_PROBE_DS18B20 && addressValid[i];
+        if (conversionPending[i]) request = true;
+    }
+    if (request) dallas.requestTemperatures();
+
+    published.publish(status);
+}
+
+// ---------------- Getter ----------------
+float lensprobe_get(uint8_t heater)
+{
+    if (heater < 1 || heater > LENS_PROBE_COUNT) return NAN;
+    return published.read().temp[heater - 1];
+}
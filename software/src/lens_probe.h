@@ -0,0 +1,65 @@
+/**
+ * @file lens_probe.h
+ * @brief Optional temperature probes on the optics, one per dew heater
+ *
+ * Each heater can have a probe at the lens (config.txt lens1_probe /
+ * lens2_probe):
+ *  - ds18b20: DS18B20 on the 1-Wire bus (PIN_ONEWIRE, 4.7k pull-up).
+ *    The probes are assigned in bus search order: the first one found
+ *    to the first heater configured as ds18b20, the second to the next.
+ *  - ntc: 10k NTC (B 3950) from PIN_NTC_LENS1/2 to GND, 10k to 3.3 V.
+ *
+ * The probes are read by a job of the sensor task. DS18B20 conversions
+ * are started at one run and read at the next, the task never waits for
+ * them. A missing DS18B20 is searched for every LENS_PROBE_RESCAN_MS
+ * (hot-plug), without disturbing the probes already found. A probe that is not configured, not found, disconnected or out of
+ * range reads as NAN, and the dew control falls back to the ambient
+ * control for that heater.
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @enum LensProbeType
+ * @brief Probe of one heater, values as in config.txt
+ */
+enum LensProbeType : uint8_t {
+    LENS_PROBE_NONE = 0,
+    LENS_PROBE_DS18B20 = 1,
+    LENS_PROBE_NTC = 2
+};
+
+/**
+ * @brief Interval between two reads (ms), longer than a 12-bit DS18B20 conversion
+ */
+#define LENS_PROBE_INTERVAL_MS 2000
+
+/**
+ * @brief Interval between bus searches while a configured DS18B20 is missing (ms)
+ */
+#define LENS_PROBE_RESCAN_MS 30000
+
+// NTC and divider
+#define NTC_R25_OHM     10000.0f
+#define NTC_BETA        3950.0f
+#define NTC_SERIES_OHM  10000.0f
+#define NTC_SUPPLY_MV   3300.0f      ///< Top of the divider
+
+/**
+ * @brief Registers the probe job and the metrics.
+ */
+void lensprobe_init();
+
+/**
+ * @brief Job of the sensor task: reads the probes.
+ */
+void lensprobe_update();
+
+/**
+ * @brief Latest lens temperature of a heater (any task).
+ *
+ * @param heater 1 or 2
+ * @return °C, NAN without a working probe
+ */
+float lensprobe_get(uint8_t heater);
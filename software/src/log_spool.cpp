@@ -0,0 +1,199 @@
+/**
+ * @file log_spool.cpp
+ * @brief Write-behind SD log sink with rotation
+ *
+ * The text buffer is a single-producer/single-consumer byte ring: the sink
+ * (log drain job) appends, the write job consumes. Both normally run in
+ * the log task, the atomics only matter while setup() still drains
+ * synchronously.
+ */
+
+#define LOG_MODULE LOG_MOD_SD
+
+#include "log_spool.h"
+#include "web_log.h"
+#include "task_manager.h"
+#include <SD.h>
+#include <atomic>
+
+#define LOG_SPOOL_MASK (LOG_SPOOL_BUF_BYTES - 1)
+
+static_assert((LOG_SPOOL_BUF_BYTES & LOG_SPOOL_MASK) == 0, "LOG_SPOOL_BUF_BYTES must be a power of two");
+static_assert(LOG_SPOOL_BATCH_BYTES < LOG_SPOOL_BUF_BYTES, "batch must fit into the buffer");
+
+// Write-behind buffer
+static uint8_t buf[LOG_SPOOL_BUF_BYTES];
+static std::atomic<uint32_t> head(0);      // written by the sink
+static std::atomic<uint32_t> tail(0);      // written by the write job
+static std::atomic<uint32_t> dropped(0);
+
+// Current file
+static bool mounted = false;
+static File file;
+static uint32_t fileSize = 0;
+static uint32_t lastWrite = 0;
+
+static TaskJobId spoolJob = TASK_JOB_INVALID;
+
+// Boot log, append-only
+static char bootLog[LOG_BOOT_BYTES];
+static std::atomic<uint32_t> bootLen(0);
+
+/**
+ * @brief Path of log file n (0 = current).
+ */
+static void logPath(char* out, size_t len, uint8_t n) {
+    snprintf(out, len, LOG_SPOOL_DIR "/log%u.txt", (unsigned)n);
+}
+
+/**
+ * @brief Opens the current log file for appending.
+ */
+static bool openCurrent() {
+    char path[32];
+    logPath(path, sizeof(path), 0);
+    file = SD.open(path, FILE_APPEND);
+    if (!file) return false;
+    fileSize = file.size();
+    return true;
+}
+
+/**
+ * @brief Shifts log0 -> log1 -> ... and starts an empty log0.
+ */
+static void rotate() {
+    char from[32];
+    char to[32];
+
+    file.close();
+    logPath(to, sizeof(to), LOG_SPOOL_FILES - 1);
+    SD.remove(to);
+    for (int i = LOG_SPOOL_FILES - 2; i >= 0; i--) {
+        logPath(from, sizeof(from), i);
+        logPath(to, sizeof(to), i + 1);
+        if (SD.exists(from)) SD.rename(from, to);
+    }
+    if (!openCurrent()) mounted = false;
+}
+
+/**
+ * @brief Writes buffered text up to the last sector boundary of the file.
+ *
+ * @param partial Also write the incomplete last sector
+ */
+static void writeOut(bool partial) {
+    if (!mounted) return;
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t pending = head.load(std::memory_order_acquire) - t;
+
+    // Largest amount that ends on a sector boundary of the file
+    uint32_t toBoundary = LOG_SPOOL_SECTOR - fileSize % LOG_SPOOL_SECTOR;
+    uint32_t n = 0;
+    if (pending >= toBoundary) {
+        n = toBoundary + (pending - toBoundary) / LOG_SPOOL_SECTOR * LOG_SPOOL_SECTOR;
+    }
+    if (n == 0 && partial) n = pending;
+    if (n == 0) return;
+
+    if (fileSize + n > LOG_SPOOL_FILE_MAX) {
+        rotate();
+        if (!mounted) return;
+    }
+
+    // At most two pieces because of the wrap-around
+    uint32_t start = t & LOG_SPOOL_MASK;
+    uint32_t first = LOG_SPOOL_BUF_BYTES - start;
+    if (first > n) first = n;
+    size_t written = file.write(&buf[start], first);
+    if (n > first) written += file.write(buf, n - first);
+    file.flush();
+
+    if (written != n) {
+        mounted = false;            // card removed or full, stop writing
+        file.close();
+        LOG_ERROR("Log spool: write failed, SD logging stopped");
+    }
+
+    fileSize += n;
+    lastWrite = millis();
+    tail.store(t + n, std::memory_order_release);
+}
+
+/**
+ * @brief Write job: full batches when triggered, the rest after LOG_SPOOL_FLUSH_MS.
+ */
+static void spoolUpdate() {
+    writeOut(millis() - lastWrite >= LOG_SPOOL_FLUSH_MS);
+}
+
+/**
+ * @brief Appends bytes to the boot log while there is room.
+ */
+static void bootAppend(const char* s, size_t len) {
+    uint32_t b = bootLen.load(std::memory_order_relaxed);
+    if (b + len + 1 > LOG_BOOT_BYTES) return;
+    memcpy(&bootLog[b], s, len);
+    bootLog[b + len] = '\n';
+    bootLen.store(b + len + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Log sink: formats the file line and queues it.
+ */
+static void spoolSink(const LogRecord &rec, const char* line) {
+    bootAppend(line, strlen(line));
+
+    char text[LOG_LINE_MAX + 32];
+    int len = snprintf(text, sizeof(text), "[%8lu] %-5s %-6s %s\n",
+                       (unsigned long)rec.timestamp, log_levelName(rec.level),
+                       log_moduleName(rec.module), line);
+    if (len <= 0) return;
+    if ((size_t)len >= sizeof(text)) len = sizeof(text) - 1;
+
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t used = h - tail.load(std::memory_order_acquire);
+    if (used + len > LOG_SPOOL_BUF_BYTES) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    for (int i = 0; i < len; i++) {
+        buf[(h + i) & LOG_SPOOL_MASK] = (uint8_t)text[i];
+    }
+    head.store(h + len, std::memory_order_release);
+
+    if (used + len >= LOG_SPOOL_BATCH_BYTES) {
+        if (task_started()) task_trigger(spoolJob);
+        else writeOut(false);       // setup(): no log task yet
+    }
+}
+
+void log_spool_begin() {
+    log_addSink(spoolSink);
+    spoolJob = task_register(TASK_LOG, "spool", spoolUpdate, LOG_SPOOL_FLUSH_MS);
+}
+
+void log_spool_mount() {
+    if (!SD.exists(LOG_SPOOL_DIR)) SD.mkdir(LOG_SPOOL_DIR);
+    mounted = openCurrent();
+    if (!mounted) {
+        LOG_ERROR("Log spool: cannot open " LOG_SPOOL_DIR);
+        return;
+    }
+    lastWrite = millis();
+    LOGF("Log spool: writing to " LOG_SPOOL_DIR " (%lu bytes in log0)", (unsigned long)fileSize);
+}
+
+uint32_t log_spool_getDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+size_t log_spool_copyBootLog(char* out, size_t outLen) {
+    if (outLen == 0) return 0;
+    size_t n = bootLen.load(std::memory_order_acquire);
+    if (n > outLen - 1) n = outLen - 1;
+    memcpy(out, bootLog, n);
+    out[n] = '\0';
+    return n;
+}
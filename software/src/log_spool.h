@@ -0,0 +1,88 @@
+/**
+ * @file log_spool.h
+ * @brief Persistent log on the SD card and boot log replay
+ *
+ * A log sink that appends every record to rotating files on the SD card:
+ *   /logs/log0.txt (current), /logs/log1.txt ... (older)
+ *
+ * The sink only copies the line into a RAM write-behind buffer. A job in
+ * the log task writes the buffer to the card in batches that end on a
+ * 512 byte sector boundary of the file, so the FAT layer never has to
+ * read-modify-write a sector. A partial sector is only written when no
+ * new batch completed for LOG_SPOOL_FLUSH_MS. If the card is slow or
+ * missing the buffer fills up and new lines are dropped (and counted),
+ * the control tasks never wait for the card.
+ *
+ * The first LOG_BOOT_BYTES of log text since power-on are also kept in
+ * RAM, so the setup() messages can be replayed to /log clients.
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Size of the write-behind buffer (power of two)
+ */
+#define LOG_SPOOL_BUF_BYTES 4096
+
+/**
+ * @brief SD sector size, writes end on multiples of it
+ */
+#define LOG_SPOOL_SECTOR 512
+
+/**
+ * @brief Buffered bytes that trigger a write (whole sectors)
+ */
+#define LOG_SPOOL_BATCH_BYTES (2 * LOG_SPOOL_SECTOR)
+
+/**
+ * @brief Maximum age of buffered text before a partial sector is written
+ */
+#define LOG_SPOOL_FLUSH_MS 10000
+
+/**
+ * @brief Size at which the current file is rotated
+ */
+#define LOG_SPOOL_FILE_MAX (256UL * 1024UL)
+
+/**
+ * @brief Number of log files kept (log0 ... log3)
+ */
+#define LOG_SPOOL_FILES 4
+
+/**
+ * @brief Directory of the log files
+ */
+#define LOG_SPOOL_DIR "/logs"
+
+/**
+ * @brief Bytes of boot log kept for replay
+ */
+#define LOG_BOOT_BYTES 4096
+
+/**
+ * @brief Registers the sink and the write job.
+ *
+ * Call right after log_begin(), before the SD card is mounted: lines are
+ * buffered until log_spool_mount().
+ */
+void log_spool_begin();
+
+/**
+ * @brief Starts writing to the SD card (call after initSD() succeeded).
+ */
+void log_spool_mount();
+
+/**
+ * @brief Returns the number of lines dropped because the buffer was full.
+ */
+uint32_t log_spool_getDropped();
+
+/**
+ * @brief Copies the boot log (lines separated by '\n').
+ *
+ * @param out    Destination, null-terminated
+ * @param outLen Size of out
+ * @return Number of characters copied
+ */
+size_t log_spool_copyBootLog(char* out, size_t outLen);
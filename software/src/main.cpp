@@ -5,12 +5,14 @@
  * Responsible for:
  * - initialize all subsystems
  * - init order: Pins → SD → Config → WiFi → OTA
- * - cyclic call of non-blocking handler fcunctions
+ * - registration of the remaining jobs with the task manager
+ *   (most modules register their own jobs in their init function)
 
  */
 
 #include <Arduino.h>
 #include "pins.h"
+#include "analog_input.h"
 #include "sdcard.h"
 #include "config_manager.h"
 #include "wifi_config.h"
@@ -18,23 +20,63 @@
 #include "led_manager.h"
 #include "button_manager.h"
 #include "power_control.h"
+#include "power_budget.h"
 #include "webserver.h"
 #include "time_manager.h"
 #include "web_log.h"
+#include "log_spool.h"
 #include "bme280_manager.h"
 #include "dew_controller.h"
 #include "oled_display.h"
 #include "usb_manager.h"
+#include "task_manager.h"
+
+/**
+ * @brief Processes button events, called by the button manager after an event.
+ */
+static void handleButtonActions() {
+    if (buttonClicked(BTN_OPEN)) { 
+        usb_manager_open_cover(); 
+        LOG("Button OPEN clicked");
+    }
+    if (buttonClicked(BTN_CLOSE)) { 
+        usb_manager_close_cover(); 
+        LOG("Button CLOSE clicked");
+    }
+    if (buttonClicked(BTN_LIGHT_ON)) { 
+        usb_manager_set_brightness(getPotiBrightness()); 
+        LOG("Button LIGHT ON clicked");
+    }
+    if (buttonClicked(BTN_LIGHT_OFF)) { 
+        usb_manager_turn_off_light();
+        LOG("Button LIGHT OFF clicked");
+    }
+    //handlePotiBrightness();
+}
+
+/**
+ * @brief Applies led_brightness, called at boot and on every change.
+ */
+static void onLedBrightnessChanged(const ConfigData &c) {
+    setGlobalLedBrightness(c.ledBrightnessNormal);
+}
 
 void setup() {
 
+#if TASK_PROFILE
+    Serial.begin(115200);   // profile summary on the console
+#else
     //Serial.begin(115200);
     //delay(200);
+#endif
 
+    log_begin();    // first: registers the log drain job
+    log_spool_begin();  // buffers the boot log until the SD card is mounted
     LOG("+-- Telescope Cover Controller Starting --+");
 
     initPins();     // GPIO-init
     LOG("Pins initialized");
+    analog_init();  // supply sense, poti and NTC probes, before their users
     initLeds();     // LED initialize
     LOG("LEDs initialized");
     power_init();
@@ -42,15 +84,16 @@ void setup() {
     LOG("Power Outputs initialized");
 
     initButtons();
+    setButtonEventHandler(handleButtonActions);
     LOG("Buttons initialized");
 
-    // load config from SD card
-    if (initSD()) {
-        loadConfigFromSD();
-    }
+    // load config: NVS first, config.txt only if it changed
+    bool sdAvailable = initSD();
+    if (sdAvailable) log_spool_mount();
+    config_begin(sdAvailable);
 
-    // set LED brightness
-    setGlobalLedBrightness(ledBrightnessNormal);
+    // set LED brightness, again whenever led_brightness changes
+    config_subscribe("led_brightness", onLedBrightnessChanged);
 
     // Wifi Mode intiialized - NO CONNECTION
     initWiFi();
@@ -70,51 +113,28 @@ void setup() {
     LOG("OTA initialized");
     
 
-    // Initialize USB Cover Manager
-    //usb_manager_init(); // Initialize USB Host for CH341
+    // Initialize USB Cover Manager (the IO job connects to the CH341)
+    usb_manager_begin();
     LOG("USB Host initialized");
 
     // BME280 init
     bme_init();
     dew_init();
+    powerbudget_init();
 
     // OLED Display init
     oled_init();
 
+    // Jobs of modules without own init function
+    task_register(TASK_NET, "sched", checkScheduledActions, SCHEDULE_CHECK_INTERVAL_MS);   // Check for scheduled actions
+    //task_register(TASK_UI, "poti_bright", handlePotiBrightness, POTI_CHECK_INTERVAL_MS);
+    task_start();
+
     LOG("End of setup reached");
     LOG("*****************************************************");
 }
 
 void loop() {
-    handleWiFi();   			// maintain Wifi connections
-    handleOTA();    			// OTA-Handler
-    updateLeds();   			// LED-Fading
-	checkScheduledActions();	// Check for scheduled actions
-    updatePoti();               // Update Potentiometer
-    updateButtons();            // Update Buttons
-    bme_loop();                 // Update BME280 sensor
-    dew_update();               // Update Dew Controller
-    oled_update();              // Update OLED Display
-    usb_manager_update();               // USB Host CH341 task
-
-    //process button events and poti changes
-    if (buttonClicked(BTN_OPEN)) { 
-        usb_manager_open_cover(); 
-        LOG("Button OPEN clicked");
-    }
-    if (buttonClicked(BTN_CLOSE)) { 
-        usb_manager_close_cover(); 
-        LOG("Button CLOSE clicked");
-    }
-    if (buttonClicked(BTN_LIGHT_ON)) { 
-        usb_manager_set_brightness(getPotiBrightness()); 
-        LOG("Button LIGHT ON clicked");
-    }
-    if (buttonClicked(BTN_LIGHT_OFF)) { 
-        usb_manager_turn_off_light();
-        LOG("Button LIGHT OFF clic‚‚ked");
-    }
-    //handlePotiBrightness();
-    
-    delay(10);      			// CPU entlasten
+    // All work is done in the tasks started by task_start()
+    vTaskDelete(NULL);
 }
@@ -0,0 +1,166 @@
+/**
+ * @file metrics.cpp
+ * @brief Metric registry and Prometheus text output
+ */
+
+#include "metrics.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+enum MetricType : uint8_t {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+    METRIC_GAUGE_FN
+};
+
+/**
+ * @struct MetricEntry
+ * @brief One registered metric
+ */
+struct MetricEntry {
+    const char* name;
+    const char* help;
+    const char* labels;
+    MetricType type;
+    void* ptr;
+    MetricGaugeFn fn;
+};
+
+// Written by setup() only, read by the scraper (web server task, which already runs)
+static MetricEntry entries[METRICS_MAX];
+static std::atomic<uint8_t> entryCount(0);
+
+static const char* const TYPE_NAMES[] = { "counter", "gauge", "histogram", "gauge" };
+
+static bool add(const char* name, const char* help, const char* labels, MetricType type, void* ptr, MetricGaugeFn fn) {
+    // Single writer: once the tasks run, a registration could race with another one
+    if (task_started()) {
+        LOG_ERROR("Metrics: %s registered after task_start(), ignored", name);
+        return false;
+    }
+    uint8_t n = entryCount.load(std::memory_order_relaxed);
+    if (n >= METRICS_MAX) {
+        LOG_ERROR("Metrics: registry full, %s ignored", name);
+        return false;
+    }
+    entries[n] = { name, help, labels, type, ptr, fn };
+    entryCount.store(n + 1, std::memory_order_release);     // visible to the scraper only when complete
+    return true;
+}
+
+bool metrics_register(const char* name, const char* help, const char* labels, MetricCounter &c) {
+    return add(name, help, labels, METRIC_COUNTER, &c, nullptr);
+}
+
+bool metrics_register(const char* name, const char* help, const char* labels, MetricGauge &g) {
+    return add(name, help, labels, METRIC_GAUGE, &g, nullptr);
+}
+
+bool metrics_registerHistogram(const char* name, const char* help, const char* labels,
+                               MetricHistogram &h, const uint32_t* bounds, uint8_t boundCount) {
+    h.bounds = bounds;
+    h.boundCount = boundCount;
+    return add(name, help, labels, METRIC_HISTOGRAM, &h, nullptr);
+}
+
+bool metrics_register(const char* name, const char* help, const char* labels, MetricGaugeFn fn) {
+    return add(name, help, labels, METRIC_GAUGE_FN, nullptr, fn);
+}
+
+/**
+ * @brief name{labels,extra} value
+ */
+static void writeSample(Print &out, const char* name, const char* suffix,
+                        const char* labels, const char* extra, const char* value) {
+    out.print(name);
+    if (suffix) out.print(suffix);
+    if (labels || extra) {
+        out.print("{");
+        if (labels) out.print(labels);
+        if (labels && extra) out.print(",");
+        if (extra) out.print(extra);
+        out.print("}");
+    }
+    out.print(" ");
+    out.print(value);
+    out.print("\n");
+}
+
+static void writeHistogram(Print &out, const MetricEntry &e) {
+    const MetricHistogram &h = *static_cast<const MetricHistogram*>(e.ptr);
+    char value[16];
+    char le[24];
+    uint32_t cumulative = 0;
+
+    for (uint8_t i = 0; i <= h.boundCount; i++) {
+        cumulative += h.buckets[i].load(std::memory_order_relaxed);
+        if (i < h.boundCount) snprintf(le, sizeof(le), "le=\"%lu\"", (unsigned long)h.bounds[i]);
+        else snprintf(le, sizeof(le), "le=\"+Inf\"");
+        snprintf(value, sizeof(value), "%lu", (unsigned long)cumulative);
+        writeSample(out, e.name, "_bucket", e.labels, le, value);
+    }
+    snprintf(value, sizeof(value), "%lu", (unsigned long)h.sum.load(std::memory_order_relaxed));
+    writeSample(out, e.name, "_sum", e.labels, nullptr, value);
+    snprintf(value, sizeof(value), "%lu", (unsigned long)cumulative);
+    writeSample(out, e.name, "_count", e.labels, nullptr, value);
+}
+
+/**
+ * @brief True if an entry before i has the same name (its family is written already).
+ */
+static bool familyWritten(uint8_t i) {
+    for (uint8_t j = 0; j < i; j++) {
+        if (strcmp(entries[j].name, entries[i].name) == 0) return true;
+    }
+    return false;
+}
+
+static void writeHeader(Print &out, const MetricEntry &e) {
+    out.print("# HELP ");
+    out.print(e.name);
+    out.print(" ");
+    out.print(e.help);
+    out.print("\n# TYPE ");
+    out.print(e.name);
+    out.print(" ");
+    out.print(TYPE_NAMES[e.type]);
+    out.print("\n");
+}
+
+static void writeEntry(Print &out, const MetricEntry &e) {
+    char value[24];
+
+    switch (e.type) {
+    case METRIC_COUNTER:
+        snprintf(value, sizeof(value), "%lu",
+                 (unsigned long)static_cast<MetricCounter*>(e.ptr)->value.load(std::memory_order_relaxed));
+        writeSample(out, e.name, nullptr, e.labels, nullptr, value);
+        break;
+    case METRIC_GAUGE:
+        snprintf(value, sizeof(value), "%ld",
+                 (long)static_cast<MetricGauge*>(e.ptr)->value.load(std::memory_order_relaxed));
+        writeSample(out, e.name, nullptr, e.labels, nullptr, value);
+        break;
+    case METRIC_GAUGE_FN:
+        snprintf(value, sizeof(value), "%.9g", (double)e.fn());
+        writeSample(out, e.name, nullptr, e.labels, nullptr, value);
+        break;
+    case METRIC_HISTOGRAM:
+        writeHistogram(out, e);
+        break;
+    }
+}
+
+void metrics_write(Print &out) {
+    uint8_t n = entryCount.load(std::memory_order_acquire);
+
+    // One HELP/TYPE block per family, wherever its label variants were registered
+    for (uint8_t i = 0; i < n; i++) {
+        if (familyWritten(i)) continue;
+        writeHeader(out, entries[i]);
+        for (uint8_t j = i; j < n; j++) {
+            if (strcmp(entries[j].name, entries[i].name) == 0) writeEntry(out, entries[j]);
+        }
+    }
+}
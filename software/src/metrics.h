@@ -0,0 +1,108 @@
+/**
+ * @file metrics.h
+ * @brief Counters, gauges and histograms for the /metrics endpoint
+ *
+ * Modules own their metric objects (static, like their status structs)
+ * and register them once at init, like jobs with task_register(): in
+ * setup(), before task_start(). Later registrations are rejected.
+ * Updating a metric is one or a few relaxed atomic operations; names,
+ * labels and numbers are only formatted when /metrics is scraped
+ * (Prometheus text format 0.0.4).
+ *
+ * Counters are 32 bit and wrap around, which Prometheus treats as a
+ * counter reset.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief Maximum number of registered metrics (including label variants)
+ */
+#define METRICS_MAX 64
+
+/**
+ * @brief Maximum number of histogram bucket bounds (+Inf is implicit)
+ */
+#define METRICS_MAX_BUCKETS 10
+
+/**
+ * @struct MetricCounter
+ * @brief Monotonic counter
+ */
+struct MetricCounter {
+    std::atomic<uint32_t> value{0};
+};
+
+/**
+ * @struct MetricGauge
+ * @brief Value that can go up and down
+ */
+struct MetricGauge {
+    std::atomic<int32_t> value{0};
+};
+
+/**
+ * @struct MetricHistogram
+ * @brief Fixed-bucket histogram, bounds are given at registration
+ */
+struct MetricHistogram {
+    const uint32_t* bounds = nullptr;                           ///< Upper bounds (le), ascending
+    uint8_t boundCount = 0;
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1] {};  ///< Non-cumulative, last = +Inf
+    std::atomic<uint32_t> sum{0};                               ///< _count is the sum of all buckets
+};
+
+/**
+ * @brief Gauge computed at scrape time (free heap, PWM duty, ...)
+ */
+typedef float (*MetricGaugeFn)();
+
+inline void metric_inc(MetricCounter &c, uint32_t n = 1) {
+    c.value.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline void metric_set(MetricGauge &g, int32_t v) {
+    g.value.store(v, std::memory_order_relaxed);
+}
+
+inline void metric_observe(MetricHistogram &h, uint32_t v) {
+    uint8_t i = 0;
+    while (i < h.boundCount && v > h.bounds[i]) i++;
+    h.buckets[i].fetch_add(1, std::memory_order_relaxed);
+    h.sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Registers a metric.
+ *
+ * Metrics with the same name form one family with one HELP/TYPE header,
+ * the help and type of the first registration are used. All strings
+ * must be literals. Only in setup(), before task_start().
+ *
+ * @param name   Metric name, e.g. "cover_usb_lines_total"
+ * @param help   One-line description
+ * @param labels Label set without braces, e.g. "task=\"io\"", or nullptr
+ * @return false if the registry is full or the tasks are started
+ */
+bool metrics_register(const char* name, const char* help, const char* labels, MetricCounter &c);
+bool metrics_register(const char* name, const char* help, const char* labels, MetricGauge &g);
+bool metrics_register(const char* name, const char* help, const char* labels, MetricGaugeFn fn);
+bool metrics_registerHistogram(const char* name, const char* help, const char* labels,
+                               MetricHistogram &h, const uint32_t* bounds, uint8_t boundCount);
+
+/**
+ * @brief Registers a histogram with the bucket bounds of a static array.
+ */
+template <size_t N>
+bool metrics_register(const char* name, const char* help, const char* labels,
+                      MetricHistogram &h, const uint32_t (&bounds)[N]) {
+    static_assert(N <= METRICS_MAX_BUCKETS, "too many histogram buckets");
+    return metrics_registerHistogram(name, help, labels, h, bounds, N);
+}
+
+/**
+ * @brief Writes all metrics in Prometheus text format.
+ */
+void metrics_write(Print &out);
@@ -1,22 +1,27 @@
+#define LOG_MODULE LOG_MOD_UI
+
 #include "oled_display.h"
 #include "web_log.h"
 #include "time_manager.h"
+#include "task_manager.h"
 
 // Instantiate display
 Adafruit_SSD1306 display(OLED_WIDTH, OLED_HEIGHT, &Wire, OLED_RESET);
 
 void oled_init() {
     if(!display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS)) {
-        LOG("OLED init failed");
+        LOG_ERROR("OLED init failed");
         return;
     }
-    LOG("OLED init failed");
+    LOG_ERROR("OLED init failed");
     display.clearDisplay();
     display.setTextColor(SSD1306_WHITE);
     display.setTextSize(1);
     display.setCursor(0,0);
     display.println("Initializing...");
     display.display();
+
+    task_register(TASK_UI, "oled", oled_update, OLED_UPDATE_INTERVAL_MS);
 }
 
 void oled_update() {
@@ -37,7 +42,7 @@ void oled_update() {
 
     // --- 12V Spannung ---
     float vin = power_readSupplyVoltage();
-    WandererStatus cover = *usb_manager_get_parsed_status();
+    WandererStatus cover = usb_manager_get_parsed_status();
 
     display.setCursor(0, y);
     display.printf("12V: %.1fV", vin);
@@ -17,6 +17,8 @@
 
 extern Adafruit_SSD1306 display;
 
+#define OLED_UPDATE_INTERVAL_MS 500
+
 void oled_init();
 void oled_update();
 void drawWifiIcon(int x, int y, bool connected);
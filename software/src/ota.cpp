@@ -5,28 +5,49 @@
  * OTA is only started if WiFi is correctly initialized.
  */
 
+#define LOG_MODULE LOG_MOD_OTA
+
 #include "ota.h"
 #include "config_manager.h"
 #include <ArduinoOTA.h>
 #include <WiFi.h>
 #include "web_log.h"
+#include "task_manager.h"
+#include <atomic>
 
 static bool otaStarted = false;
+static std::atomic<bool> passwordChanged(false);   // set by the web server task
+
+/**
+ * @brief Sets the password from the current configuration.
+ */
+static void applyPassword() {
+    ConfigData config = config_get();
+    ArduinoOTA.setPassword(config.otaPassword);
+}
+
+static void onPasswordChanged(const ConfigData &) {
+    passwordChanged.store(true, std::memory_order_relaxed);
+}
 
 /**
  * @brief Initializes OTA update functionality.
  *
  * Sets the OTA hostname and password, and starts the ArduinoOTA service.
  * OTA will only be started if WiFi is initialized in station mode.
+ * Registers handleOTA() with the network task.
  */
 void initOTA() {
+    task_register(TASK_NET, "ota", handleOTA, OTA_HANDLE_INTERVAL_MS);
+    config_subscribe("ota_password", onPasswordChanged);
+
     if (WiFi.getMode() != WIFI_STA) {
-        LOG("OTA skipped: WiFi not ready");
+        LOG_WARN("OTA skipped: WiFi not ready");
         return;
     }
 
     ArduinoOTA.setHostname("cover-controller");
-    ArduinoOTA.setPassword(otaPassword.c_str());
+    applyPassword();
     ArduinoOTA.begin();
 
     LOG("OTA ready");
@@ -36,18 +57,20 @@ void initOTA() {
  * @brief Handles OTA update requests.
  *
  * Starts the OTA service if WiFi is connected and not already started.
- * Should be called regularly in the main loop to process OTA events.
+ * Runs every OTA_HANDLE_INTERVAL_MS as a network task job.
  */
 void handleOTA() {
     if (!otaStarted && WiFi.status() == WL_CONNECTED) {
         ArduinoOTA.setHostname("cover-controller");
-        ArduinoOTA.setPassword(otaPassword.c_str());
+        applyPassword();
         ArduinoOTA.begin();
         otaStarted = true;
         LOG("OTA ready");
     }
 
     if (otaStarted) {
+        // A new ota_password applies to the next update
+        if (passwordChanged.exchange(false, std::memory_order_relaxed)) applyPassword();
         ArduinoOTA.handle();
     }
 }
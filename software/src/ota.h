@@ -10,8 +10,10 @@
 
 #include <Arduino.h>
 
-// OTA configuration
-extern String otaPassword;
+/**
+ * @brief Polling interval of the OTA handler (ms)
+ */
+#define OTA_HANDLE_INTERVAL_MS 250
 
 void initOTA();
 void handleOTA();
@@ -3,6 +3,8 @@
 // --- ANALOG INPUTS ---
 const uint8_t PIN_POT_LIGHT        = 1;
 const uint8_t PIN_VIN_12V_SENSE    = 4;
+const uint8_t PIN_NTC_LENS1        = 3;
+const uint8_t PIN_NTC_LENS2        = 6;
 
 // --- DIGITAL OUTPUTS ---
 const uint8_t PIN_LED_STATUS       = 2;
@@ -29,6 +31,9 @@ const uint8_t PIN_SD_CS            = 46;
 const uint8_t PIN_USB_D_MINUS      = 19;
 const uint8_t PIN_USB_D_PLUS       = 20;
 
+// --- 1-WIRE BUS ---
+const uint8_t PIN_ONEWIRE          = 17;
+
 // --- I2C BUS ---
 const uint8_t PIN_I2C_SDA          = 9;
 const uint8_t PIN_I2C_SCL          = 10;
@@ -58,6 +63,8 @@ void initPins() {
 
     // I2C pins → handled by Wire.begin()
 
+    // 1-Wire pin → handled by OneWire
+
     // Optional: set LEDs off at startup
     digitalWrite(PIN_LED_STATUS, LOW);
     digitalWrite(PIN_LED_WLAN, LOW);
@@ -6,6 +6,8 @@
 // --- ANALOG INPUTS ---
 extern const uint8_t PIN_POT_LIGHT;        // GPIO1
 extern const uint8_t PIN_VIN_12V_SENSE;    // GPIO4
+extern const uint8_t PIN_NTC_LENS1;        // GPIO3 (optional lens probe)
+extern const uint8_t PIN_NTC_LENS2;        // GPIO6 (optional lens probe)
 
 // --- DIGITAL OUTPUTS ---
 extern const uint8_t PIN_LED_STATUS;       // GPIO2
@@ -32,6 +34,9 @@ extern const uint8_t PIN_SD_CS;            // GPIO46
 extern const uint8_t PIN_USB_D_MINUS;      // GPIO19
 extern const uint8_t PIN_USB_D_PLUS;       // GPIO20
 
+// --- 1-WIRE BUS (optional DS18B20 lens probes) ---
+extern const uint8_t PIN_ONEWIRE;          // GPIO17
+
 // --- I2C BUS ---
 extern const uint8_t PIN_I2C_SDA;          // GPIO9
 extern const uint8_t PIN_I2C_SCL;          // GPIO10
@@ -0,0 +1,211 @@
+#define LOG_MODULE LOG_MOD_POWER
+
+#include "power_budget.h"
+#include "config_manager.h"
+#include "web_log.h"
+#include "task_manager.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include <math.h>
+#include <atomic>
+
+#define SHED_LEVELS 3
+
+/**
+ * @brief Shedding order, the first entry is switched off first
+ */
+static const PowerOutput SHED_ORDER[SHED_LEVELS] = { POWER_PANEL, POWER_DEW2, POWER_DEW1 };
+
+static const char* const OUTPUT_NAMES[POWER_OUTPUT_COUNT] = { "heater 1", "heater 2", "panel" };
+
+/**
+ * @enum LimitState
+ * @brief Logged state of one output
+ */
+enum LimitState : uint8_t {
+    LIMIT_NONE,
+    LIMIT_BUDGET,       ///< Reduced or off for the budget
+    LIMIT_SHED          ///< Off for low voltage
+};
+
+// Configuration, set by the web server task
+static std::atomic<uint8_t> ratedWatts[POWER_OUTPUT_COUNT];
+static std::atomic<uint8_t> budgetWatts(0);
+static std::atomic<uint8_t> lowDeciVolt(0);
+static std::atomic<uint8_t> criticalDeciVolt(0);
+static TaskJobId budgetJob = TASK_JOB_INVALID;
+
+// Sensor task only
+static PowerBudgetStatus status;
+static LimitState limitState[POWER_OUTPUT_COUNT];
+static uint16_t loggedLimit[POWER_OUTPUT_COUNT] = { POWER_DUTY_FULL, POWER_DUTY_FULL, POWER_DUTY_FULL };
+static uint32_t levelChangedMs = 0;
+static uint32_t lowSinceMs = 0;      // start of the current period below low_voltage
+static uint32_t okSinceMs = 0;       // start of the current period above low_voltage + hysteresis
+static bool filterStarted = false;
+
+static Snapshot<PowerBudgetStatus> published;   // read by all tasks
+
+// ---------------- Metrics ----------------
+static MetricGauge shedLevelGauge;
+static MetricCounter limitEvents;
+
+static float supplyVoltage() { return published.read().voltage; }
+static float dew1Watts() { return published.read().watts[POWER_DEW1]; }
+static float dew2Watts() { return published.read().watts[POWER_DEW2]; }
+static float panelWatts() { return published.read().watts[POWER_PANEL]; }
+
+// ---------------- Configuration ----------------
+static void onBudgetChanged(const ConfigData &c)
+{
+    ratedWatts[POWER_DEW1].store(c.dew1Watts, std::memory_order_relaxed);
+    ratedWatts[POWER_DEW2].store(c.dew2Watts, std::memory_order_relaxed);
+    ratedWatts[POWER_PANEL].store(c.panelWatts, std::memory_order_relaxed);
+    budgetWatts.store(c.powerBudget, std::memory_order_relaxed);
+    lowDeciVolt.store(c.lowVoltage, std::memory_order_relaxed);
+    criticalDeciVolt.store(c.criticalVoltage, std::memory_order_relaxed);
+    task_trigger(budgetJob);
+}
+
+void powerbudget_init()
+{
+    budgetJob = task_register(TASK_SENSOR, "budget", powerbudget_update, POWER_BUDGET_INTERVAL_MS);
+
+    static const char* const KEYS[] = {
+        "dew1_watts", "dew2_watts", "panel_watts", "power_budget", "low_voltage", "critical_voltage"
+    };
+    for (const char* key : KEYS) config_subscribe(key, onBudgetChanged);
+
+    metrics_register("cover_supply_voltage_volts", "Filtered 12 V supply voltage", nullptr, supplyVoltage);
+    metrics_register("cover_power_output_watts", "Estimated power of an output", "output=\"dew1\"", dew1Watts);
+    metrics_register("cover_power_output_watts", "Estimated power of an output", "output=\"dew2\"", dew2Watts);
+    metrics_register("cover_power_output_watts", "Estimated power of an output", "output=\"panel\"", panelWatts);
+    metrics_register("cover_power_shed_level", "Outputs switched off for low voltage", nullptr, shedLevelGauge);
+    metrics_register("cover_power_limit_changes_total", "Output limits changed by the power budget", nullptr, limitEvents);
+}
+
+// ---------------- Decision ----------------
+
+/**
+ * @brief Low-voltage state machine, returns the new shed level.
+ *
+ * One step per POWER_SHED_DELAY_MS below low_voltage; one step back after
+ * POWER_RESTORE_DELAY_MS above low_voltage + hysteresis.
+ */
+static uint8_t shedLevel(float v, uint32_t now)
+{
+    uint8_t level = status.shedLevel;
+    float low = lowDeciVolt.load(std::memory_order_relaxed) / 10.0f;
+    float critical = criticalDeciVolt.load(std::memory_order_relaxed) / 10.0f;
+
+    if (v < POWER_SUPPLY_MIN_V) return 0;      // no 12 V supply, nothing to protect
+
+    if (critical > 0 && v < critical) return SHED_LEVELS;
+
+    bool isLow = low > 0 && v < low;
+    bool isOk = v >= low + POWER_RESTORE_HYSTERESIS;
+    if (!isLow) lowSinceMs = now;
+    if (!isOk) okSinceMs = now;
+
+    if (isLow && level < SHED_LEVELS &&
+        now - lowSinceMs >= POWER_SHED_DELAY_MS && now - levelChangedMs >= POWER_SHED_DELAY_MS) {
+        level++;
+    } else if (isOk && level > 0 &&
+               now - okSinceMs >= POWER_RESTORE_DELAY_MS && now - levelChangedMs >= POWER_RESTORE_DELAY_MS) {
+        level--;
+    }
+    return level;
+}
+
+/**
+ * @brief Applies a limit; a change of its state is logged and counted.
+ *
+ * A budget limit is logged again only if it moved by more than 5 %
+ * since it was last logged (it follows the requested duties).
+ */
+static void setLimit(PowerOutput out, uint16_t limit, LimitState state, float v)
+{
+    power_setLimit(out, limit);
+
+    bool moved = abs((int32_t)limit - (int32_t)loggedLimit[out]) > (int32_t)(POWER_DUTY_FULL / 20);
+    if (state == limitState[out] && !(state == LIMIT_BUDGET && moved)) return;
+
+    switch (state) {
+    case LIMIT_SHED:
+        LOG_WARN("power: %s off, supply %.2f V", OUTPUT_NAMES[out], v);
+        break;
+    case LIMIT_BUDGET:
+        LOGF("power: %s limited to %.0f%% by budget %u W", OUTPUT_NAMES[out],
+             limit * 100.0f / POWER_DUTY_FULL, budgetWatts.load(std::memory_order_relaxed));
+        break;
+    case LIMIT_NONE:
+        LOGF("power: %s restored", OUTPUT_NAMES[out]);
+        break;
+    }
+    metric_inc(limitEvents);
+    limitState[out] = state;
+    loggedLimit[out] = limit;
+}
+
+void powerbudget_update()
+{
+    uint32_t now = millis();
+    float raw = power_readSupplyVoltage();
+    // The filter starts with the first reading of a supply (not before the first ADC sample)
+    status.voltage = filterStarted ? status.voltage + POWER_VOLTAGE_FILTER * (raw - status.voltage) : raw;
+    filterStarted = raw >= POWER_SUPPLY_MIN_V;
+    float v = status.voltage;
+
+    // --- Low voltage ---
+    uint8_t level = shedLevel(v, now);
+    if (level != status.shedLevel) {
+        if (level > status.shedLevel) LOG_WARN("power: supply %.2f V, shed level %u", v, level);
+        else LOGF("power: supply %.2f V, shed level %u", v, level);
+        status.shedLevel = level;
+        levelChangedMs = now;
+        metric_set(shedLevelGauge, level);
+    }
+
+    // --- Budget, granted in reverse shedding order ---
+    // Resistive loads: power at 100 % scales with (V / 12 V)²
+    float scale = v >= POWER_SUPPLY_MIN_V ? (v / 12.0f) * (v / 12.0f) : 1.0f;
+    uint8_t budget = budgetWatts.load(std::memory_order_relaxed);
+    float remaining = budget > 0 ? (float)budget : INFINITY;
+
+    status.totalWatts = 0;
+    status.budgetLimited = false;
+    for (int8_t i = SHED_LEVELS - 1; i >= 0; i--) {
+        PowerOutput out = SHED_ORDER[i];
+        float full = ratedWatts[out].load(std::memory_order_relaxed) * scale;
+        float requested = full * power_getTargetDuty(out) / POWER_DUTY_FULL;
+
+        if (i < level) {
+            setLimit(out, 0, LIMIT_SHED, v);
+            status.watts[out] = 0;
+            continue;
+        }
+
+        if (requested <= remaining) {
+            setLimit(out, POWER_DUTY_FULL, LIMIT_NONE, v);
+            status.watts[out] = requested;
+            remaining -= requested;
+            continue;
+        }
+
+        // Heaters get what is left, the panel all or nothing
+        uint16_t limit = 0;
+        if (out != POWER_PANEL && full > 0) limit = (uint16_t)(POWER_DUTY_FULL * remaining / full);
+        setLimit(out, limit, LIMIT_BUDGET, v);
+        status.watts[out] = full * limit / POWER_DUTY_FULL;
+        remaining -= status.watts[out];
+        status.budgetLimited = true;
+    }
+
+    for (uint8_t i = 0; i < POWER_OUTPUT_COUNT; i++) status.totalWatts += status.watts[i];
+    published.publish(status);
+}
+
+PowerBudgetStatus powerbudget_getStatus()
+{
+    return published.read();
+}
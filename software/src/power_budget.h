@@ -0,0 +1,73 @@
+/**
+ * @file power_budget.h
+ * @brief Supply voltage watch and power budget of the 12 V outputs
+ *
+ * A job of the sensor task filters the 12 V sense and estimates the power
+ * of each output from its duty and rated power (config.txt dew1_watts,
+ * dew2_watts, panel_watts; resistive loads, so P = rated * duty * (V/12)²).
+ *
+ * Outputs are limited with power_setLimit() in a fixed priority order,
+ * shed first: flat panel, heater 2, heater 1.
+ *  - Low voltage: below low_voltage one more output is switched off
+ *    every POWER_SHED_DELAY_MS; after the voltage stays above
+ *    low_voltage + POWER_RESTORE_HYSTERESIS for POWER_RESTORE_DELAY_MS
+ *    the last one is restored. Below critical_voltage all are switched
+ *    off at once.
+ *  - Budget: the requested power is granted in reverse shedding order
+ *    until power_budget is used up. Heaters may get part of their duty,
+ *    the panel only all or nothing (a dimmed panel would spoil flats).
+ *
+ * The requested duties are not changed: an output returns to its
+ * requested power as soon as the limit is lifted. Every change of a
+ * limit is logged (module "power") and counted in the metrics.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "power_control.h"
+
+#define POWER_BUDGET_INTERVAL_MS 500
+
+/**
+ * @brief Low-voltage timing: next shed step / restore step
+ */
+#define POWER_SHED_DELAY_MS     2000
+#define POWER_RESTORE_DELAY_MS  30000
+#define POWER_RESTORE_HYSTERESIS 0.3f   ///< V
+
+/**
+ * @brief Filter constant of the supply voltage (per update)
+ */
+#define POWER_VOLTAGE_FILTER 0.2f
+
+/**
+ * @brief Below this the board runs without 12 V (USB only), no voltage watch
+ */
+#define POWER_SUPPLY_MIN_V 5.0f
+
+/**
+ * @struct PowerBudgetStatus
+ * @brief Last decision of the power budget
+ */
+struct PowerBudgetStatus {
+    float voltage;                          ///< Filtered supply voltage (V)
+    float watts[POWER_OUTPUT_COUNT];        ///< Estimated power after the limits (W)
+    float totalWatts;
+    uint8_t shedLevel;                      ///< Outputs switched off for low voltage (0..3)
+    bool budgetLimited;                     ///< At least one output is limited by the budget
+};
+
+/**
+ * @brief Registers the job, the configuration listeners and the metrics.
+ */
+void powerbudget_init();
+
+/**
+ * @brief Job of the sensor task.
+ */
+void powerbudget_update();
+
+/**
+ * @brief Consistent copy of the last decision (any task).
+ */
+PowerBudgetStatus powerbudget_getStatus();
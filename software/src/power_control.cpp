@@ -1,93 +1,257 @@
-#include "power_control.h"
-
-/**
- * @brief Initializes all power-related GPIOs and PWM channels.
- */
-void power_init()
-{
-    // --- Supply voltage sense ---
-    pinMode(PIN_VIN_12V_SENSE, INPUT);
-
-    // --- PWM for Dew Heater 1 ---
-    ledcSetup(PWM_CHANNEL_DEW1, PWM_FREQUENCY, PWM_RESOLUTION);
-    ledcAttachPin(PIN_DEW1_OUT, PWM_CHANNEL_DEW1);
-    ledcWrite(PWM_CHANNEL_DEW1, 0);
-
-    // --- PWM for Dew Heater 2 ---
-    ledcSetup(PWM_CHANNEL_DEW2, PWM_FREQUENCY, PWM_RESOLUTION);
-    ledcAttachPin(PIN_DEW2_OUT, PWM_CHANNEL_DEW2);
-    ledcWrite(PWM_CHANNEL_DEW2, 0);
-
-    // --- Flat Panel Output ---
-    pinMode(PIN_PAN_OUT, OUTPUT);
-    digitalWrite(PIN_PAN_OUT, LOW);
-}
-
-/**
- * @brief Reads the 12V supply voltage using the analog input.
- */
-float power_readSupplyVoltage()
-{
-    const float dividerFactor = (100000.0f + 22000.0f) / 22000.0f; // 5.545
-    const float adcMax = 4095.0f;
-    const float vRef = 3.3f;
-
-    int raw = analogRead(PIN_VIN_12V_SENSE);
-    return (raw / adcMax) * vRef * dividerFactor;
-}
-
-/**
- * @brief Sets the PWM level for Dew Heater 1.
- */
-void power_setDew1(int percent)
-{
-    percent = constrain(percent, 0, 100);
-    uint16_t pwm = (percent * ((1 << PWM_RESOLUTION) - 1)) / 100;
-    ledcWrite(PWM_CHANNEL_DEW1, pwm);
-}
-
-/**
- * @brief Sets the PWM level for Dew Heater 2.
- */
-void power_setDew2(int percent)
-{
-    percent = constrain(percent, 0, 100);
-    uint16_t pwm = (percent * ((1 << PWM_RESOLUTION) - 1)) / 100;
-    ledcWrite(PWM_CHANNEL_DEW2, pwm);
-}
-
-/**
- * @brief Returns the current PWM level of Dew Heater 1.
- */
-int power_getDew1Level()
-{
-    uint32_t raw = ledcRead(PWM_CHANNEL_DEW1);
-    int percent = (raw * 100) / ((1 << PWM_RESOLUTION) - 1);
-    return constrain(percent, 0, 100);
-}
-
-/**
- * @brief Returns the current PWM level of Dew Heater 2.
- */
-int power_getDew2Level()
-{
-    uint32_t raw = ledcRead(PWM_CHANNEL_DEW2);
-    int percent = (raw * 100) / ((1 << PWM_RESOLUTION) - 1);
-    return constrain(percent, 0, 100);
-}
-
-/**
- * @brief Enables or disables the flat panel output.
- */
-void power_setPanel(bool on)
-{
-    digitalWrite(PIN_PAN_OUT, on ? HIGH : LOW);
-}
-
-/**
- * @brief Returns the current state of the flat panel output.
- */
-bool power_isPanelOn()
-{
-    return digitalRead(PIN_PAN_OUT) == HIGH;
-}
+#include "power_control.h"
+#include "config_manager.h"
+#include "task_manager.h"
+#include "analog_input.h"
+#include <driver/ledc.h>
+#include <atomic>
+
+static_assert((80000000UL >> PWM_RESOLUTION) >= PWM_FREQUENCY, "PWM_RESOLUTION too high for PWM_FREQUENCY");
+
+#define PWM_COUNTS (1UL << PWM_RESOLUTION)   // LEDC duty of 100 %
+
+/**
+ * @struct PowerChannel
+ * @brief State of one output
+ */
+struct PowerChannel {
+    const uint8_t* pin;
+    ledc_channel_t channel;
+    std::atomic<uint16_t> target;   ///< Set by any task
+    std::atomic<uint16_t> limit;    ///< Upper limit of target, set by the power budget
+    std::atomic<uint16_t> applied;  ///< Written by the job
+    std::atomic<uint8_t> slew;      ///< %/s, 0 = no limit
+    uint32_t residue;               ///< Dither accumulator (Q16 counts), job only
+};
+
+static PowerChannel channels[POWER_OUTPUT_COUNT] = {
+    { &PIN_DEW1_OUT, (ledc_channel_t)PWM_CHANNEL_DEW1,  {0}, {POWER_DUTY_FULL}, {0}, {0}, 0 },
+    { &PIN_DEW2_OUT, (ledc_channel_t)PWM_CHANNEL_DEW2,  {0}, {POWER_DUTY_FULL}, {0}, {0}, 0 },
+    { &PIN_PAN_OUT,  (ledc_channel_t)PWM_CHANNEL_PANEL, {0}, {POWER_DUTY_FULL}, {0}, {0}, 0 },
+};
+
+static TaskJobId powerJob = TASK_JOB_INVALID;
+static bool running = false;        // job is re-scheduling itself
+static uint32_t lastRunMs = 0;
+
+// ---------------- Configuration ----------------
+static void onSlewChanged(const ConfigData &c)
+{
+    power_setSlewRate(POWER_DEW1, c.dewSlewRate);
+    power_setSlewRate(POWER_DEW2, c.dewSlewRate);
+    power_setSlewRate(POWER_PANEL, c.panelSlewRate);
+}
+
+/**
+ * @brief Initializes all power-related GPIOs and PWM channels.
+ */
+void power_init()
+{
+    // --- One timer for all outputs, so their periods are in phase ---
+    ledc_timer_config_t timer = {};
+    timer.speed_mode = LEDC_LOW_SPEED_MODE;
+    timer.duty_resolution = (ledc_timer_bit_t)PWM_RESOLUTION;
+    timer.timer_num = (ledc_timer_t)PWM_TIMER;
+    timer.freq_hz = PWM_FREQUENCY;
+    timer.clk_cfg = LEDC_AUTO_CLK;
+    ledc_timer_config(&timer);
+
+    // --- Dew Heater 1/2 and Flat Panel, all off ---
+    for (uint8_t i = 0; i < POWER_OUTPUT_COUNT; i++) {
+        ledc_channel_config_t ch = {};
+        ch.gpio_num = *channels[i].pin;
+        ch.speed_mode = LEDC_LOW_SPEED_MODE;
+        ch.channel = channels[i].channel;
+        ch.intr_type = LEDC_INTR_DISABLE;
+        ch.timer_sel = (ledc_timer_t)PWM_TIMER;
+        ch.duty = 0;
+        ch.hpoint = 0;
+        ledc_channel_config(&ch);
+    }
+
+    powerJob = task_register(TASK_IO, "power", power_update, 0);
+    config_subscribe("dew_slew_rate", onSlewChanged);
+    config_subscribe("panel_slew_rate", onSlewChanged);
+}
+
+/**
+ * @brief Returns the 12V supply voltage from the sampled analog input.
+ */
+float power_readSupplyVoltage()
+{
+    const float dividerFactor = (100000.0f + 22000.0f) / 22000.0f; // 5.545
+
+    return analog_getMillivolts(ANALOG_SUPPLY) / 1000.0f * dividerFactor;
+}
+
+// ---------------- Fixed-point API ----------------
+
+void power_setDuty(PowerOutput out, uint16_t duty)
+{
+    if (out >= POWER_OUTPUT_COUNT) return;
+    if (channels[out].target.exchange(duty, std::memory_order_relaxed) != duty) {
+        task_trigger(powerJob);
+    }
+}
+
+uint16_t power_getDuty(PowerOutput out)
+{
+    return out < POWER_OUTPUT_COUNT ? channels[out].applied.load(std::memory_order_relaxed) : 0;
+}
+
+uint16_t power_getTargetDuty(PowerOutput out)
+{
+    return out < POWER_OUTPUT_COUNT ? channels[out].target.load(std::memory_order_relaxed) : 0;
+}
+
+void power_setLimit(PowerOutput out, uint16_t limit)
+{
+    if (out >= POWER_OUTPUT_COUNT) return;
+    if (channels[out].limit.exchange(limit, std::memory_order_relaxed) != limit) {
+        task_trigger(powerJob);
+    }
+}
+
+uint16_t power_getLimit(PowerOutput out)
+{
+    return out < POWER_OUTPUT_COUNT ? channels[out].limit.load(std::memory_order_relaxed) : POWER_DUTY_FULL;
+}
+
+void power_setSlewRate(PowerOutput out, uint8_t percentPerS)
+{
+    if (out >= POWER_OUTPUT_COUNT) return;
+    channels[out].slew.store(percentPerS, std::memory_order_relaxed);
+    task_trigger(powerJob);
+}
+
+/**
+ * @brief Moves the applied duty towards the target by at most the slew rate.
+ *
+ * A lower limit is applied at once: shedding must not wait for the ramp.
+ *
+ * @return true if the target is reached
+ */
+static bool slew(PowerChannel &c, uint32_t dtMs)
+{
+    uint16_t limit = c.limit.load(std::memory_order_relaxed);
+    uint16_t target = min(c.target.load(std::memory_order_relaxed), limit);
+    uint16_t applied = min(c.applied.load(std::memory_order_relaxed), limit);
+    uint8_t rate = c.slew.load(std::memory_order_relaxed);
+
+    uint32_t step = rate == 0 ? POWER_DUTY_FULL : (uint32_t)rate * POWER_DUTY_FULL / 100 * dtMs / 1000;
+    if (step == 0) step = 1;
+
+    if (target > applied) applied = ((uint32_t)(target - applied) > step) ? applied + step : target;
+    else if (target < applied) applied = ((uint32_t)(applied - target) > step) ? applied - step : target;
+    c.applied.store(applied, std::memory_order_relaxed);
+    return applied == target;
+}
+
+/**
+ * @brief LEDC duty of this period: integer part plus dithered fraction.
+ *
+ * @return false if there is no fraction (the duty is exact, no dithering needed)
+ */
+static bool ledcCounts(PowerChannel &c, uint32_t &counts)
+{
+    uint64_t q16 = (uint64_t)c.applied.load(std::memory_order_relaxed) * (PWM_COUNTS << 16) / POWER_DUTY_FULL;
+    counts = (uint32_t)(q16 >> 16);
+    uint32_t fraction = (uint32_t)q16 & 0xFFFF;
+
+    c.residue += fraction;
+    if (c.residue >= 0x10000) {
+        c.residue -= 0x10000;
+        counts++;
+    }
+    if (fraction == 0) c.residue = 0;
+    return fraction != 0;
+}
+
+static void writeChannel(const PowerChannel &c, uint32_t counts, uint32_t hpoint)
+{
+    ledc_set_duty_with_hpoint(LEDC_LOW_SPEED_MODE, c.channel, counts, hpoint);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, c.channel);
+}
+
+void power_update()
+{
+    uint32_t now = millis();
+    uint32_t dt = running ? now - lastRunMs : POWER_UPDATE_INTERVAL_MS;
+    lastRunMs = now;
+
+    bool again = false;
+    uint32_t counts[POWER_OUTPUT_COUNT];
+    for (uint8_t i = 0; i < POWER_OUTPUT_COUNT; i++) {
+        if (!slew(channels[i], dt)) again = true;
+        if (ledcCounts(channels[i], counts[i])) again = true;
+    }
+
+    // Heater 2 starts where heater 1 ends, as far as the period allows
+    uint32_t hpoint2 = min(counts[POWER_DEW1], (uint32_t)(PWM_COUNTS - counts[POWER_DEW2]));
+    if (hpoint2 >= PWM_COUNTS) hpoint2 = PWM_COUNTS - 1;     // heater 2 off, any valid hpoint
+    writeChannel(channels[POWER_DEW1], counts[POWER_DEW1], 0);
+    writeChannel(channels[POWER_DEW2], counts[POWER_DEW2], hpoint2);
+    writeChannel(channels[POWER_PANEL], counts[POWER_PANEL], 0);
+
+    running = again;
+    if (again) task_runIn(powerJob, POWER_UPDATE_INTERVAL_MS);
+}
+
+// ---------------- Percent API ----------------
+
+static inline uint16_t percentToDuty(int percent)
+{
+    return (uint16_t)((constrain(percent, 0, 100) * POWER_DUTY_FULL + 50) / 100);
+}
+
+static inline int dutyToPercent(uint16_t duty)
+{
+    return (int)(((uint32_t)duty * 100 + POWER_DUTY_FULL / 2) / POWER_DUTY_FULL);
+}
+
+/**
+ * @brief Sets the PWM level for Dew Heater 1.
+ */
+void power_setDew1(int percent)
+{
+    power_setDuty(POWER_DEW1, percentToDuty(percent));
+}
+
+/**
+ * @brief Sets the PWM level for Dew Heater 2.
+ */
+void power_setDew2(int percent)
+{
+    power_setDuty(POWER_DEW2, percentToDuty(percent));
+}
+
+/**
+ * @brief Returns the current PWM level of Dew Heater 1.
+ */
+int power_getDew1Level()
+{
+    return dutyToPercent(power_getDuty(POWER_DEW1));
+}
+
+/**
+ * @brief Returns the current PWM level of Dew Heater 2.
+ */
+int power_getDew2Level()
+{
+    return dutyToPercent(power_getDuty(POWER_DEW2));
+}
+
+/**
+ * @brief Enables or disables the flat panel output.
+ */
+void power_setPanel(bool on)
+{
+    power_setDuty(POWER_PANEL, on ? POWER_DUTY_FULL : 0);
+}
+
+/**
+ * @brief Returns the current state of the flat panel output.
+ */
+bool power_isPanelOn()
+{
+    return power_getTargetDuty(POWER_PANEL) != 0;
+}
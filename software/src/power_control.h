@@ -1,82 +1,179 @@
-#pragma once
-
-#include <Arduino.h>
-#include "pins.h"
-
-// --- PWM configuration (must match your .cpp setup) ---
-#ifndef PWM_FREQUENCY
-#define PWM_FREQUENCY 20000   // 20 kHz recommended for heaters
-#endif
-
-#ifndef PWM_RESOLUTION
-#define PWM_RESOLUTION 10     // 10-bit resolution (0..1023)
-#endif
-
-// PWM channels (must match your .cpp)
-#ifndef PWM_CHANNEL_DEW1
-#define PWM_CHANNEL_DEW1 5
-#endif
-
-#ifndef PWM_CHANNEL_DEW2
-#define PWM_CHANNEL_DEW2 6
-#endif
-
-/**
- * @brief Initializes all power-related GPIOs and PWM channels.
- *
- * - Configures VIN sense pin
- * - Initializes PWM for Dew Heater 1 and 2
- * - Initializes Flat Panel 12V output
- */
-void power_init();
-
-/**
- * @brief Reads the 12V supply voltage using the analog input.
- *
- * Uses the voltage divider 100k / 22k.
- *
- * @return float Voltage in volts.
- */
-float power_readSupplyVoltage();
-
-/**
- * @brief Sets the PWM level for Dew Heater 1.
- *
- * @param percent 0..100 (%)
- */
-void power_setDew1(int percent);
-
-/**
- * @brief Sets the PWM level for Dew Heater 2.
- *
- * @param percent 0..100 (%)
- */
-void power_setDew2(int percent);
-
-/**
- * @brief Returns the current PWM level of Dew Heater 1.
- *
- * @return int 0..100 (%)
- */
-int power_getDew1Level();
-
-/**
- * @brief Returns the current PWM level of Dew Heater 2.
- *
- * @return int 0..100 (%)
- */
-int power_getDew2Level();
-
-/**
- * @brief Enables or disables the flat panel 12V output.
- *
- * @param on true = enable, false = disable
- */
-void power_setPanel(bool on);
-
-/**
- * @brief Returns the current state of the flat panel 12V output.
- *
- * @return true if enabled
- */
-bool power_isPanelOn();
+/**
+ * @file power_control.h
+ * @brief 12 V outputs (dew heaters, flat panel) and supply voltage
+ *
+ * All three outputs are PWM channels on one LEDC timer, so their periods
+ * are in phase:
+ *  - The duty is a 16-bit fixed-point value (POWER_DUTY_FULL = 100 %).
+ *    The LEDC resolution is lower (PWM_RESOLUTION); the remaining bits
+ *    are dithered over successive updates, so the average is exact.
+ *  - A new duty is approached with a configurable slew rate per output
+ *    (config.txt dew_slew_rate / panel_slew_rate) instead of a step.
+ *  - Heater 2 switches on when heater 1 switches off (LEDC hpoint), so
+ *    the on-periods only overlap if the duties add up to more than 100 %.
+ *  - Each output has an upper limit (power_setLimit(), used by the power
+ *    budget) that caps the target without changing it. A lower limit
+ *    takes effect at once, without the slew rate.
+ *
+ * The setters only store the target; the LEDC registers are written by a
+ * job of the IO task.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "pins.h"
+
+// --- PWM configuration ---
+#ifndef PWM_FREQUENCY
+#define PWM_FREQUENCY 20000   // 20 kHz recommended for heaters
+#endif
+
+#ifndef PWM_RESOLUTION
+#define PWM_RESOLUTION 11     // highest resolution at 20 kHz (80 MHz / 2^11 >= 20 kHz)
+#endif
+
+// LEDC timer and channels of the power outputs (the LEDs use channels 2..4 via ledcSetup)
+#ifndef PWM_TIMER
+#define PWM_TIMER 3
+#endif
+
+#ifndef PWM_CHANNEL_DEW1
+#define PWM_CHANNEL_DEW1 5
+#endif
+
+#ifndef PWM_CHANNEL_DEW2
+#define PWM_CHANNEL_DEW2 6
+#endif
+
+#ifndef PWM_CHANNEL_PANEL
+#define PWM_CHANNEL_PANEL 7
+#endif
+
+/**
+ * @brief Duty of a fully switched on output (Q16)
+ */
+#define POWER_DUTY_FULL 65535U
+
+/**
+ * @brief Update interval while an output is ramping or dithering (ms)
+ */
+#define POWER_UPDATE_INTERVAL_MS 20
+
+/**
+ * @enum PowerOutput
+ * @brief Switched 12 V outputs
+ */
+enum PowerOutput : uint8_t {
+    POWER_DEW1 = 0,
+    POWER_DEW2,
+    POWER_PANEL,
+    POWER_OUTPUT_COUNT
+};
+
+/**
+ * @brief Initializes all power-related GPIOs and PWM channels.
+ *
+ * - Initializes the LEDC timer and the channels of all outputs
+ * - Registers the output job with the IO task
+ */
+void power_init();
+
+/**
+ * @brief Returns the 12V supply voltage.
+ *
+ * Uses the voltage divider 100k / 22k. The value is the filtered,
+ * calibrated one cached by analog_input, no conversion is started.
+ *
+ * @return float Voltage in volts.
+ */
+float power_readSupplyVoltage();
+
+/**
+ * @brief Sets the target duty of an output (any task).
+ *
+ * @param out  Output
+ * @param duty 0..POWER_DUTY_FULL
+ */
+void power_setDuty(PowerOutput out, uint16_t duty);
+
+/**
+ * @brief Returns the duty applied now (may still be ramping to the target).
+ *
+ * @return 0..POWER_DUTY_FULL
+ */
+uint16_t power_getDuty(PowerOutput out);
+
+/**
+ * @brief Returns the duty last set with power_setDuty().
+ */
+uint16_t power_getTargetDuty(PowerOutput out);
+
+/**
+ * @brief Caps the duty of an output (any task); the target is kept and
+ *        applied again when the limit is raised.
+ *
+ * @param out   Output
+ * @param limit 0..POWER_DUTY_FULL (POWER_DUTY_FULL = no limit)
+ */
+void power_setLimit(PowerOutput out, uint16_t limit);
+
+/**
+ * @brief Returns the limit set with power_setLimit().
+ */
+uint16_t power_getLimit(PowerOutput out);
+
+/**
+ * @brief Limits how fast the duty of an output changes.
+ *
+ * @param out          Output
+ * @param percentPerS  Maximum change in % per second, 0 = no limit
+ */
+void power_setSlewRate(PowerOutput out, uint8_t percentPerS);
+
+/**
+ * @brief Job of the IO task: ramps, dithers and writes the outputs.
+ */
+void power_update();
+
+/**
+ * @brief Sets the PWM level for Dew Heater 1.
+ *
+ * @param percent 0..100 (%)
+ */
+void power_setDew1(int percent);
+
+/**
+ * @brief Sets the PWM level for Dew Heater 2.
+ *
+ * @param percent 0..100 (%)
+ */
+void power_setDew2(int percent);
+
+/**
+ * @brief Returns the current PWM level of Dew Heater 1.
+ *
+ * @return int 0..100 (%)
+ */
+int power_getDew1Level();
+
+/**
+ * @brief Returns the current PWM level of Dew Heater 2.
+ *
+ * @return int 0..100 (%)
+ */
+int power_getDew2Level();
+
+/**
+ * @brief Enables or disables the flat panel 12V output.
+ *
+ * @param on true = enable, false = disable
+ */
+void power_setPanel(bool on);
+
+/**
+ * @brief Returns the current state of the flat panel 12V output.
+ *
+ * @return true if enabled
+ */
+bool power_isPanelOn();
@@ -0,0 +1,86 @@
+/**
+ * @file profiler.cpp
+ * @brief Job run-time statistics implementation
+ */
+
+#include "profiler.h"
+#include <string.h>
+
+/**
+ * @brief Bucket index of a duration
+ *
+ * Values below PROF_SUB_BUCKETS units get one bucket each, above that
+ * every power of two is split into PROF_SUB_BUCKETS linear buckets.
+ */
+static inline uint8_t bucketOf(uint32_t cycles) {
+    uint32_t v = cycles >> PROF_UNIT_SHIFT;
+    if (v < PROF_SUB_BUCKETS) return (uint8_t)v;
+
+    uint8_t msb = 31 - __builtin_clz(v);
+    uint8_t sub = (v >> (msb - 2)) & (PROF_SUB_BUCKETS - 1);
+    uint16_t index = (msb - 1) * PROF_SUB_BUCKETS + sub;
+    return index < PROF_BUCKETS ? index : PROF_BUCKETS - 1;
+}
+
+/**
+ * @brief Largest duration (cycles) that falls into a bucket
+ */
+static uint32_t bucketLimit(uint8_t index) {
+    uint64_t upper;     // first unit value of the next bucket
+    if (index < PROF_SUB_BUCKETS) {
+        upper = index + 1;
+    } else {
+        uint8_t msb = index / PROF_SUB_BUCKETS + 1;
+        uint8_t sub = index % PROF_SUB_BUCKETS;
+        upper = (uint64_t)(PROF_SUB_BUCKETS + sub + 1) << (msb - 2);
+    }
+    upper <<= PROF_UNIT_SHIFT;
+    return upper > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)(upper - 1);
+}
+
+void prof_reset(ProfStats &p) {
+    memset(&p, 0, sizeof(p));
+    p.minCycles = 0xFFFFFFFFUL;
+}
+
+void prof_record(ProfStats &p, uint32_t cycles, uint32_t budgetCycles) {
+    p.count++;
+    p.sumCycles += cycles;
+    if (cycles < p.minCycles) p.minCycles = cycles;
+    if (cycles > p.maxCycles) p.maxCycles = cycles;
+    if (budgetCycles > 0 && cycles > budgetCycles) p.overruns++;
+
+    uint8_t b = bucketOf(cycles);
+    if (p.buckets[b] == 0xFFFF) {
+        for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+            p.buckets[i] >>= 1;
+        }
+    }
+    p.buckets[b]++;
+}
+
+uint32_t prof_average(const ProfStats &p) {
+    return p.count > 0 ? (uint32_t)(p.sumCycles / p.count) : 0;
+}
+
+uint32_t prof_percentile(const ProfStats &p, uint16_t permille) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+        total += p.buckets[i];
+    }
+    if (total == 0) return 0;
+
+    // Rank of the sample, rounded up (p99 of 100 samples = 99th sample)
+    uint32_t rank = (uint32_t)(((uint64_t)total * permille + 999) / 1000);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+        seen += p.buckets[i];
+        if (seen >= rank) {
+            uint32_t limit = bucketLimit(i);
+            return limit < p.maxCycles ? limit : p.maxCycles;
+        }
+    }
+    return p.maxCycles;
+}
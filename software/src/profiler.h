@@ -0,0 +1,75 @@
+/**
+ * @file profiler.h
+ * @brief Run-time statistics of one job (min/avg/max/percentiles)
+ *
+ * Every sample is a duration in CPU cycles. Percentiles come from a
+ * log-linear histogram: each power of two is split into PROF_SUB_BUCKETS
+ * buckets, so a percentile is exact to within 25 %. Bucket counters are
+ * 16 bit; when one would overflow, all buckets are halved, which keeps the
+ * shape of the distribution and weights recent samples a little more.
+ *
+ * Only the owning task records samples. Readers on other tasks may see a
+ * sample half-applied, which is acceptable for a profiler.
+ *
+ * This file has no Arduino dependency, durations are passed in by the caller.
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Samples are bucketed in units of 2^PROF_UNIT_SHIFT cycles (~1 us at 240 MHz)
+ */
+#define PROF_UNIT_SHIFT 8
+
+/**
+ * @brief Buckets per power of two
+ */
+#define PROF_SUB_BUCKETS 4
+
+/**
+ * @brief Number of histogram buckets (covers the full 32 bit cycle range)
+ */
+#define PROF_BUCKETS (PROF_SUB_BUCKETS * (32 - PROF_UNIT_SHIFT - 1))
+
+/**
+ * @struct ProfStats
+ * @brief Statistics of one job
+ */
+struct ProfStats {
+    uint32_t count;                 ///< Samples since reset
+    uint32_t overruns;              ///< Samples above the budget
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t sumCycles;
+    uint16_t buckets[PROF_BUCKETS];
+};
+
+/**
+ * @brief Clears all statistics.
+ */
+void prof_reset(ProfStats &p);
+
+/**
+ * @brief Records one run.
+ *
+ * @param p            Statistics
+ * @param cycles       Run time in CPU cycles
+ * @param budgetCycles Run time above which the run counts as overrun (0 = none)
+ */
+void prof_record(ProfStats &p, uint32_t cycles, uint32_t budgetCycles);
+
+/**
+ * @brief Returns the average run time in cycles (0 without samples).
+ */
+uint32_t prof_average(const ProfStats &p);
+
+/**
+ * @brief Estimates a percentile from the histogram.
+ *
+ * @param p        Statistics
+ * @param permille Percentile in 1/1000, e.g. 990 for p99
+ * @return Upper bound of the bucket holding the percentile in cycles
+ *         (limited to maxCycles), 0 without samples
+ */
+uint32_t prof_percentile(const ProfStats &p, uint16_t permille);
@@ -0,0 +1,96 @@
+/**
+ * @file scheduler.cpp
+ * @brief Deadline scheduler implementation
+ *
+ * The job tables are tiny (a handful of jobs per task), so a linear scan
+ * for the earliest deadline is cheaper than maintaining a heap.
+ * All time comparisons are wrap-safe (millis() overflows after 49 days).
+ */
+
+#include "scheduler.h"
+
+/**
+ * @brief Signed distance between two timestamps (wrap-safe)
+ */
+static inline int32_t timeDiff(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b);
+}
+
+int sched_add(Scheduler &s, const char* name, SchedJobFn fn, uint32_t periodMs, uint32_t now) {
+    if (s.count >= SCHED_MAX_JOBS || fn == nullptr) return -1;
+
+    SchedJob &j = s.jobs[s.count];
+    j.name = name;
+    j.fn = fn;
+    j.periodMs = periodMs;
+    j.due = now;
+    j.armed = (periodMs > 0);
+    j.triggered.store(false, std::memory_order_relaxed);
+
+    return s.count++;
+}
+
+int sched_nextDue(Scheduler &s, uint32_t now) {
+    int best = -1;
+
+    // Triggered jobs first: they represent external events
+    for (uint8_t i = 0; i < s.count; i++) {
+        if (s.jobs[i].triggered.exchange(false, std::memory_order_acquire)) {
+            best = i;
+            break;
+        }
+    }
+
+    if (best < 0) {
+        for (uint8_t i = 0; i < s.count; i++) {
+            const SchedJob &j = s.jobs[i];
+            if (!j.armed || timeDiff(now, j.due) < 0) continue;
+            if (best < 0 || timeDiff(j.due, s.jobs[best].due) < 0) {
+                best = i;
+            }
+        }
+        if (best < 0) return -1;
+    }
+
+    SchedJob &j = s.jobs[best];
+    if (j.periodMs == 0) {
+        j.armed = false;
+    } else if (timeDiff(now, j.due) >= (int32_t)j.periodMs || timeDiff(j.due, now) > 0) {
+        // Fell behind by a whole period (or triggered early): resync
+        j.due = now + j.periodMs;
+        j.armed = true;
+    } else {
+        // Keep the phase so the period does not drift with run time
+        j.due += j.periodMs;
+        j.armed = true;
+    }
+
+    return best;
+}
+
+uint32_t sched_timeToNext(const Scheduler &s, uint32_t now) {
+    uint32_t wait = SCHED_NO_DEADLINE;
+
+    for (uint8_t i = 0; i < s.count; i++) {
+        const SchedJob &j = s.jobs[i];
+        if (j.triggered.load(std::memory_order_relaxed)) return 0;
+        if (!j.armed) continue;
+
+        int32_t d = timeDiff(j.due, now);
+        if (d <= 0) return 0;
+        if ((uint32_t)d < wait) wait = d;
+    }
+
+    return wait;
+}
+
+void sched_runIn(Scheduler &s, int id, uint32_t delayMs, uint32_t now) {
+    if (id < 0 || id >= s.count) return;
+
+    SchedJob &j = s.jobs[id];
+    uint32_t due = now + delayMs;
+    if (!j.armed || timeDiff(due, j.due) < 0) {
+        j.due = due;
+        j.armed = true;
+    }
+}
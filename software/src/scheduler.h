@@ -0,0 +1,110 @@
+/**
+ * @file scheduler.h
+ * @brief Deadline scheduler for periodic and event-driven jobs
+ *
+ * Each job has a deadline. Periodic jobs are re-armed one period after
+ * their previous deadline (no drift), event-driven jobs (period 0) only
+ * run when triggered. The owner asks for the time until the earliest
+ * deadline and sleeps exactly that long instead of polling.
+ *
+ * This file has no Arduino dependency, time is always passed in by the caller.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+#define SCHED_MAX_JOBS 8
+
+/**
+ * @brief Returned by sched_timeToNext() if no job is armed
+ */
+#define SCHED_NO_DEADLINE 0xFFFFFFFFUL
+
+/**
+ * @brief Job function
+ */
+typedef void (*SchedJobFn)();
+
+/**
+ * @struct SchedJob
+ * @brief One registered job
+ */
+struct SchedJob {
+    const char* name;               ///< Job name
+    SchedJobFn fn;                  ///< Job function
+    uint32_t periodMs;              ///< Period (0 = event-driven only)
+    uint32_t due;                   ///< Next deadline (millis)
+    bool armed;                     ///< true if due is valid
+    std::atomic<bool> triggered;    ///< Run request from another context
+};
+
+/**
+ * @struct Scheduler
+ * @brief Job table of one scheduler instance
+ */
+struct Scheduler {
+    SchedJob jobs[SCHED_MAX_JOBS];
+    uint8_t count;
+};
+
+/**
+ * @brief Adds a job to the scheduler.
+ *
+ * Periodic jobs run for the first time at @p now.
+ *
+ * @param s        Scheduler
+ * @param name     Job name
+ * @param fn       Job function
+ * @param periodMs Period in ms, 0 = run only when triggered
+ * @param now      Current time in ms
+ * @return Job index, or -1 if the table is full
+ */
+int sched_add(Scheduler &s, const char* name, SchedJobFn fn, uint32_t periodMs, uint32_t now);
+
+/**
+ * @brief Returns the earliest due job and advances its deadline.
+ *
+ * Triggered jobs come first, then due jobs ordered by deadline
+ * (ties in registration order). The caller runs s.jobs[i].fn().
+ *
+ * @param s   Scheduler
+ * @param now Current time in ms
+ * @return Job index, or -1 if nothing is due
+ */
+int sched_nextDue(Scheduler &s, uint32_t now);
+
+/**
+ * @brief Returns the time until the earliest deadline.
+ *
+ * @param s   Scheduler
+ * @param now Current time in ms
+ * @return Time in ms (0 = due now), SCHED_NO_DEADLINE if nothing is armed
+ */
+uint32_t sched_timeToNext(const Scheduler &s, uint32_t now);
+
+/**
+ * @brief Runs a job once after a delay.
+ *
+ * Only pulls the deadline forward, a later regular deadline is kept.
+ * Must only be called from the context that runs the scheduler.
+ *
+ * @param s       Scheduler
+ * @param id      Job index
+ * @param delayMs Delay in ms
+ * @param now     Current time in ms
+ */
+void sched_runIn(Scheduler &s, int id, uint32_t delayMs, uint32_t now);
+
+/**
+ * @brief Requests a job to run as soon as possible.
+ *
+ * Safe to call from other tasks and from ISRs.
+ *
+ * @param s  Scheduler
+ * @param id Job index
+ */
+inline void sched_trigger(Scheduler &s, int id) {
+    if (id < 0 || id >= s.count) return;
+    s.jobs[id].triggered.store(true, std::memory_order_release);
+}
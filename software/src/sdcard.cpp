@@ -3,10 +3,26 @@
  * @brief SD card initialization and file access
  */
 
+#define LOG_MODULE LOG_MOD_SD
+
 #include "sdcard.h"
 #include "pins.h"
 #include <SPI.h>
 #include "web_log.h"
+#include "crc32.h"
+
+static_assert(CONFIG_GENERATIONS >= 1, "config.txt is replaced by renaming it to the first generation");
+
+/**
+ * @enum ConfigFileState
+ * @brief Result of checkConfigFile()
+ */
+enum ConfigFileState : uint8_t {
+    CFILE_MISSING,
+    CFILE_UNCHECKED,    ///< No checksum line (written by hand)
+    CFILE_VALID,
+    CFILE_CORRUPT       ///< Checksum does not match
+};
 
 SPIClass sdSPI(FSPI);
 
@@ -23,7 +39,7 @@ bool initSD() {
     sdSPI.begin(PIN_SD_SCK, PIN_SD_MISO, PIN_SD_MOSI, PIN_SD_CS);
 
     if (!SD.begin(PIN_SD_CS, sdSPI)) {
-        LOG("SD init failed");
+        LOG_ERROR("SD init failed");
         return false;
     }
 
@@ -33,19 +49,218 @@ bool initSD() {
     return true;
 }
 
+static void generationPath(char* buf, size_t size, uint8_t n) {
+    snprintf(buf, size, "%s.%u", CONFIG_FILE_PATH, n);
+}
+
+/**
+ * @brief Checks the checksum line of a config file.
+ *
+ * The checksum covers all bytes before the (last) checksum line.
+ */
+static ConfigFileState checkConfigFile(const char* path) {
+    File f = SD.open(path, FILE_READ);
+    if (!f) return CFILE_MISSING;
+
+    const size_t tagLen = strlen(CONFIG_CHECKSUM_TAG);
+    char head[24];              // start of the current line
+    size_t headLen = 0;
+    uint32_t crc = 0;           // all bytes so far
+    uint32_t crcLineStart = 0;  // bytes before the current line
+    uint32_t crcBeforeTag = 0;
+    uint32_t expected = 0;
+    bool found = false;
+
+    uint8_t buf[64];
+    size_t n;
+    bool end = false;
+    while (!end) {
+        n = f.read(buf, sizeof(buf));
+        end = (n == 0);
+        for (size_t i = 0; i <= n; i++) {
+            bool lineEnd = (i == n) ? end : (buf[i] == '\n');
+            if (i < n && headLen < sizeof(head) - 1) head[headLen++] = (char)buf[i];
+            if (lineEnd) {
+                head[headLen] = '\0';
+                if (headLen > tagLen && strncmp(head, CONFIG_CHECKSUM_TAG, tagLen) == 0) {
+                    char* hexEnd;
+                    uint32_t value = strtoul(head + tagLen, &hexEnd, 16);
+                    if (hexEnd == head + tagLen + 8) {
+                        found = true;
+                        expected = value;
+                        crcBeforeTag = crcLineStart;
+                    }
+                }
+            }
+            if (i < n) crc = crc32(&buf[i], 1, crc);
+            if (lineEnd) {
+                crcLineStart = crc;
+                headLen = 0;
+            }
+        }
+    }
+    f.close();
+
+    if (!found) return CFILE_UNCHECKED;
+    return expected == crcBeforeTag ? CFILE_VALID : CFILE_CORRUPT;
+}
+
+void recoverConfigFile() {
+    if (!SD.exists(CONFIG_TMP_PATH)) return;
+
+    // Power loss between moving config.txt away and renaming the new file
+    if (checkConfigFile(CONFIG_FILE_PATH) == CFILE_MISSING && checkConfigFile(CONFIG_TMP_PATH) == CFILE_VALID &&
+        SD.rename(CONFIG_TMP_PATH, CONFIG_FILE_PATH)) {
+        LOG_WARN("config.txt: completed an interrupted write");
+    } else {
+        SD.remove(CONFIG_TMP_PATH);     // write that did not finish
+    }
+}
+
 /**
  * @brief Opens the configuration file (config.txt) from the SD card.
  *
- * Checks if the file exists and opens it for reading.
+ * Checks if the file exists and is intact and opens it for reading.
  *
  * @return File object for config.txt if it exists, otherwise an empty File object
  */
 File openConfigFile() {
-    if (!SD.exists("/config.txt")) {
-        LOG("config.txt missing");
+    ConfigFileState state = checkConfigFile(CONFIG_FILE_PATH);
+
+    if (state == CFILE_CORRUPT) {
+        LOG_ERROR("config.txt: checksum mismatch, moved to %s", CONFIG_BAD_PATH + 1);
+        SD.remove(CONFIG_BAD_PATH);
+        SD.rename(CONFIG_FILE_PATH, CONFIG_BAD_PATH);
+        return File();
+    }
+    if (state == CFILE_MISSING) {
+        LOG_WARN("config.txt missing");
         return File();
     }
-    return SD.open("/config.txt", FILE_READ);
+    return SD.open(CONFIG_FILE_PATH, FILE_READ);
+}
+
+bool restoreConfigGeneration() {
+    char path[24];
+    for (uint8_t i = 1; i <= CONFIG_GENERATIONS; i++) {
+        generationPath(path, sizeof(path), i);
+        ConfigFileState state = checkConfigFile(path);
+        if (state == CFILE_MISSING || state == CFILE_CORRUPT) continue;
+
+        if (SD.exists(CONFIG_FILE_PATH)) SD.remove(CONFIG_FILE_PATH);
+        if (!SD.rename(path, CONFIG_FILE_PATH)) break;
+        LOG_WARN("config.txt restored from %s", path + 1);
+        return true;
+    }
+    LOG_ERROR("No intact previous config.txt");
+    return false;
+}
+
+bool configWriteBegin(ConfigWriter &w) {
+    w.file = SD.open(CONFIG_TMP_PATH, FILE_WRITE);
+    w.tagPos = 0;
+    w.skipLine = false;
+    if (!w.file) LOG_ERROR("Could not create %s", CONFIG_TMP_PATH + 1);
+    return (bool)w.file;
+}
+
+void configWriteChunk(ConfigWriter &w, const char* data, size_t len) {
+    static const char TAG[] = CONFIG_CHECKSUM_TAG;
+    const int8_t tagLen = sizeof(TAG) - 1;
+
+    // Copy runs of kept characters, hold back a possible tag at the line start
+    const char* run = data;
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (w.skipLine) {
+            if (c == '\n') {
+                w.skipLine = false;
+                w.tagPos = 0;
+            }
+            run = data + i + 1;
+            continue;
+        }
+        if (w.tagPos >= 0 && c == TAG[w.tagPos]) {
+            w.file.write((const uint8_t*)run, data + i - run);
+            run = data + i + 1;
+            if (++w.tagPos == tagLen) {
+                w.skipLine = true;
+                w.tagPos = -1;
+            }
+            continue;
+        }
+        if (w.tagPos > 0) {
+            // Not a checksum line after all: write what was held back
+            w.file.write((const uint8_t*)TAG, w.tagPos);
+        }
+        w.tagPos = (c == '\n') ? 0 : -1;
+    }
+    if (!w.skipLine) w.file.write((const uint8_t*)run, data + len - run);
+}
+
+void configWriteAbort(ConfigWriter &w) {
+    w.file.close();
+    SD.remove(CONFIG_TMP_PATH);
+}
+
+bool configWriteCommit(ConfigWriter &w) {
+    if (w.tagPos > 0) w.file.write((const uint8_t*)CONFIG_CHECKSUM_TAG, w.tagPos);
+    w.file.close();
+
+    // Checksum over the content, appended as last line
+    File f = SD.open(CONFIG_TMP_PATH, FILE_READ);
+    if (!f) return false;
+    uint8_t buf[64];
+    size_t n;
+    uint32_t crc = 0;
+    char last = '\n';
+    while ((n = f.read(buf, sizeof(buf))) > 0) {
+        crc = crc32(buf, n, crc);
+        last = (char)buf[n - 1];
+    }
+    f.close();
+
+    f = SD.open(CONFIG_TMP_PATH, FILE_APPEND);
+    if (!f) return false;
+    if (last != '\n') {
+        // The checksum needs a line of its own
+        f.write('\n');
+        crc = crc32("\n", 1, crc);
+    }
+    f.printf("%s%08lx - written by the controller, delete this line when editing by hand\n",
+             CONFIG_CHECKSUM_TAG, (unsigned long)crc);
+    f.flush();
+    f.close();      // syncs the file to the card
+
+    // Read back: the card must return what was written
+    if (checkConfigFile(CONFIG_TMP_PATH) != CFILE_VALID) {
+        LOG_ERROR("config.txt: write verification failed, file unchanged");
+        SD.remove(CONFIG_TMP_PATH);
+        return false;
+    }
+
+    // Shift the generations, config.txt becomes .1 (rename cannot overwrite on FAT)
+    char from[24];
+    char to[24];
+    generationPath(to, sizeof(to), CONFIG_GENERATIONS);
+    SD.remove(to);
+    for (int i = CONFIG_GENERATIONS - 1; i >= 1; i--) {
+        generationPath(from, sizeof(from), i);
+        generationPath(to, sizeof(to), i + 1);
+        if (SD.exists(from)) SD.rename(from, to);
+    }
+    generationPath(to, sizeof(to), 1);
+    if (SD.exists(CONFIG_FILE_PATH) && !SD.rename(CONFIG_FILE_PATH, to)) {
+        LOG_ERROR("config.txt: could not keep the previous version");
+        SD.remove(CONFIG_TMP_PATH);
+        return false;
+    }
+
+    if (!SD.rename(CONFIG_TMP_PATH, CONFIG_FILE_PATH)) {
+        LOG_ERROR("config.txt: could not replace");    // completed by recoverConfigFile() at boot
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -58,7 +273,7 @@ void testSDCard() {
 
     uint8_t cardType = SD.cardType();
     if (cardType == CARD_NONE) {
-        LOG("No SD card attached");
+        LOG_WARN("No SD card attached");
         return;
     }
 
@@ -69,7 +284,7 @@ void testSDCard() {
     else LOG("UNKNOWN");
 
     uint64_t cardSize = SD.cardSize() / (1024 * 1024);
-    LOG("Card Size: " + String(cardSize) + " MB");
+    LOGF("Card Size: %llu MB", cardSize);
 
     LOG("----------------------");
 }
@@ -84,13 +299,13 @@ void listRootDir() {
 
     File root = SD.open("/");
     if (!root) {
-        LOG("Failed to open root directory");
+        LOG_ERROR("Failed to open root directory");
         return;
     }
 
     File file = root.openNextFile();
     while (file) {
-        LOG("FILE: " + String(file.name()) + "  SIZE: " + String(file.size()));
+        LOGF("FILE: %s  SIZE: %u", file.name(), (unsigned)file.size());
         file = root.openNextFile();
     }
 
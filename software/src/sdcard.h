@@ -3,6 +3,11 @@
  * @brief SD card abstraction
  *
  * Initializes the SD card and provides access to config.txt.
+ *
+ * config.txt is never written in place: the new content goes to a temp
+ * file, gets a checksum line, is read back and only then replaces
+ * config.txt. The previous versions are kept as config.txt.1 .. .N.
+ * A power loss at any point leaves either the old or the new file.
  */
 
 #ifndef SDCARD_H
@@ -17,12 +22,76 @@
  */
 bool initSD();
 
+#define CONFIG_FILE_PATH "/config.txt"
+#define CONFIG_TMP_PATH  "/config.tmp"
+#define CONFIG_BAD_PATH  "/config.bad"
+
+/**
+ * @brief Number of previous versions of config.txt that are kept
+ */
+#define CONFIG_GENERATIONS 3
+
+/**
+ * @brief Start of the checksum line the controller appends to config.txt
+ */
+#define CONFIG_CHECKSUM_TAG "# crc32 "
+
+/**
+ * @brief Completes or discards a config.txt replace interrupted by a power loss.
+ *
+ * Boot only: later, config.tmp may be an upload that is still being written.
+ */
+void recoverConfigFile();
+
 /**
  * @brief Opens the configuration file (config.txt) from the SD card.
- * @return File object for config.txt if it exists, otherwise an empty File object.
+ *
+ * A file with a wrong checksum is moved to config.bad and not returned.
+ *
+ * @return File object for config.txt if it exists and is intact, otherwise an empty File object.
  */
 File openConfigFile();
 
+/**
+ * @brief Replaces config.txt with the newest intact previous version.
+ * @return false if there is none
+ */
+bool restoreConfigGeneration();
+
+/**
+ * @struct ConfigWriter
+ * @brief A new config.txt being written (into the temp file)
+ */
+struct ConfigWriter {
+    File file;
+    int8_t tagPos;      ///< Characters of CONFIG_CHECKSUM_TAG matched at the line start, -1 = none
+    bool skipLine;      ///< Current line is an old checksum line
+};
+
+/**
+ * @brief Starts writing a new config.txt.
+ * @return false if the temp file cannot be created
+ */
+bool configWriteBegin(ConfigWriter &w);
+
+/**
+ * @brief Appends the next chunk of the content (any size).
+ *
+ * Old checksum lines (e.g. from a downloaded config.txt) are dropped.
+ */
+void configWriteChunk(ConfigWriter &w, const char* data, size_t len);
+
+/**
+ * @brief Adds the checksum, verifies the temp file and makes it config.txt.
+ * @return false on error, config.txt is then unchanged
+ */
+bool configWriteCommit(ConfigWriter &w);
+
+/**
+ * @brief Discards the new content, config.txt is unchanged.
+ */
+void configWriteAbort(ConfigWriter &w);
+
 /**
  * @brief Tests the SD card and prints information about it.
  */
@@ -0,0 +1,71 @@
+/**
+ * @file snapshot.h
+ * @brief Lock-free publication of status structures between tasks
+ *
+ * Snapshot<T> is a double-buffered sequence lock ("latch"): the writer
+ * updates both copies one after the other and bumps the sequence counter
+ * before each. A reader always copies the buffer the writer is NOT
+ * touching, and only retries if the writer finished a copy meanwhile.
+ *
+ * Readers never block and never wait for a preempted writer, which is
+ * important because readers (web server, OLED) may run at a higher
+ * priority on the same core as the writer.
+ *
+ * Constraints:
+ *  - exactly one writer task per snapshot
+ *  - T must be trivially copyable (plain status structs)
+ *
+ * This file has no Arduino dependency.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+template <typename T>
+class Snapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot<T> requires a trivially copyable T");
+
+public:
+    Snapshot() : seq(0) {
+        memset(data, 0, sizeof(data));
+    }
+
+    explicit Snapshot(const T &initial) : seq(0) {
+        memcpy(&data[0], &initial, sizeof(T));
+        memcpy(&data[1], &initial, sizeof(T));
+    }
+
+    /**
+     * @brief Publishes a new value (single writer only).
+     */
+    void publish(const T &value) {
+        for (uint8_t i = 0; i < 2; i++) {
+            // Odd sequence: readers use data[1] while data[0] is written, and vice versa
+            seq.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(&data[i], &value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Returns a consistent copy of the latest value (any task).
+     */
+    T read() const {
+        T out;
+        uint32_t s;
+        do {
+            s = seq.load(std::memory_order_acquire);
+            memcpy(&out, &data[s & 1], sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (seq.load(std::memory_order_relaxed) != s);
+        return out;
+    }
+
+private:
+    std::atomic<uint32_t> seq;
+    T data[2];
+};
@@ -0,0 +1,152 @@
+/**
+ * @file status_json.cpp
+ * @brief Field table and JSON output of the status sample
+ */
+
+#include "status_json.h"
+#include "json_writer.h"
+#include <stddef.h>
+
+enum FieldType : uint8_t {
+    FIELD_BOOL,
+    FIELD_INT,
+    FIELD_UINT,
+    FIELD_FLOAT,
+    FIELD_STR
+};
+
+/**
+ * @struct StatusField
+ * @brief One streamed field, keys as in /status
+ */
+struct StatusField {
+    const char* group;
+    const char* key;
+    FieldType type;
+    uint8_t offset;
+    uint8_t size;       ///< Buffer size (FIELD_STR)
+    float deadBand;     ///< Minimum change (FIELD_FLOAT), < 0: always sent, never compared
+};
+
+#define FIELD(group, key, type, member, deadBand) \
+    { group, key, type, offsetof(StatusSample, member), sizeof(StatusSample::member), deadBand }
+
+#define ALWAYS -1.0f
+
+/**
+ * @brief Decimals of float values in the JSON output
+ */
+#define STATUS_FLOAT_DECIMALS 2
+
+static const StatusField FIELDS[] = {
+    FIELD("bme",      "present",           FIELD_BOOL,  bmePresent,   0),
+    FIELD("bme",      "temperature",       FIELD_FLOAT, bmeTemp,      0.05f),
+    FIELD("bme",      "humidity",          FIELD_FLOAT, bmeHum,       0.05f),
+    FIELD("bme",      "pressure",          FIELD_FLOAT, bmePres,      0.5f),
+    FIELD("bme",      "voltage",           FIELD_FLOAT, voltage,      0.01f),
+    FIELD("bme",      "systime",           FIELD_UINT,  systime,      ALWAYS),
+    FIELD("bme",      "time",              FIELD_STR,   time,         0),
+
+    FIELD("dew",      "temperature",       FIELD_FLOAT, dewTemp,      0.05f),
+    FIELD("dew",      "humidity",          FIELD_FLOAT, dewHum,       0.05f),
+    FIELD("dew",      "dewPoint",          FIELD_FLOAT, dewPoint,     0.05f),
+    FIELD("dew",      "dew1Power",         FIELD_INT,   dew1,         0),
+    FIELD("dew",      "dew1MaxPower",      FIELD_INT,   dew1Max,      0),
+    FIELD("dew",      "dew2Power",         FIELD_INT,   dew2,         0),
+    FIELD("dew",      "dew2MaxPower",      FIELD_INT,   dew2Max,      0),
+    FIELD("dew",      "active",            FIELD_BOOL,  dewActive,    0),
+    FIELD("dew",      "spreadTrend",       FIELD_FLOAT, dewTrend,     0.05f),
+    FIELD("dew",      "lens1Temperature",  FIELD_FLOAT, lens1,        0.05f),
+    FIELD("dew",      "lens2Temperature",  FIELD_FLOAT, lens2,        0.05f),
+
+    FIELD("power",    "supplyVoltage",     FIELD_FLOAT, supply,       0.05f),
+    FIELD("power",    "totalWatts",        FIELD_FLOAT, powerTotal,   0.2f),
+    FIELD("power",    "shedLevel",         FIELD_INT,   shedLevel,    0),
+    FIELD("power",    "budgetLimited",     FIELD_BOOL,  budgetLimited, 0),
+
+    FIELD("wanderer", "firmware",          FIELD_STR,   firmware,     0),
+    FIELD("wanderer", "close_position",    FIELD_FLOAT, closePos,     0.05f),
+    FIELD("wanderer", "open_position",     FIELD_FLOAT, openPos,      0.05f),
+    FIELD("wanderer", "current_position",  FIELD_FLOAT, curPos,       0.05f),
+    FIELD("wanderer", "input_voltage",     FIELD_FLOAT, inputVoltage, 0.01f),
+    FIELD("wanderer", "brightness",        FIELD_INT,   brightness,   0),
+    FIELD("wanderer", "dew_heater",        FIELD_INT,   dewHeater,    0),
+    FIELD("wanderer", "asiair_enabled",    FIELD_INT,   asiair,       0),
+    FIELD("wanderer", "connection_status", FIELD_BOOL,  connected,    0),
+    FIELD("wanderer", "poti_brightness",   FIELD_INT,   poti,         0),
+};
+
+#define FIELD_COUNT (sizeof(FIELDS) / sizeof(FIELDS[0]))
+
+static inline const uint8_t* fieldPtr(const StatusSample &s, const StatusField &f) {
+    return reinterpret_cast<const uint8_t*>(&s) + f.offset;
+}
+
+/**
+ * @brief True if the field differs by more than its dead band.
+ */
+static bool changed(const StatusField &f, const StatusSample &a, const StatusSample &b) {
+    const uint8_t* pa = fieldPtr(a, f);
+    const uint8_t* pb = fieldPtr(b, f);
+
+    if (f.deadBand < 0) return false;
+    if (f.type == FIELD_FLOAT) {
+        float va, vb;
+        memcpy(&va, pa, sizeof(va));
+        memcpy(&vb, pb, sizeof(vb));
+        if (isnan(va) || isnan(vb)) return isnan(va) != isnan(vb);     // sent as null
+        return fabsf(va - vb) >= f.deadBand;
+    }
+    return memcmp(pa, pb, f.size) != 0;
+}
+
+/**
+ * @brief Writes one field as member of the currently open group.
+ */
+static void writeField(JsonWriter &w, const StatusField &f, const StatusSample &s) {
+    const uint8_t* p = fieldPtr(s, f);
+
+    switch (f.type) {
+    case FIELD_BOOL:  w.field(f.key, *reinterpret_cast<const bool*>(p));                            break;
+    case FIELD_INT:   w.field(f.key, *reinterpret_cast<const int32_t*>(p));                         break;
+    case FIELD_UINT:  w.field(f.key, *reinterpret_cast<const uint32_t*>(p));                        break;
+    case FIELD_FLOAT: w.field(f.key, *reinterpret_cast<const float*>(p), STATUS_FLOAT_DECIMALS);    break;
+    case FIELD_STR:   w.field(f.key, reinterpret_cast<const char*>(p));                             break;
+    }
+}
+
+void status_json_write(Print &out, const StatusSample &s, const StatusSample* prev) {
+    JsonWriter w(out);
+    const char* group = nullptr;
+
+    w.beginObject();
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const StatusField &f = FIELDS[i];
+        if (prev != nullptr && f.deadBand >= 0 && !changed(f, s, *prev)) continue;
+
+        if (group == nullptr || strcmp(group, f.group) != 0) {
+            if (group != nullptr) w.endObject();
+            group = f.group;
+            w.beginObject(group);
+        }
+        writeField(w, f, s);
+    }
+    if (group != nullptr) w.endObject();
+    w.endObject();
+}
+
+bool status_json_changed(const StatusSample &s, const StatusSample &sent) {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (changed(FIELDS[i], s, sent)) return true;
+    }
+    return false;
+}
+
+void status_json_markSent(StatusSample &sent, const StatusSample &s) {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const StatusField &f = FIELDS[i];
+        if (changed(f, s, sent)) {
+            memcpy(reinterpret_cast<uint8_t*>(&sent) + f.offset, fieldPtr(s, f), f.size);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file status_json.h
+ * @brief Status sample and its JSON encoding (/status and /status/events)
+ *
+ * The sample is a flat copy of everything shown on the dashboard. One
+ * field table (group, key, type, offset, dead band) drives comparing and
+ * JSON output, so both stay in sync. JSON is written with JsonWriter into
+ * any Print, no JsonDocument or String is involved.
+ *
+ * This file has no web server dependency.
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Upper bound of the full status document in bytes
+ *
+ * Covers the widest values the cover may send (9-digit numbers, a
+ * firmware string of control characters escaped as \u00XX), checked by
+ * test_status_json.
+ */
+#define STATUS_JSON_MAX 1024
+
+/**
+ * @struct StatusSample
+ * @brief Flat copy of everything shown on the dashboard
+ */
+struct StatusSample {
+    bool bmePresent;
+    float bmeTemp;
+    float bmeHum;
+    float bmePres;
+    float voltage;
+    uint32_t systime;
+    char time[8];
+
+    float dewTemp;
+    float dewHum;
+    float dewPoint;
+    int32_t dew1;
+    int32_t dew1Max;
+    int32_t dew2;
+    int32_t dew2Max;
+    bool dewActive;
+    float supply;
+    float powerTotal;
+    int32_t shedLevel;
+    bool budgetLimited;
+    float dewTrend;
+    float lens1;
+    float lens2;
+
+    char firmware[16];
+    float closePos;
+    float openPos;
+    float curPos;
+    float inputVoltage;
+    int32_t brightness;
+    int32_t dewHeater;
+    int32_t asiair;
+    bool connected;
+    int32_t poti;
+};
+
+/**
+ * @brief Writes the status document, grouped as in /status.
+ *
+ * @param out  Destination (JsonBuffer, response stream)
+ * @param s    Sample
+ * @param prev nullptr: all fields, otherwise only fields changed against prev
+ */
+void status_json_write(Print &out, const StatusSample &s, const StatusSample* prev);
+
+/**
+ * @brief True if any field differs from sent by more than its dead band.
+ */
+bool status_json_changed(const StatusSample &s, const StatusSample &sent);
+
+/**
+ * @brief Takes over the changed fields of s into sent (dead bands compare against sent).
+ */
+void status_json_markSent(StatusSample &sent, const StatusSample &s);
@@ -0,0 +1,133 @@
+/**
+ * @file status_stream.cpp
+ * @brief Delta-encoded status events for the dashboard
+ *
+ * Sampling and sending; the field table and the JSON output are in
+ * status_json.cpp. Events are written into a stack buffer, /status into
+ * the response stream.
+ */
+
+#define LOG_MODULE LOG_MOD_WEB
+
+#include "status_stream.h"
+#include "status_json.h"
+#include "json_writer.h"
+#include "snapshot.h"
+#include "task_manager.h"
+#include "web_log.h"
+#include "bme280_manager.h"
+#include "dew_controller.h"
+#include "usb_manager.h"
+#include "power_control.h"
+#include "power_budget.h"
+#include "button_manager.h"
+#include "time_manager.h"
+#include <atomic>
+
+static AsyncEventSource statusEvents("/status/events");
+
+static Snapshot<StatusSample> latest;   // for the full event on connect
+static StatusSample sent;               // values the clients have (job only)
+static std::atomic<uint32_t> lastRead(0);   // millis() of the last /status or connect
+
+/**
+ * @brief Collects the current status (any task: the modules publish snapshots).
+ */
+static void sample(StatusSample &s) {
+    memset(&s, 0, sizeof(s));
+
+    BmeStatus bme = bme_getStatus();
+    s.bmePresent = bme.present;
+    s.bmeTemp = bme.temperature;
+    s.bmeHum = bme.humidity;
+    s.bmePres = bme.pressure;
+    s.voltage = power_readSupplyVoltage();
+    s.systime = millis();
+    int hour, minute;
+    if (getTime(hour, minute)) snprintf(s.time, sizeof(s.time), "%02u:%02u", (uint8_t)hour, (uint8_t)minute);
+    else strlcpy(s.time, "00:00", sizeof(s.time));
+
+    DewStatus dew = dew_getStatus();
+    s.dewTemp = dew.temperature;
+    s.dewHum = dew.humidity;
+    s.dewPoint = dew.dewPoint;
+    s.dew1 = power_getDew1Level();
+    s.dew1Max = dew.dew1Max;
+    s.dew2 = power_getDew2Level();
+    s.dew2Max = dew.dew2Max;
+    s.dewActive = dew.active;
+    s.dewTrend = dew.spreadSlope;
+    s.lens1 = dew.lens1Temp;
+    s.lens2 = dew.lens2Temp;
+
+    PowerBudgetStatus pb = powerbudget_getStatus();
+    s.supply = pb.voltage;
+    s.powerTotal = pb.totalWatts;
+    s.shedLevel = pb.shedLevel;
+    s.budgetLimited = pb.budgetLimited;
+
+    WandererStatus w = usb_manager_get_parsed_status();
+    memcpy(s.firmware, w.firmware, sizeof(s.firmware));
+    s.closePos = w.close_position;
+    s.openPos = w.open_position;
+    s.curPos = w.current_position;
+    s.inputVoltage = w.input_voltage;
+    s.brightness = w.brightness;
+    s.dewHeater = w.dew_heater;
+    s.asiair = w.asiair_enabled;
+    s.connected = w.connection_status;
+    s.poti = getPotiBrightness();
+}
+
+/**
+ * @brief Sampling job: sends the changed fields to all clients.
+ */
+static void statusStreamUpdate() {
+    // Nobody is looking: /status samples by itself once the snapshot is old
+    if (statusEvents.count() == 0 &&
+        millis() - lastRead.load(std::memory_order_relaxed) > STATUS_STREAM_IDLE_MS) {
+        return;
+    }
+
+    StatusSample s;
+    sample(s);
+    latest.publish(s);
+
+    if (statusEvents.count() == 0) {
+        sent = s;               // new clients get a full event anyway
+        return;
+    }
+
+    if (!status_json_changed(s, sent)) return;
+
+    char buf[STATUS_JSON_MAX];
+    JsonBuffer json(buf, sizeof(buf));
+    status_json_write(json, s, &sent);
+
+    // Remember what the clients have now (dead bands compare against this)
+    status_json_markSent(sent, s);
+
+    if (!json.overflow()) statusEvents.send(json.c_str(), "status");
+}
+
+void status_stream_writeSnapshot(Print &out) {
+    uint32_t now = millis();
+    lastRead.store(now, std::memory_order_relaxed);
+
+    StatusSample s = latest.read();
+    if (now - s.systime > 2 * STATUS_STREAM_INTERVAL_MS) sample(s);     // job was idle
+    s.systime = now;
+    status_json_write(out, s, nullptr);
+}
+
+void status_stream_begin(AsyncWebServer &server) {
+    statusEvents.onConnect([](AsyncEventSourceClient *client) {
+        char buf[STATUS_JSON_MAX];
+        JsonBuffer json(buf, sizeof(buf));
+        status_stream_writeSnapshot(json);
+        if (!json.overflow()) client->send(json.c_str(), "status");
+    });
+    server.addHandler(&statusEvents);
+
+    task_register(TASK_NET, "status", statusStreamUpdate, STATUS_STREAM_INTERVAL_MS);
+}
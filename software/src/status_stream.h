@@ -0,0 +1,50 @@
+/**
+ * @file status_stream.h
+ * @brief Push-based status updates over Server-Sent Events
+ *
+ * /status/events streams the same data as /status, but only what changed:
+ *  - on connect the client gets one full "status" event
+ *  - afterwards a job samples the status every STATUS_STREAM_INTERVAL_MS
+ *    and sends one "status" event with the changed fields only
+ *    (same nesting as /status, e.g. {"dew":{"dew1Power":40},"bme":{"systime":...}})
+ *
+ * /status serves the latest sample as a full document.
+ *
+ * Analog values use a small dead band so sensor noise does not produce
+ * a stream of updates. The sampling is done once per interval for all
+ * clients, and only while a client is connected or /status was read
+ * within STATUS_STREAM_IDLE_MS. Otherwise /status samples by itself; all
+ * sources are snapshots, so that is cheap on any task.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "status_json.h"
+
+/**
+ * @brief Sampling interval = maximum event rate per client
+ */
+#define STATUS_STREAM_INTERVAL_MS 500
+
+/**
+ * @brief Sampling stops this long after the last /status read without SSE clients (ms)
+ */
+#define STATUS_STREAM_IDLE_MS 10000
+
+/**
+ * @brief Writes the latest sampled status as JSON (the /status document).
+ *
+ * Safe to call from any task, reads the snapshot of the sampling job
+ * (or samples itself if the job is idle).
+ *
+ * @param out Destination, e.g. an AsyncResponseStream
+ */
+void status_stream_writeSnapshot(Print &out);
+
+/**
+ * @brief Registers /status/events and the sampling job.
+ *
+ * @param server Web server (called from initWebServer())
+ */
+void status_stream_begin(AsyncWebServer &server);
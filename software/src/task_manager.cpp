@@ -0,0 +1,305 @@
+/**
+ * @file task_manager.cpp
+ * @brief FreeRTOS task runtime with deadline scheduling and time budget
+ *
+ * Core 0 also runs the WiFi/TCP stack, so only the network task lives there.
+ * Everything that talks to local hardware runs on core 1.
+ */
+
+#define LOG_MODULE LOG_MOD_TASK
+
+#include "task_manager.h"
+#include "scheduler.h"
+#include "web_log.h"
+#include "metrics.h"
+#if TASK_PROFILE
+#include "profiler.h"
+#endif
+
+/**
+ * @struct TaskConfig
+ * @brief Static configuration and runtime state of one task
+ */
+struct TaskConfig {
+    const char* name;       ///< FreeRTOS task name
+    BaseType_t core;        ///< Core affinity
+    UBaseType_t priority;   ///< FreeRTOS priority
+    uint32_t stackSize;     ///< Stack size in bytes
+    uint32_t budgetUs;      ///< Allowed run time per wake-up
+    Scheduler sched;        ///< Jobs of this task
+    uint32_t overruns;      ///< Wake-ups that exceeded the budget
+    uint32_t lastOverrunLog;
+    TaskHandle_t handle;
+    MetricHistogram wakeTime;   ///< Run time per wake-up (us)
+#if TASK_PROFILE
+    ProfStats profile[SCHED_MAX_JOBS];      ///< Per job, written by the task only
+    std::atomic<bool> profileReset;         ///< Set by task_profileReset()
+#endif
+};
+
+/**
+ * @brief Task table
+ *
+ * USB polling runs at the highest priority: the cover streams at 19200 baud
+ * and must never wait for a display refresh or a WiFi scan.
+ */
+static TaskConfig tasks[TASK_COUNT] = {
+    //  name          core prio stack  budget
+    { "task_io",      1,   4,   4096,  2000 },
+    { "task_sensor",  1,   2,   4096,  20000 },
+    { "task_ui",      1,   3,   4096,  10000 },
+    { "task_net",     0,   1,   8192,  50000 },
+    { "task_log",     0,   1,   4096,  100000 }
+};
+
+static std::atomic<bool> started(false);
+
+// Label per task for cover_task_wakeup_duration_us, same order as tasks[]
+static const char* const TASK_LABELS[TASK_COUNT] = {
+    "task=\"io\"", "task=\"sensor\"", "task=\"ui\"", "task=\"net\"", "task=\"log\""
+};
+
+static const uint32_t WAKE_BOUNDS_US[] = { 100, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 };
+
+static inline TaskJobId makeJobId(uint8_t group, int index) {
+    return (TaskJobId)((group << 8) | index);
+}
+
+static inline bool splitJobId(TaskJobId job, uint8_t &group, int &index) {
+    if (job < 0) return false;
+    group = (uint8_t)(job >> 8);
+    index = job & 0xFF;
+    return group < TASK_COUNT;
+}
+
+/**
+ * @brief Registers a job with a task.
+ */
+TaskJobId task_register(TaskGroup group, const char* name, TaskHandlerFn fn, uint32_t intervalMs) {
+    if (group >= TASK_COUNT) return TASK_JOB_INVALID;
+
+    TaskConfig &t = tasks[group];
+    int index = sched_add(t.sched, name, fn, intervalMs, millis());
+    if (index < 0) {
+        LOG_ERROR("Task: cannot register %s in %s", name, t.name);
+        return TASK_JOB_INVALID;
+    }
+
+    return makeJobId(group, index);
+}
+
+/**
+ * @brief Task body: runs all due jobs, then sleeps until the next deadline.
+ *
+ * The sleep is a task notification wait, so task_trigger() ends it early.
+ * If a wake-up takes longer than the budget the slowest job is logged
+ * (at most every 10 s per task to avoid flooding the log).
+ */
+static void taskRunner(void* param) {
+    TaskConfig &t = *static_cast<TaskConfig*>(param);
+#if TASK_PROFILE
+    const uint32_t budgetCycles = t.budgetUs * ESP.getCpuFreqMHz();
+#endif
+
+    for (;;) {
+        uint32_t start = micros();
+        uint32_t slowest = 0;
+        const char* slowestName = "";
+
+#if TASK_PROFILE
+        if (t.profileReset.exchange(false, std::memory_order_acquire)) {
+            for (uint8_t j = 0; j < SCHED_MAX_JOBS; j++) prof_reset(t.profile[j]);
+        }
+#endif
+
+        // Bounded, so a job that is always due cannot starve the sleep below
+        for (uint8_t n = 0; n < t.sched.count; n++) {
+            int i = sched_nextDue(t.sched, millis());
+            if (i < 0) break;
+
+            uint32_t jStart = micros();
+#if TASK_PROFILE
+            uint32_t cStart = ESP.getCycleCount();     // per core, tasks are pinned
+            t.sched.jobs[i].fn();
+            prof_record(t.profile[i], ESP.getCycleCount() - cStart, budgetCycles);
+#else
+            t.sched.jobs[i].fn();
+#endif
+            uint32_t jTime = micros() - jStart;
+
+            if (jTime > slowest) {
+                slowest = jTime;
+                slowestName = t.sched.jobs[i].name;
+            }
+        }
+
+        uint32_t elapsed = micros() - start;
+        metric_observe(t.wakeTime, elapsed);
+        if (elapsed > t.budgetUs) {
+            t.overruns++;
+            uint32_t now = millis();
+            if (now - t.lastOverrunLog > 10000) {
+                t.lastOverrunLog = now;
+                LOG_WARN("Task: %s overrun %luus (budget %luus, slowest %s %luus)",
+                     t.name, (unsigned long)elapsed, (unsigned long)t.budgetUs,
+                     slowestName, (unsigned long)slowest);
+            }
+        }
+
+        uint32_t wait = sched_timeToNext(t.sched, millis());
+        ulTaskNotifyTake(pdTRUE, wait == SCHED_NO_DEADLINE ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+    }
+}
+
+#if TASK_PROFILE
+/**
+ * @brief Writes one table row per job.
+ */
+void task_profileWrite(Print &out) {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+
+    out.printf("%-12s %-12s %8s %8s %8s %8s %8s %8s\n",
+               "task", "job", "runs", "min_us", "avg_us", "p99_us", "max_us", "overrun");
+    for (uint8_t g = 0; g < TASK_COUNT; g++) {
+        const TaskConfig &t = tasks[g];
+        for (uint8_t i = 0; i < t.sched.count; i++) {
+            const ProfStats &p = t.profile[i];
+            out.printf("%-12s %-12s %8lu %8lu %8lu %8lu %8lu %8lu\n",
+                       t.name, t.sched.jobs[i].name, (unsigned long)p.count,
+                       (unsigned long)(p.count ? p.minCycles / mhz : 0),
+                       (unsigned long)(prof_average(p) / mhz),
+                       (unsigned long)(prof_percentile(p, 990) / mhz),
+                       (unsigned long)(p.maxCycles / mhz),
+                       (unsigned long)p.overruns);
+        }
+    }
+}
+
+void task_profileReset() {
+    for (uint8_t g = 0; g < TASK_COUNT; g++) {
+        tasks[g].profileReset.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Log job: periodic summary, the /profile table on the serial
+ *        console and one line per job in the log.
+ */
+static void profileReport() {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+
+    // Directly on Serial: the log reaches it only with LOG_TO_SERIAL
+    Serial.println("--- Profile ---");
+    task_profileWrite(Serial);
+
+    for (uint8_t g = 0; g < TASK_COUNT; g++) {
+        const TaskConfig &t = tasks[g];
+        for (uint8_t i = 0; i < t.sched.count; i++) {
+            const ProfStats &p = t.profile[i];
+            if (p.count == 0) continue;
+            LOG_INFO("Profile: %s/%s n=%lu avg=%luus p99=%luus max=%luus overruns=%lu",
+                     t.name, t.sched.jobs[i].name, (unsigned long)p.count,
+                     (unsigned long)(prof_average(p) / mhz),
+                     (unsigned long)(prof_percentile(p, 990) / mhz),
+                     (unsigned long)(p.maxCycles / mhz),
+                     (unsigned long)p.overruns);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Creates and starts all tasks that have at least one job.
+ */
+void task_start() {
+#if TASK_PROFILE
+    for (uint8_t g = 0; g < TASK_COUNT; g++) {
+        for (uint8_t j = 0; j < SCHED_MAX_JOBS; j++) prof_reset(tasks[g].profile[j]);
+    }
+    task_register(TASK_LOG, "profile", profileReport, TASK_PROFILE_REPORT_MS);
+#endif
+
+    // All metrics before the first task runs
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        TaskConfig &t = tasks[i];
+        if (t.sched.count == 0 || t.handle != nullptr) continue;
+        metrics_register("cover_task_wakeup_duration_us", "Run time of all due jobs per task wake-up",
+                         TASK_LABELS[i], t.wakeTime, WAKE_BOUNDS_US);
+    }
+
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        TaskConfig &t = tasks[i];
+        if (t.sched.count == 0 || t.handle != nullptr) continue;
+
+        BaseType_t ok = xTaskCreatePinnedToCore(
+            taskRunner, t.name, t.stackSize, &t, t.priority, &t.handle, t.core);
+
+        if (ok != pdPASS) {
+            LOG_ERROR("Task: failed to start %s", t.name);
+            t.handle = nullptr;
+            continue;
+        }
+        LOGF("Task: %s started on core %d (%u jobs)", t.name, (int)t.core, t.sched.count);
+    }
+    started.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Returns true once task_start() has run.
+ */
+bool task_started() {
+    return started.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Requests a job to run as soon as possible and wakes its task.
+ */
+void task_trigger(TaskJobId job) {
+    uint8_t group;
+    int index;
+    if (!splitJobId(job, group, index)) return;
+
+    TaskConfig &t = tasks[group];
+    sched_trigger(t.sched, index);
+    if (t.handle != nullptr) {
+        xTaskNotifyGive(t.handle);
+    }
+}
+
+/**
+ * @brief ISR variant of task_trigger().
+ */
+void IRAM_ATTR task_triggerFromISR(TaskJobId job) {
+    uint8_t group;
+    int index;
+    if (!splitJobId(job, group, index)) return;
+
+    // Inline store instead of sched_trigger(): ISR code must stay in IRAM
+    TaskConfig &t = tasks[group];
+    if (index >= t.sched.count) return;
+    t.sched.jobs[index].triggered.store(true, std::memory_order_release);
+    if (t.handle != nullptr) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(t.handle, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * @brief Runs a job once after a delay (owning task only).
+ */
+void task_runIn(TaskJobId job, uint32_t delayMs) {
+    uint8_t group;
+    int index;
+    if (!splitJobId(job, group, index)) return;
+
+    sched_runIn(tasks[group].sched, index, delayMs, millis());
+}
+
+/**
+ * @brief Returns the number of task wake-ups that exceeded the budget.
+ */
+uint32_t task_getOverruns(TaskGroup group) {
+    if (group >= TASK_COUNT) return 0;
+    return tasks[group].overruns;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file task_manager.h
+ * @brief Task-based runtime replacing the monolithic loop()
+ *
+ * Jobs are grouped into a few FreeRTOS tasks, each pinned to a core:
+ *  - TASK_IO:     USB cover communication
+ *  - TASK_SENSOR: BME280 and dew heater control
+ *  - TASK_UI:     buttons, poti, LEDs and OLED
+ *  - TASK_NET:    WiFi, OTA and scheduled actions
+ *  - TASK_LOG:    drains the log ring buffer to its sinks
+ *
+ * Every task owns a deadline scheduler (scheduler.h). It sleeps until the
+ * earliest job deadline or until an event (ISR, other task) triggers a job,
+ * so an idle system does not wake up at all between deadlines.
+ * A slow job (e.g. a WiFi scan or an OLED redraw) only delays the
+ * jobs of its own task.
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Per-job run-time profiling (1 = on, 0 = removed from the binary)
+ */
+#ifndef TASK_PROFILE
+#define TASK_PROFILE 0
+#endif
+
+/**
+ * @brief Interval of the profile summary on Serial and in the log (ms)
+ */
+#define TASK_PROFILE_REPORT_MS 60000
+
+/**
+ * @enum TaskGroup
+ * @brief Logical task a job is assigned to
+ */
+enum TaskGroup {
+    TASK_IO = 0,
+    TASK_SENSOR,
+    TASK_UI,
+    TASK_NET,
+    TASK_LOG,
+    TASK_COUNT
+};
+
+/**
+ * @brief Handler function called by its task
+ */
+typedef void (*TaskHandlerFn)();
+
+/**
+ * @brief Handle of a registered job (-1 = invalid)
+ */
+typedef int16_t TaskJobId;
+
+#define TASK_JOB_INVALID ((TaskJobId)-1)
+
+/**
+ * @brief Registers a job with a task.
+ *
+ * Periodic jobs run for the first time when the task starts.
+ * Should be called from setup() before task_start().
+ *
+ * @param group      Task the job runs in
+ * @param name       Job name (used for overrun logging)
+ * @param fn         Job function
+ * @param intervalMs Period in ms, 0 = run only when triggered
+ * @return Job handle, TASK_JOB_INVALID if the job table is full
+ */
+TaskJobId task_register(TaskGroup group, const char* name, TaskHandlerFn fn, uint32_t intervalMs);
+
+/**
+ * @brief Creates and starts all tasks that have at least one job.
+ *
+ * Must be called once at the end of setup().
+ */
+void task_start();
+
+/**
+ * @brief Returns true once task_start() has run.
+ */
+bool task_started();
+
+/**
+ * @brief Requests a job to run as soon as possible and wakes its task.
+ *
+ * Safe to call from any task.
+ *
+ * @param job Job handle
+ */
+void task_trigger(TaskJobId job);
+
+/**
+ * @brief ISR variant of task_trigger().
+ *
+ * @param job Job handle
+ */
+void task_triggerFromISR(TaskJobId job);
+
+/**
+ * @brief Runs a job once after a delay (earlier than its regular deadline).
+ *
+ * Must only be called from the task that owns the job,
+ * e.g. by a job re-scheduling itself.
+ *
+ * @param job     Job handle
+ * @param delayMs Delay in ms
+ */
+void task_runIn(TaskJobId job, uint32_t delayMs);
+
+/**
+ * @brief Returns the number of task wake-ups that exceeded the budget.
+ *
+ * @param group Task group
+ * @return Overrun count since start
+ */
+uint32_t task_getOverruns(TaskGroup group);
+
+#if TASK_PROFILE
+/**
+ * @brief Writes the run-time statistics of all jobs as a text table.
+ *
+ * Columns: task, job, runs, min/avg/p99/max in us and the number of runs
+ * longer than the budget of the task.
+ *
+ * @param out Destination, e.g. an AsyncResponseStream
+ */
+void task_profileWrite(Print &out);
+
+/**
+ * @brief Clears the statistics (applied by each task on its next wake-up).
+ */
+void task_profileReset();
+#endif
@@ -5,6 +5,8 @@
  * Handles NTP time synchronization and scheduled actions such as auto-closing the cover.
  */
 
+#define LOG_MODULE LOG_MOD_TIME
+
 #include "time_manager.h"
 #include "led_manager.h"
 #include "pins.h"
@@ -26,6 +28,16 @@ void initTimeManager() {
     LOG("Time Manager initialised");
 }
 
+/**
+ * @brief Local time without waiting for NTP
+ *
+ * getLocalTime() waits up to 5 s by default while the time is not synced,
+ * which is the normal case without WiFi; the callers run on shared tasks.
+ */
+static bool localTimeNow(struct tm &timeinfo) {
+    return getLocalTime(&timeinfo, 0);
+}
+
 /**
  * @brief Returns the current time as a string in HH:MM format.
  *
@@ -33,7 +45,7 @@ void initTimeManager() {
  */
 String getTimeString() {
     struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
+    if (!localTimeNow(timeinfo)) {
         return "00:00";
     }
 
@@ -51,7 +63,7 @@ String getTimeString() {
  */
 bool getTime(int &hour, int &minute) {
     struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
+    if (!localTimeNow(timeinfo)) {
         return false;
     }
 
@@ -67,13 +79,14 @@ bool getTime(int &hour, int &minute) {
  * Ensures the action is only executed once per day.
  */
 void checkScheduledActions() {
-    if (!autoCloseCover) return;
+    ConfigData config = config_get();
+    if (!config.autoCloseCover) return;
 
     int hour, minute;
     if (!getTime(hour, minute)) return;
 
     struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) return;
+    if (!localTimeNow(timeinfo)) return;
 
     int today = timeinfo.tm_mday;
 
@@ -85,8 +98,8 @@ void checkScheduledActions() {
 
     if (actionExecutedToday) return;
 
-    if (hour == autoCloseHour &&
-        minute == autoCloseMinute) {
+    if (hour == config.autoCloseHour &&
+        minute == config.autoCloseMinute) {
 
         LOG("Scheduled auto-close triggered!");
 
@@ -9,6 +9,11 @@ struct ScheduledConfig {
 
 };
 
+/**
+ * @brief Interval for checking scheduled actions (ms)
+ */
+#define SCHEDULE_CHECK_INTERVAL_MS 10000
+
 /**
  * @brief Initializes the time manager and sets up NTP synchronization.
  */
@@ -1,37 +1,78 @@
+#define LOG_MODULE LOG_MOD_USB
+
 #include "usb_manager.h"
 #include <USBHostSerial.h>
-#include <string.h>  // For strlen, strcpy, strtok, strcmp
-#include <stdlib.h>  // For atof, atoi
+#include <string.h>  // For strlen
 #include <stdio.h>   // For sprintf
 #include "web_log.h"  // For LOG macro
 #include "led_manager.h"
+#include "wanderer_parser.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include "task_manager.h"
 
 static USBHostSerial usbSerial;
-static char current_status[256] = {0};  // Buffer for the latest raw status message
-static char read_buffer[512] = {0};     // Temporary read buffer
-static size_t buf_idx = 0;
-static WandererStatus parsed_status = {0};  // Parsed status (zero-initialized)
+static WandererParser parser;
 static bool device_connected = false;
 static uint32_t lastmessage = 0;
 
+// Raw line for the log, IO task only
+static char raw_line[WPARSER_MAX_LINE + 1] = {0};
+static size_t raw_idx = 0;
+
+// Parsed status, written only by the IO task
+static Snapshot<WandererStatus> parsed_status;
+
+static MetricCounter linesParsed;
+static MetricCounter parseErrors;
+static MetricCounter connects;
+
+static void registerMetrics() {
+    metrics_register("cover_usb_lines_total", "Valid status lines received from the cover", nullptr, linesParsed);
+    metrics_register("cover_usb_parse_errors_total", "Invalid or overlong status lines", nullptr, parseErrors);
+    metrics_register("cover_usb_connects_total", "Successful USB serial (re)connects", nullptr, connects);
+}
+
+/**
+ * Publishes a change of the connection flag only.
+ */
+static void publish_connection(bool connected) {
+    WandererStatus s = parsed_status.read();
+    if (s.connection_status == connected) return;
+    s.connection_status = connected;
+    parsed_status.publish(s);
+}
+
+/**
+ * Registers the metrics and the polling job (setup, before task_start()).
+ */
+void usb_manager_begin() {
+    registerMetrics();
+    task_register(TASK_IO, "usb", usb_manager_update, USB_POLL_INTERVAL_MS);
+}
+
 /**
  * Initializes the USB serial host connection.
  */
 void usb_manager_init() {
     device_connected = usbSerial.begin(19200, 0, 0, 8);  // Baud 19200, parity none, stop 1, data 8
     if (device_connected) {
+        metric_inc(connects);
         LOG("USB Serial device connected");
         setLedMode(LED_STATUS, LED_MODE_ON);
     } else {
         LOG("USB Serial device not connected");
         setLedMode(LED_STATUS, LED_MODE_BLINK_FAST);
     }  
-    parsed_status.connection_status = device_connected;
+    wparser_reset(parser);
+    raw_idx = 0;
+    publish_connection(device_connected);
 }
 
 /**
  * Non-blocking update function to be called in the main loop.
- * Reads available data byte-by-byte, accumulates until newline, then updates & parses.
+ * Feeds every received byte into the incremental parser, a status is
+ * published only when a complete and valid line was received.
  */
 void usb_manager_update() {
     uint32_t now = millis();
@@ -45,7 +86,7 @@ void usb_manager_update() {
     if(now - lastmessage > 5000) {
         // No message received for 5 seconds
         device_connected = false;
-        parsed_status.connection_status = device_connected;
+        publish_connection(device_connected);
         setLedMode(LED_STATUS, LED_MODE_BLINK_FAST);
     };
 
@@ -55,64 +96,39 @@ void usb_manager_update() {
 
         lastmessage = now;
 
-        if (buf_idx < sizeof(read_buffer) - 1) {
-            read_buffer[buf_idx++] = (char)c;
-        }
-        strcpy(current_status, read_buffer);      // Save raw message
-        if(buf_idx > 200) {
-            //string too long, re-init USB
-            device_connected = false;
-            parsed_status.connection_status = device_connected;
-            setLedMode(LED_STATUS, LED_MODE_BLINK_FAST);
+        if (c != '\n' && c != '\r' && raw_idx < WPARSER_MAX_LINE) {
+            raw_line[raw_idx++] = (char)c;
         }
 
-        if ((char)c == '\n') {
-            read_buffer[buf_idx] = '\0';              // Null-terminate
-            strcpy(current_status, read_buffer);      // Save raw message
-            LOG("Received cover status: " + String(current_status));
-
-            // Parse status – expected format: WandererCoverV4Afield1Afield2A...Afield8
-            char temp[256];
-            strcpy(temp, current_status);
-
-            char* token = strtok(temp, "A");
-            if (token && strcmp(token, "WandererCoverV4") == 0) {
-                // Field 1: Firmware version (YYYYMMDD)
-                token = strtok(NULL, "A");
-                if (token) strncpy(parsed_status.firmware, token, sizeof(parsed_status.firmware) - 1);
-
-                // Field 2: Close position (°)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.close_position = atof(token);
-
-                // Field 3: Open position (°)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.open_position = atof(token);
-
-                // Field 4: Current position (°)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.current_position = atof(token);
-
-                // Field 5: Input voltage (V)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.input_voltage = atof(token);
+        switch (wparser_feed(parser, (char)c)) {
+        case WPARSE_PENDING:
+            break;
 
-                // Field 6: Flat panel brightness (0-255)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.brightness = (int)atoi(token);
+        case WPARSE_OK:
+            raw_line[raw_idx] = '\0';
+            raw_idx = 0;
+            metric_inc(linesParsed);
 
-                // Field 7: Dew heater power (0/50/100/150)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.dew_heater = (int)atoi(token);
+            parser.status.connection_status = device_connected;
+            parsed_status.publish(parser.status);
+            LOG_DEBUG("Received cover status: %s", raw_line);
+            break;
 
-                // Field 8: ASIAIR control enabled (0/1)
-                token = strtok(NULL, "A");
-                if (token) parsed_status.asiair_enabled = (int)atoi(token);
+        case WPARSE_ERROR:
+            raw_line[raw_idx] = '\0';
+            LOG_WARN("Invalid cover status: %s", raw_line);
+            raw_idx = 0;
+            metric_inc(parseErrors);
+            break;
 
-                parsed_status.connection_status = device_connected;
-            }
-
-            buf_idx = 0;  // Reset for next message
+        case WPARSE_OVERFLOW:
+            //string too long, re-init USB
+            raw_idx = 0;
+            metric_inc(parseErrors);
+            device_connected = false;
+            publish_connection(device_connected);
+            setLedMode(LED_STATUS, LED_MODE_BLINK_FAST);
+            break;
         }
     }
 }
@@ -124,7 +140,7 @@ static void send_command(uint32_t value) {
     char cmd[16];
     sprintf(cmd, "%u", value);
     usbSerial.write((const uint8_t*)cmd, strlen(cmd));
-    LOG("Sent command: " + String(cmd));
+    LOGF("Sent command: %s", cmd);
 }
 
 /**
@@ -157,16 +173,9 @@ void usb_manager_turn_off_light() {
     send_command(9999);
 }
 
-/**
- * Get raw status string
- */
-const char* usb_manager_get_status() {
-    return current_status;
-}
-
 /**
  * Get parsed status struct
  */
-const WandererStatus* usb_manager_get_parsed_status() {
-    return &parsed_status;
+WandererStatus usb_manager_get_parsed_status() {
+    return parsed_status.read();
 }
\ No newline at end of file
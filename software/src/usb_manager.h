@@ -17,14 +17,27 @@ typedef struct {
     bool connection_status; // Connection status
 } WandererStatus;
 
+/**
+ * Polling interval of usb_manager_update() in ms.
+ * USBHostSerial buffers incoming data, at 19200 baud ~40 bytes arrive per 20 ms.
+ */
+#define USB_POLL_INTERVAL_MS 20
+
+/**
+ * Registers the metrics and the polling job in the IO task.
+ * Call in setup() before task_start(); the connection is opened by the job.
+ */
+void usb_manager_begin();
+
 /**
  * Initializes the USB serial host connection for the WandererCover protocol.
  */
 void usb_manager_init();
 
 /**
- * Non-blocking update function to be called in the main loop.
- * Reads incoming data, processes status messages (updates on newline), and parses them.
+ * Non-blocking update function, runs every USB_POLL_INTERVAL_MS in the IO task.
+ * Reads incoming data and parses it incrementally (see wanderer_parser.h),
+ * a new status is published only after a complete valid line.
  */
 void usb_manager_update();
 
@@ -49,17 +62,12 @@ void usb_manager_set_brightness(int level);
  */
 void usb_manager_turn_off_light();
 
-/**
- * Gets the last received raw status message.
- * @return Pointer to the null-terminated status string (valid until next update).
- */
-const char* usb_manager_get_status();
-
 /**
  * Gets the parsed status structure.
- * @return Pointer to the parsed WandererStatus (updated only on valid messages).
+ * Safe to call from any task, the copy is always consistent.
+ * @return Copy of the parsed WandererStatus (updated only on valid messages).
  */
-const WandererStatus* usb_manager_get_parsed_status();
+WandererStatus usb_manager_get_parsed_status();
 
 #ifdef __cplusplus
 }
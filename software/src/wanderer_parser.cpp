@@ -0,0 +1,162 @@
+/**
+ * @file wanderer_parser.cpp
+ * @brief Single-pass state machine for the WandererCoverV4 status line
+ *
+ * Numbers are accumulated as integer mantissa and decimal scale while the
+ * digits arrive; the float is built with one division at the field end.
+ */
+
+#include "wanderer_parser.h"
+#include <string.h>
+
+static const char HEADER[] = "WandererCoverV4";
+static const uint8_t HEADER_LEN = sizeof(HEADER) - 1;
+static const char SEPARATOR = 'A';
+
+/**
+ * @brief Field numbers (1..8) as sent by the cover
+ */
+enum {
+    F_FIRMWARE = 1,
+    F_CLOSE_POS,
+    F_OPEN_POS,
+    F_CURRENT_POS,
+    F_VOLTAGE,
+    F_BRIGHTNESS,
+    F_DEW_HEATER,
+    F_ASIAIR
+};
+
+static void startField(WandererParser &p) {
+    p.pos = 0;
+    p.negative = false;
+    p.fraction = false;
+    p.mantissa = 0;
+    p.scale = 1;
+}
+
+void wparser_reset(WandererParser &p) {
+    p.field = 0;
+    p.length = 0;
+    p.error = false;
+    startField(p);
+}
+
+/**
+ * @brief Accumulates one character of a numeric field.
+ */
+static void feedNumber(WandererParser &p, char c, bool allowFraction) {
+    if (c >= '0' && c <= '9') {
+        if (p.mantissa > 99999999) {    // more digits than any field needs
+            p.error = true;
+            return;
+        }
+        p.mantissa = p.mantissa * 10 + (c - '0');
+        if (p.fraction) p.scale *= 10;
+    } else if (c == '-' && p.pos == 0) {
+        p.negative = true;
+    } else if (c == '.' && allowFraction && !p.fraction) {
+        p.fraction = true;
+    } else {
+        p.error = true;
+    }
+}
+
+/**
+ * @brief Stores the completed field into the status structure.
+ */
+static void endField(WandererParser &p) {
+    if (p.field == 0) {
+        if (p.pos != HEADER_LEN) p.error = true;
+        return;
+    }
+    if (p.pos == 0) {                   // empty field
+        p.error = true;
+        return;
+    }
+
+    int32_t value = p.negative ? -p.mantissa : p.mantissa;
+    float f = (float)value / (float)p.scale;
+
+    switch (p.field) {
+    case F_FIRMWARE:    /* copied while receiving */      break;
+    case F_CLOSE_POS:   p.status.close_position = f;      break;
+    case F_OPEN_POS:    p.status.open_position = f;       break;
+    case F_CURRENT_POS: p.status.current_position = f;    break;
+    case F_VOLTAGE:     p.status.input_voltage = f;       break;
+    case F_BRIGHTNESS:  p.status.brightness = value;      break;
+    case F_DEW_HEATER:  p.status.dew_heater = value;      break;
+    case F_ASIAIR:      p.status.asiair_enabled = value;  break;
+    default:            p.error = true;                   break;
+    }
+}
+
+WParseResult wparser_feed(WandererParser &p, char c) {
+    if (c == '\r') return WPARSE_PENDING;
+
+    if (c == '\n') {
+        bool valid = false;
+        if (p.length > 0) {
+            endField(p);
+            valid = !p.error && p.field == WPARSER_FIELD_COUNT;
+        }
+        bool empty = (p.length == 0);
+        wparser_reset(p);
+        if (empty) return WPARSE_PENDING;
+        return valid ? WPARSE_OK : WPARSE_ERROR;
+    }
+
+    if (p.length == 0) {
+        memset(p.status.firmware, 0, sizeof(p.status.firmware));
+    }
+    if (++p.length > WPARSER_MAX_LINE) {
+        wparser_reset(p);
+        return WPARSE_OVERFLOW;
+    }
+    if (p.error) return WPARSE_PENDING;   // skip rest of line
+
+    // Header: compare in place, it contains no separator
+    if (p.field == 0) {
+        if (c == SEPARATOR) {
+            endField(p);
+            p.field++;
+            startField(p);
+        } else if (p.pos >= HEADER_LEN || HEADER[p.pos] != c) {
+            p.error = true;
+        } else {
+            p.pos++;
+        }
+        return WPARSE_PENDING;
+    }
+
+    if (c == SEPARATOR) {
+        endField(p);
+        if (p.field >= WPARSER_FIELD_COUNT) {
+            p.error = true;             // too many fields
+        } else {
+            p.field++;
+            startField(p);
+        }
+        return WPARSE_PENDING;
+    }
+
+    switch (p.field) {
+    case F_FIRMWARE:
+        if (p.pos < sizeof(p.status.firmware) - 1) {
+            p.status.firmware[p.pos] = c;
+        }
+        break;
+    case F_CLOSE_POS:
+    case F_OPEN_POS:
+    case F_CURRENT_POS:
+    case F_VOLTAGE:
+        feedNumber(p, c, true);
+        break;
+    default:
+        feedNumber(p, c, false);
+        break;
+    }
+    p.pos++;
+
+    return WPARSE_PENDING;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file wanderer_parser.h
+ * @brief Incremental parser for the WandererCoverV4 status stream
+ *
+ * The cover sends one status line per second:
+ *   WandererCoverV4A<fw>A<close>A<open>A<pos>A<vin>A<bright>A<dew>A<asiair>\n
+ *
+ * Bytes are fed one at a time as they arrive. Every field is decoded in
+ * place (no line copy, no strtok/atof). The result is only complete
+ * after a newline with exactly WPARSER_FIELD_COUNT data fields.
+ *
+ * This file has no Arduino dependency.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "usb_manager.h"
+
+/**
+ * @brief Number of data fields after the "WandererCoverV4" header
+ */
+#define WPARSER_FIELD_COUNT 8
+
+/**
+ * @brief Maximum line length, longer lines are rejected
+ */
+#define WPARSER_MAX_LINE 200
+
+/**
+ * @enum WParseResult
+ * @brief Result of feeding one byte
+ */
+enum WParseResult {
+    WPARSE_PENDING,     ///< Line not finished yet
+    WPARSE_OK,          ///< Valid line completed, result in parser.status
+    WPARSE_ERROR,       ///< Invalid line completed (or too long)
+    WPARSE_OVERFLOW     ///< Line exceeds WPARSER_MAX_LINE without newline
+};
+
+/**
+ * @struct WandererParser
+ * @brief Parser state
+ */
+struct WandererParser {
+    WandererStatus status;  ///< Fields decoded so far (valid after WPARSE_OK)
+    uint8_t field;          ///< Current field, 0 = header
+    uint8_t pos;            ///< Characters in the current field
+    uint16_t length;        ///< Characters in the current line
+    bool error;             ///< Current line is invalid
+    bool negative;          ///< Number sign
+    bool fraction;          ///< Decimal point seen
+    int32_t mantissa;       ///< Digits of the number without decimal point
+    int32_t scale;          ///< 10^(digits after the decimal point)
+};
+
+/**
+ * @brief Resets the parser to the start of a line.
+ *
+ * The last completed status stays readable until the next line starts.
+ */
+void wparser_reset(WandererParser &p);
+
+/**
+ * @brief Feeds one received byte.
+ *
+ * @param p Parser
+ * @param c Received byte
+ * @return Parse result, see WParseResult
+ */
+WParseResult wparser_feed(WandererParser &p, char c);
@@ -0,0 +1,252 @@
+/**
+ * @file web_assets.h
+ * @brief Gzipped web UI, generated by scripts/embed_web.py from web/ - do not edit
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @struct WebAsset
+ * @brief One embedded file
+ */
+struct WebAsset {
+    const char* url;            ///< Request path
+    const char* contentType;    ///< MIME type of the uncompressed file
+    const char* etag;           ///< Quoted hash of the compressed data
+    const uint8_t* data;        ///< Gzipped content (flash)
+    size_t length;              ///< Bytes in data
+};
+
+// config.html: 3213 bytes, 1190 gzipped
+static const uint8_t WEB_CONFIG_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x57, 0x6d, 0x6f, 0xdb, 0x36,
+    0x10, 0xfe, 0xee, 0x5f, 0x71, 0x63, 0x31, 0xd4, 0x02, 0x6c, 0x29, 0x35, 0x86, 0xa0, 0x70, 0x64,
+    0x0f, 0x5b, 0xd2, 0xa1, 0x05, 0xba, 0xb6, 0xb0, 0x0d, 0x14, 0xfb, 0x54, 0xd0, 0x12, 0x25, 0x73,
+    0xa1, 0x49, 0x81, 0xa4, 0xe2, 0x18, 0x45, 0xfe, 0xfb, 0x8e, 0x94, 0x6c, 0x53, 0x8a, 0xdd, 0x74,
+    0x02, 0x5a, 0x59, 0xe4, 0xbd, 0x3e, 0xf7, 0xdc, 0x91, 0x49, 0x7f, 0xb9, 0xfb, 0x7c, 0xbb, 0xfa,
+    0xe7, 0xcb, 0x3b, 0xd8, 0xd8, 0xad, 0x98, 0x0f, 0xd2, 0xc3, 0x8b, 0xd1, 0x1c, 0x5f, 0x5b, 0x66,
+    0x29, 0x64, 0x1b, 0xaa, 0x0d, 0xb3, 0x33, 0x52, 0xdb, 0x62, 0xfc, 0x96, 0xe0, 0xb2, 0xe5, 0x56,
+    0xb0, 0xf9, 0xad, 0x92, 0x05, 0x2f, 0x6b, 0x4d, 0x2d, 0x57, 0x32, 0x4d, 0x9a, 0xc5, 0x41, 0x6a,
+    0xec, 0xde, 0xbd, 0x01, 0x9f, 0xb5, 0xca, 0xf7, 0xf0, 0xdd, 0xff, 0x74, 0x4f, 0xa1, 0xa4, 0x1d,
+    0x17, 0x74, 0xcb, 0xc5, 0x7e, 0x0a, 0x7f, 0x68, 0x4e, 0xc5, 0xcd, 0x71, 0x2f, 0xe7, 0xa6, 0x12,
+    0x14, 0xd7, 0x0b, 0xc1, 0x1e, 0x4f, 0xcb, 0x25, 0xad, 0xa6, 0x30, 0xb9, 0xaa, 0x82, 0xa5, 0x8a,
+    0xe6, 0x39, 0x97, 0x65, 0xb8, 0xfc, 0xe4, 0xff, 0x8f, 0x05, 0x2b, 0x6c, 0xe0, 0x6e, 0xc7, 0x73,
+    0xbb, 0x99, 0xc2, 0xf5, 0xd5, 0xaf, 0x1d, 0x29, 0xcd, 0xcb, 0xcd, 0x19, 0xb1, 0xdf, 0xba, 0x62,
+    0x96, 0x3d, 0x5a, 0xaa, 0x19, 0x7d, 0x2e, 0xf8, 0xe6, 0xea, 0x20, 0xe9, 0x9e, 0x0d, 0x73, 0xe6,
+    0x9c, 0x7a, 0x27, 0xc8, 0x4e, 0xaa, 0x5b, 0x25, 0x95, 0xa9, 0x68, 0xc6, 0x42, 0x07, 0xeb, 0xda,
+    0x5a, 0x25, 0x03, 0xf3, 0x5b, 0xaa, 0x4b, 0x2e, 0xc7, 0x56, 0x55, 0xce, 0xc7, 0xd9, 0x8c, 0xdf,
+    0x56, 0x8f, 0xf0, 0xe6, 0xba, 0x9b, 0xb5, 0xa5, 0x6b, 0xc1, 0x5e, 0x8a, 0x72, 0xad, 0x74, 0xce,
+    0xf4, 0x38, 0x53, 0x42, 0xd0, 0xca, 0xb0, 0x29, 0x1c, 0x7e, 0xdd, 0xbc, 0xe0, 0xbe, 0xf5, 0xb1,
+    0x19, 0x81, 0xcd, 0x03, 0x27, 0x8d, 0x3d, 0x14, 0xc4, 0x80, 0x8c, 0x12, 0x3c, 0x87, 0x57, 0x59,
+    0x96, 0x9d, 0x89, 0xf8, 0xda, 0x45, 0xdc, 0x49, 0xc6, 0x01, 0x3b, 0xa6, 0x82, 0x97, 0x72, 0x0a,
+    0xae, 0x60, 0x5d, 0x3f, 0xa1, 0x0f, 0x9a, 0xdd, 0x97, 0x5a, 0xd5, 0x32, 0x9f, 0xc2, 0x2b, 0xc6,
+    0x8e, 0xe0, 0xa5, 0x49, 0xcb, 0xb0, 0x34, 0x69, 0x59, 0xea, 0x68, 0xd6, 0x10, 0x2e, 0xcd, 0xf9,
+    0x03, 0x64, 0x82, 0x1a, 0x33, 0x23, 0xce, 0x38, 0x99, 0x1f, 0xcd, 0xa5, 0x9b, 0x49, 0x9f, 0xb1,
+    0xb8, 0x72, 0xda, 0x3e, 0x16, 0x9c, 0xe7, 0x33, 0x92, 0x15, 0x25, 0x99, 0x7f, 0x54, 0xd4, 0x25,
+    0x11, 0xc7, 0x31, 0x92, 0xbb, 0xdd, 0x9d, 0xa7, 0x6b, 0x1d, 0x28, 0xb5, 0x45, 0x54, 0x32, 0x13,
+    0x3c, 0xbb, 0x9f, 0x11, 0x43, 0x1f, 0x58, 0xe3, 0x64, 0x18, 0x91, 0xf9, 0x12, 0xbf, 0xa0, 0xf9,
+    0x4c, 0x93, 0x46, 0x34, 0xd0, 0xad, 0x34, 0xf3, 0xbe, 0x9c, 0xce, 0x82, 0x99, 0x5a, 0x60, 0xb4,
+    0x69, 0x82, 0xab, 0x81, 0x4c, 0xa1, 0xf4, 0x16, 0x68, 0xe6, 0xc2, 0x9d, 0x91, 0x44, 0x33, 0x81,
+    0x21, 0x7d, 0xcb, 0xbc, 0x45, 0x02, 0xd8, 0x9c, 0x1b, 0x85, 0x06, 0xbe, 0x7c, 0x5e, 0xae, 0x82,
+    0x44, 0xc3, 0xc0, 0xec, 0xbe, 0x62, 0xe8, 0xa1, 0x5e, 0x6f, 0x39, 0x5a, 0x5f, 0x78, 0xfd, 0xcb,
+    0x11, 0x25, 0xce, 0x5d, 0x0b, 0x64, 0x82, 0x48, 0xce, 0x07, 0xcf, 0x40, 0xf5, 0xcd, 0xd3, 0x43,
+    0xf5, 0x2b, 0xff, 0x8b, 0xc3, 0x27, 0x66, 0x77, 0x4a, 0xdf, 0x9b, 0x3e, 0xaa, 0x8e, 0x9d, 0xbd,
+    0xd8, 0xac, 0x2f, 0x5b, 0x6a, 0x35, 0xfe, 0xdb, 0xcc, 0x97, 0xcb, 0x0f, 0x77, 0x88, 0xef, 0xc6,
+    0x7f, 0x2c, 0xf0, 0xab, 0xf9, 0x48, 0xdc, 0x76, 0xd2, 0x88, 0xf6, 0xd4, 0xfd, 0x54, 0x71, 0xc8,
+    0xed, 0x78, 0xc1, 0x49, 0x6b, 0x28, 0x77, 0x94, 0xc6, 0x26, 0x43, 0x9c, 0x26, 0xbd, 0xd2, 0xe5,
+    0x47, 0x6b, 0x27, 0xa2, 0x34, 0x39, 0xf6, 0xa2, 0x7b, 0x56, 0x4e, 0xcd, 0x4c, 0x46, 0xe5, 0x57,
+    0x74, 0xe3, 0xca, 0xb9, 0xf0, 0x5f, 0xd0, 0x4b, 0x37, 0x44, 0xf1, 0x80, 0x5a, 0x6a, 0x32, 0xcd,
+    0x2b, 0x3b, 0x1f, 0x50, 0xb3, 0x97, 0x19, 0x14, 0xb5, 0xf4, 0x25, 0x04, 0x07, 0xff, 0x81, 0x1e,
+    0x2d, 0xd3, 0xad, 0x0e, 0x27, 0x24, 0x96, 0xd6, 0x58, 0xd0, 0x30, 0x03, 0xba, 0xa3, 0xdc, 0x42,
+    0xc1, 0x6c, 0xb6, 0x19, 0x92, 0xa4, 0x29, 0x79, 0x6c, 0x1f, 0x2d, 0x89, 0x82, 0x99, 0xa9, 0xb2,
+    0x7a, 0xcb, 0xa4, 0x8d, 0x4b, 0x66, 0xdf, 0x09, 0xe6, 0x7e, 0xfe, 0xb9, 0xff, 0x90, 0x0f, 0x3d,
+    0x7d, 0xa3, 0xf8, 0x81, 0x8a, 0x9a, 0xa1, 0x29, 0x1d, 0xab, 0x7b, 0xf8, 0xbd, 0xb5, 0xa8, 0x63,
+    0x47, 0x65, 0x74, 0x3f, 0x05, 0x72, 0xab, 0x6a, 0x91, 0x83, 0x54, 0x16, 0x54, 0xc5, 0x24, 0x04,
+    0x4e, 0xda, 0x5e, 0x83, 0x8c, 0xa2, 0x7f, 0x18, 0xb2, 0x28, 0x88, 0xf1, 0x27, 0xbd, 0xbe, 0x6c,
+    0x7d, 0xf0, 0x34, 0xe8, 0x03, 0x14, 0xf6, 0x4f, 0xeb, 0xb2, 0x85, 0xc4, 0x37, 0x08, 0x9a, 0xbd,
+    0xe8, 0x3d, 0x68, 0xa3, 0x16, 0xa2, 0x2e, 0xb4, 0x49, 0x02, 0x0b, 0xba, 0xf3, 0x47, 0xd2, 0x08,
+    0x8c, 0xc5, 0x5e, 0xde, 0xb2, 0x1c, 0xac, 0xc2, 0xa1, 0xc3, 0x60, 0x79, 0x87, 0xa9, 0xea, 0x1c,
+    0x86, 0x0e, 0x9c, 0x04, 0x0f, 0x22, 0xee, 0x03, 0xb6, 0xf8, 0x46, 0x1a, 0x01, 0x99, 0x11, 0xd8,
+    0xf9, 0x74, 0xd6, 0x0c, 0x67, 0x1b, 0x9e, 0x86, 0x39, 0x50, 0x03, 0x14, 0x5c, 0xc3, 0x44, 0x2f,
+    0x56, 0xcf, 0x85, 0x76, 0xe8, 0xda, 0x51, 0x10, 0x92, 0x1f, 0xbb, 0xbe, 0x89, 0xb1, 0x18, 0xbe,
+    0x8b, 0x47, 0x9d, 0x3d, 0x47, 0x7e, 0xa6, 0xcd, 0x14, 0xbe, 0x3b, 0x34, 0xa5, 0xc5, 0x5c, 0xc7,
+    0x2b, 0xec, 0x68, 0x82, 0xe2, 0xb4, 0xaa, 0x90, 0xa3, 0x7e, 0x90, 0x25, 0x2a, 0xb3, 0xcc, 0x8e,
+    0x9b, 0x9c, 0x08, 0x3c, 0x75, 0x8d, 0xb8, 0x84, 0xa7, 0x3f, 0x55, 0xb4, 0xa3, 0xda, 0x53, 0xc0,
+    0xb1, 0x06, 0xf8, 0x98, 0x4b, 0xc9, 0xf4, 0x0a, 0xc1, 0x39, 0xf1, 0x89, 0xb8, 0xf1, 0x96, 0x13,
+    0x24, 0x52, 0x97, 0x59, 0x27, 0x5d, 0x5e, 0xc0, 0xd0, 0x09, 0x47, 0x1d, 0xe2, 0xff, 0x88, 0x5b,
+    0x67, 0xbc, 0x79, 0x37, 0x50, 0x50, 0x2e, 0xd0, 0xd9, 0x65, 0xe6, 0x38, 0x0f, 0x4d, 0xa3, 0x76,
+    0x78, 0xe3, 0x67, 0xc5, 0x0f, 0x58, 0xe3, 0x47, 0xc8, 0x59, 0xbe, 0x5c, 0x2a, 0xa6, 0xd3, 0x48,
+    0x64, 0xdb, 0xfe, 0x61, 0x37, 0x36, 0x0a, 0x82, 0x1b, 0x7b, 0xd4, 0xd1, 0xf1, 0xbf, 0x46, 0xc9,
+    0xe1, 0x33, 0x21, 0x37, 0x47, 0x3c, 0xb1, 0x66, 0x0e, 0x20, 0x63, 0xa9, 0xad, 0x0d, 0xcc, 0x66,
+    0x78, 0xa3, 0x99, 0x44, 0x37, 0x07, 0xb6, 0xfa, 0x61, 0x63, 0x2c, 0x17, 0x02, 0x74, 0xed, 0xc5,
+    0x47, 0x50, 0xe1, 0xb1, 0x0d, 0xb4, 0x44, 0x5a, 0x76, 0x40, 0x3e, 0xd8, 0x8b, 0x00, 0xef, 0x69,
+    0x2b, 0xbe, 0x65, 0xaa, 0xb6, 0xc3, 0x03, 0x22, 0x23, 0x77, 0x17, 0xb8, 0x8a, 0xc2, 0xcb, 0x40,
+    0xbe, 0x6f, 0x20, 0x7e, 0xbf, 0xfa, 0xfb, 0xa3, 0x83, 0x98, 0x74, 0x6b, 0xe6, 0x72, 0xc0, 0xcb,
+    0x94, 0x2c, 0xf1, 0x3c, 0xc6, 0xa8, 0xae, 0xa2, 0x1e, 0x67, 0x9f, 0x19, 0x38, 0xe6, 0x83, 0xac,
+    0xe8, 0x8f, 0xe3, 0xd7, 0x93, 0xd7, 0xf3, 0x65, 0xbb, 0xdf, 0x99, 0xc7, 0xa4, 0x63, 0xf3, 0xf2,
+    0x33, 0x3d, 0x6f, 0xf3, 0x93, 0x82, 0x43, 0x15, 0xb0, 0x0d, 0xf1, 0x96, 0x10, 0x58, 0xbe, 0xe9,
+    0x98, 0xd6, 0xcc, 0xd6, 0x5a, 0x9e, 0xd6, 0x9e, 0x82, 0x5b, 0x9a, 0x86, 0x61, 0x53, 0x12, 0x9c,
+    0xfa, 0x85, 0x2f, 0x5e, 0x3f, 0xd9, 0x96, 0x07, 0x6a, 0x87, 0x79, 0xb6, 0x89, 0x1b, 0xa6, 0xed,
+    0x42, 0xed, 0xc2, 0xba, 0x7a, 0x3f, 0x6a, 0xd7, 0x6e, 0xde, 0x32, 0x21, 0x86, 0x51, 0x87, 0xc6,
+    0x32, 0x36, 0x86, 0xe7, 0xff, 0x4b, 0x41, 0xa3, 0x46, 0x3f, 0xea, 0xf3, 0x6d, 0xe3, 0x62, 0x54,
+    0x82, 0xc5, 0x42, 0x95, 0x43, 0xe2, 0xcf, 0x27, 0x4f, 0xc3, 0xb6, 0x69, 0x46, 0xc0, 0xa2, 0xcb,
+    0x8d, 0x13, 0x9e, 0x71, 0xad, 0xc9, 0x2e, 0xe1, 0x1b, 0x81, 0x6f, 0xbe, 0x53, 0x70, 0x7a, 0xf5,
+    0x26, 0xd6, 0x71, 0x58, 0x9c, 0x1a, 0xf0, 0xc6, 0x79, 0xe9, 0x76, 0x7c, 0xb8, 0x89, 0xf7, 0xb7,
+    0xf6, 0x74, 0xc4, 0xc3, 0xd3, 0x1f, 0xc8, 0x78, 0x67, 0xf0, 0x7f, 0x75, 0xfc, 0x07, 0x38, 0x9d,
+    0x32, 0x72, 0x8d, 0x0c, 0x00, 0x00,
+};
+
+// index.html: 6748 bytes, 1817 gzipped
+static const uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x59, 0xfd, 0x6e, 0xdb, 0x38,
+    0x12, 0xff, 0xdf, 0x4f, 0x31, 0xa7, 0xc5, 0x01, 0x32, 0xce, 0xdf, 0xe9, 0x16, 0x5d, 0x27, 0xf1,
+    0x21, 0x75, 0x1d, 0x6c, 0x16, 0xb9, 0x38, 0x58, 0x07, 0x5d, 0x14, 0x8b, 0x83, 0x41, 0x4b, 0x94,
+    0xcd, 0x56, 0x22, 0x05, 0x92, 0xb2, 0xe3, 0x6b, 0xf3, 0x4e, 0xf7, 0x0c, 0xfb, 0x64, 0x3b, 0xa4,
+    0x64, 0x59, 0xb6, 0xe5, 0x44, 0x4e, 0x1b, 0x23, 0xb1, 0xc4, 0x19, 0xfd, 0x38, 0x5f, 0x1c, 0xfe,
+    0xa8, 0x5c, 0xfc, 0xe3, 0xc3, 0x78, 0xf8, 0xf0, 0xe9, 0x7e, 0x04, 0x0b, 0x1d, 0x85, 0x83, 0xda,
+    0xc5, 0xe6, 0x8b, 0x12, 0x1f, 0xbf, 0x22, 0xaa, 0x09, 0x78, 0x0b, 0x22, 0x15, 0xd5, 0x97, 0x4e,
+    0xa2, 0x83, 0xe6, 0x3b, 0x07, 0x87, 0x35, 0xd3, 0x21, 0x1d, 0x4c, 0x34, 0xd1, 0x89, 0xba, 0x68,
+    0xa7, 0x77, 0xb5, 0x0b, 0xa5, 0xd7, 0xe6, 0x1b, 0xf0, 0x67, 0x26, 0xfc, 0x35, 0x7c, 0xb5, 0x97,
+    0xe6, 0x27, 0x10, 0x5c, 0x37, 0x03, 0x12, 0xb1, 0x70, 0xdd, 0x87, 0x2b, 0xc9, 0x48, 0xd8, 0x00,
+    0x45, 0xb8, 0x6a, 0x2a, 0x2a, 0x59, 0x70, 0x9e, 0xeb, 0xcd, 0x88, 0xf7, 0x65, 0x2e, 0x45, 0xc2,
+    0xfd, 0x3e, 0xfc, 0xd4, 0xed, 0x76, 0xb7, 0x12, 0x4f, 0x84, 0x42, 0xe2, 0x20, 0xa5, 0x74, 0x3b,
+    0x18, 0x11, 0x39, 0x67, 0xbc, 0x0f, 0x9d, 0xed, 0x50, 0x4c, 0x7c, 0x9f, 0xf1, 0x79, 0x1f, 0x7a,
+    0x9d, 0xf8, 0x31, 0x1d, 0x7e, 0xb2, 0x7f, 0x17, 0xdd, 0x82, 0x3d, 0xe9, 0x83, 0xcd, 0x99, 0xd0,
+    0x5a, 0x44, 0x7d, 0xe8, 0xee, 0xe9, 0xb6, 0xe6, 0x92, 0xf9, 0x05, 0x75, 0x9f, 0xa9, 0x38, 0x24,
+    0x68, 0xba, 0x19, 0xdf, 0xce, 0x65, 0xee, 0x9a, 0x9a, 0x46, 0x28, 0xd3, 0xb4, 0x89, 0x16, 0x26,
+    0x11, 0x57, 0x7d, 0x90, 0x34, 0xa6, 0x44, 0xbb, 0x24, 0xd1, 0xa2, 0x19, 0x30, 0xdd, 0x80, 0x88,
+    0xf1, 0x88, 0x3c, 0xba, 0xbd, 0xb7, 0x38, 0x4d, 0x03, 0xba, 0x81, 0xac, 0xd7, 0x0b, 0x20, 0x24,
+    0x46, 0x03, 0x7e, 0xde, 0x33, 0xc0, 0x23, 0xb2, 0x68, 0xc0, 0x6e, 0x5c, 0xa8, 0xf9, 0x14, 0x82,
+    0x26, 0xa4, 0x4f, 0x65, 0x53, 0x12, 0x9f, 0x25, 0x38, 0xfd, 0xbb, 0x0d, 0xd4, 0x4e, 0x38, 0xb6,
+    0x33, 0xa4, 0x8f, 0x3c, 0x36, 0xd5, 0x82, 0xf8, 0x62, 0x85, 0xc1, 0xc3, 0x8f, 0x09, 0x00, 0xc8,
+    0xf9, 0x8c, 0xb8, 0x9d, 0x86, 0xfd, 0xb4, 0xde, 0xd4, 0x0f, 0xed, 0x59, 0xf4, 0x0e, 0x43, 0xa8,
+    0x45, 0xbc, 0x13, 0x7f, 0x9b, 0x69, 0xc5, 0xfe, 0x47, 0x71, 0xca, 0x77, 0xbb, 0x53, 0x5a, 0x2b,
+    0xf3, 0x90, 0xe3, 0x84, 0x4a, 0x84, 0x18, 0xe6, 0x9f, 0xce, 0xce, 0xce, 0x0e, 0x0c, 0xce, 0xf5,
+    0xde, 0xee, 0x05, 0x46, 0x8a, 0x55, 0x59, 0x62, 0x82, 0x90, 0x16, 0xe6, 0xfa, 0x9c, 0x28, 0xcd,
+    0x82, 0x35, 0xa6, 0x84, 0x6b, 0xca, 0x75, 0x1f, 0x54, 0x4c, 0x3c, 0xda, 0x9c, 0x51, 0xbd, 0xa2,
+    0x94, 0x1f, 0xd6, 0x0f, 0x4e, 0xb2, 0xf1, 0x21, 0x9b, 0x46, 0x7c, 0x81, 0xaf, 0x79, 0xcd, 0xbd,
+    0xf1, 0x48, 0xf0, 0x73, 0xe7, 0x7c, 0x23, 0x5b, 0x11, 0xc9, 0x0b, 0xd2, 0x20, 0xf8, 0xe5, 0x5d,
+    0x67, 0x2b, 0xa5, 0x52, 0x16, 0x85, 0x6f, 0xde, 0x9c, 0x9d, 0xbd, 0x35, 0xc2, 0x8b, 0x76, 0xb6,
+    0x3c, 0x2e, 0xda, 0xd9, 0xda, 0x32, 0x6b, 0x64, 0x50, 0xc3, 0xa5, 0xd6, 0x1d, 0x4c, 0xd6, 0x0a,
+    0xeb, 0x08, 0x36, 0x0b, 0x0a, 0x47, 0x70, 0xdc, 0x67, 0x4b, 0xf0, 0x42, 0xa2, 0xd4, 0xa5, 0x63,
+    0x2a, 0x0d, 0xd7, 0x9d, 0x9d, 0xa1, 0x38, 0x6e, 0xd2, 0xe2, 0x0c, 0x72, 0x7f, 0x2e, 0x16, 0xbd,
+    0xc1, 0x88, 0x2f, 0x99, 0x14, 0x3c, 0x42, 0xbf, 0x11, 0xa8, 0x57, 0x10, 0x16, 0x9e, 0xc3, 0x28,
+    0x3a, 0x83, 0x0b, 0x8c, 0x0a, 0x1f, 0x4c, 0x28, 0x57, 0x42, 0xc2, 0xbd, 0xa4, 0xca, 0x3e, 0x62,
+    0x07, 0xad, 0x08, 0x98, 0x7f, 0xe9, 0xcc, 0x22, 0x3a, 0x8d, 0x53, 0x99, 0x33, 0x68, 0x6e, 0xc4,
+    0x6d, 0xc4, 0x7a, 0x11, 0xf9, 0x01, 0x57, 0x46, 0x29, 0x9e, 0x59, 0x32, 0xa7, 0x82, 0xfd, 0x9a,
+    0x44, 0xcc, 0x67, 0x7a, 0x5d, 0x0a, 0xb8, 0x48, 0xa2, 0x53, 0xf1, 0x8c, 0xbf, 0x2a, 0x91, 0xf4,
+    0xa8, 0xc3, 0xa7, 0x02, 0x4e, 0x92, 0x38, 0x0e, 0xd7, 0xf0, 0x51, 0x84, 0x9a, 0xcc, 0xcb, 0x61,
+    0x97, 0x28, 0x3b, 0x19, 0x36, 0xad, 0x8c, 0x07, 0x16, 0x95, 0x63, 0x2a, 0x94, 0xa3, 0xec, 0x54,
+    0xd8, 0x5b, 0xe1, 0x91, 0xf0, 0x38, 0xea, 0x51, 0xc8, 0xec, 0xb2, 0x4a, 0x21, 0x7e, 0xa0, 0x2b,
+    0x18, 0xe2, 0x02, 0x94, 0x22, 0xac, 0x54, 0x88, 0xa5, 0xe5, 0xe2, 0xd3, 0xd5, 0x8f, 0x2d, 0x17,
+    0x03, 0xf8, 0x8a, 0x72, 0x31, 0xce, 0xdc, 0x0b, 0x56, 0xb2, 0x40, 0x0c, 0xa0, 0x7f, 0xba, 0x7d,
+    0xb8, 0x43, 0x50, 0x09, 0xdd, 0x32, 0xb8, 0xee, 0x6b, 0xc1, 0xe0, 0x3f, 0xe4, 0xb1, 0x14, 0x10,
+    0x77, 0x9f, 0x57, 0x62, 0xf6, 0xca, 0xf0, 0x7a, 0xaf, 0x05, 0x3b, 0x66, 0x60, 0xef, 0x15, 0x06,
+    0x6e, 0x7a, 0x65, 0x49, 0x3a, 0x88, 0xa7, 0xd9, 0xf2, 0xbb, 0xeb, 0xf7, 0x0f, 0xc2, 0x71, 0xc3,
+    0x42, 0xb3, 0x87, 0x62, 0x49, 0x65, 0xa5, 0x12, 0xbe, 0x66, 0x32, 0xc2, 0xdd, 0xe1, 0x70, 0x4d,
+    0x05, 0xab, 0x93, 0xfb, 0x93, 0x50, 0x4c, 0x33, 0xc1, 0x0f, 0xa0, 0x62, 0x71, 0x72, 0x6b, 0x3a,
+    0xd6, 0x93, 0x96, 0x8c, 0x9f, 0x0a, 0xf5, 0x5e, 0xb2, 0xf9, 0x42, 0x73, 0xec, 0x9d, 0x87, 0x7d,
+    0xc3, 0x8a, 0x4e, 0x05, 0xbc, 0x9a, 0xdc, 0x5c, 0xdd, 0xfc, 0x7e, 0x00, 0x46, 0x14, 0x23, 0x4c,
+    0x9e, 0x0a, 0x86, 0xed, 0x86, 0x53, 0xaf, 0x34, 0x6c, 0x48, 0x05, 0xf8, 0xe9, 0x39, 0xd0, 0x0c,
+    0x9e, 0x49, 0x84, 0x66, 0xcf, 0xd6, 0x58, 0xfe, 0x7d, 0xb8, 0x91, 0x57, 0x28, 0xbf, 0x2b, 0xeb,
+    0x87, 0x7a, 0xa1, 0xee, 0x72, 0x89, 0x95, 0xce, 0x12, 0x24, 0x4d, 0x1c, 0x04, 0xf7, 0x42, 0xe6,
+    0x7d, 0xb9, 0x74, 0x44, 0x4c, 0xb9, 0xad, 0x5e, 0xb7, 0xee, 0x0c, 0xc6, 0x78, 0xb3, 0xa9, 0xe5,
+    0x54, 0xf1, 0x85, 0xa7, 0x91, 0xf2, 0x6f, 0xd3, 0x6d, 0x10, 0x1e, 0x12, 0x24, 0x3e, 0x63, 0x0e,
+    0xb7, 0x66, 0x70, 0x0b, 0xb2, 0xb5, 0xee, 0xf9, 0xa8, 0x82, 0x25, 0x40, 0x97, 0x4e, 0x81, 0x39,
+    0x5a, 0xe2, 0xfd, 0x92, 0x17, 0x5e, 0x28, 0x14, 0xcd, 0xdd, 0x18, 0x9a, 0xbb, 0x93, 0xfc, 0xd0,
+    0x68, 0xf6, 0x38, 0x08, 0xac, 0xd5, 0x5b, 0x37, 0x82, 0x60, 0xdf, 0x8f, 0x12, 0x37, 0x0e, 0x52,
+    0xa9, 0x3c, 0xc9, 0x62, 0x3d, 0xa8, 0xb5, 0xdb, 0x70, 0x4b, 0x94, 0x86, 0x2f, 0x5c, 0xac, 0x38,
+    0x3a, 0x66, 0x7a, 0x51, 0x03, 0x92, 0xd8, 0xc7, 0x46, 0xe7, 0xc3, 0x6c, 0x0d, 0x7a, 0x41, 0x21,
+    0x48, 0xc2, 0x10, 0xe8, 0x12, 0xa9, 0x13, 0x1a, 0x03, 0x5e, 0x5a, 0x9c, 0x80, 0x6d, 0xc5, 0x4a,
+    0x7d, 0x8a, 0xab, 0x52, 0x01, 0x09, 0x4c, 0x6b, 0x64, 0xba, 0x16, 0x52, 0x0d, 0x5e, 0x22, 0xa5,
+    0x51, 0xbf, 0x44, 0x0a, 0x89, 0xfb, 0x70, 0x1f, 0xbe, 0x3e, 0x35, 0x50, 0x71, 0x95, 0x5e, 0xac,
+    0xb2, 0x8e, 0x64, 0xee, 0xe0, 0xe9, 0xbc, 0x56, 0x0b, 0x12, 0x6e, 0xab, 0x04, 0x8f, 0x1c, 0x46,
+    0xe2, 0xaa, 0x7a, 0xc6, 0x8d, 0xb5, 0x2c, 0x9e, 0xbe, 0x7c, 0xe1, 0x25, 0x86, 0x0f, 0xb6, 0xe6,
+    0x54, 0x8f, 0x42, 0x6a, 0x2e, 0xdf, 0xaf, 0x6f, 0x7c, 0x77, 0x87, 0xdc, 0xd5, 0x5b, 0x0c, 0xed,
+    0x93, 0x0f, 0xf4, 0xd1, 0x4c, 0xaf, 0x5a, 0x28, 0x6b, 0x65, 0x32, 0xf8, 0x37, 0x38, 0x9f, 0x46,
+    0x13, 0x07, 0xfa, 0xe0, 0xdc, 0x8d, 0x9d, 0xf3, 0x6a, 0xc0, 0x76, 0xdb, 0x2e, 0x43, 0x35, 0x02,
+    0x2a, 0x31, 0x62, 0x12, 0xaf, 0xc5, 0x35, 0x7b, 0xa4, 0xbe, 0xdb, 0xad, 0xc3, 0xbf, 0xc0, 0x81,
+    0xbf, 0xfe, 0x3f, 0xac, 0x0a, 0x6f, 0x36, 0xf1, 0x32, 0xf4, 0x45, 0xb6, 0xf3, 0xef, 0x43, 0xff,
+    0xb3, 0x2a, 0xb0, 0x25, 0x7f, 0xc7, 0xa2, 0xa1, 0x8a, 0x46, 0x77, 0x52, 0xe4, 0xc5, 0x3d, 0xa9,
+    0x8a, 0x6d, 0x19, 0x60, 0x19, 0xf6, 0x32, 0x6d, 0xd1, 0x39, 0x74, 0x2f, 0x85, 0xfe, 0x58, 0x15,
+    0x78, 0x43, 0x03, 0xcb, 0xb0, 0x33, 0x99, 0x05, 0x8c, 0x54, 0xe5, 0xf4, 0x1d, 0x83, 0x33, 0x82,
+    0xf3, 0xda, 0xcb, 0x20, 0x39, 0x75, 0xdb, 0x07, 0x41, 0xc1, 0x0f, 0xa8, 0x81, 0x0d, 0x91, 0x2b,
+    0x43, 0xff, 0xae, 0x1a, 0xc8, 0x08, 0x5d, 0x19, 0x2e, 0xfe, 0x5a, 0x12, 0xf8, 0x7a, 0x93, 0xbb,
+    0xc7, 0x70, 0xbb, 0xf7, 0x62, 0x85, 0x7d, 0xe0, 0x14, 0x2b, 0x2d, 0xad, 0x3b, 0x06, 0x87, 0x4c,
+    0xeb, 0x74, 0xc4, 0xde, 0x31, 0xb8, 0xde, 0x2b, 0xb0, 0x9e, 0xb1, 0xae, 0xf7, 0x2a, 0xeb, 0x36,
+    0xbc, 0xae, 0x0c, 0x34, 0x15, 0x99, 0x46, 0x75, 0x35, 0x7c, 0xb8, 0xf9, 0x38, 0xb2, 0xbd, 0x6a,
+    0x7c, 0x7d, 0xed, 0x54, 0xa9, 0x54, 0x64, 0x67, 0xfb, 0x98, 0x9b, 0x56, 0xdb, 0x0a, 0x32, 0x4a,
+    0x57, 0xc1, 0x44, 0xc3, 0xcc, 0x76, 0x70, 0x76, 0xb6, 0xa5, 0x02, 0x66, 0xd6, 0xe5, 0xa7, 0x71,
+    0x46, 0x2d, 0x0e, 0xcb, 0xa9, 0x4a, 0x44, 0x0c, 0x7b, 0xab, 0x34, 0x1d, 0xe3, 0x71, 0xa2, 0xa7,
+    0xdf, 0xd5, 0x61, 0x52, 0x6a, 0x77, 0x34, 0x48, 0xb3, 0x9c, 0x26, 0x54, 0x00, 0xcb, 0xa8, 0x5d,
+    0x25, 0xd3, 0x53, 0xdd, 0x29, 0xe5, 0x64, 0x16, 0xe2, 0xbe, 0x8a, 0xe9, 0x1d, 0xdd, 0x5d, 0xbd,
+    0xbf, 0x1d, 0x7d, 0xb0, 0xf9, 0xfd, 0x70, 0x33, 0x49, 0x6f, 0x2a, 0xcc, 0x6a, 0xf9, 0x5f, 0xb5,
+    0xec, 0xe4, 0x24, 0x72, 0x9a, 0xee, 0xeb, 0x66, 0xda, 0xe1, 0xf8, 0xee, 0x6e, 0x34, 0x7c, 0xd8,
+    0x4e, 0xbc, 0x1d, 0xa8, 0x54, 0x19, 0x48, 0x15, 0x8f, 0x46, 0xcf, 0x48, 0xa7, 0xc5, 0x10, 0xa6,
+    0x2f, 0xa2, 0xc0, 0x23, 0xda, 0x5b, 0x80, 0x4b, 0xeb, 0x85, 0xad, 0x1c, 0x8d, 0x53, 0x22, 0xa4,
+    0xad, 0x50, 0xcc, 0x5d, 0x27, 0x3d, 0x02, 0x65, 0x9b, 0x3f, 0x04, 0x84, 0x61, 0x8c, 0x9c, 0x06,
+    0xd0, 0xfc, 0xd5, 0xdd, 0x53, 0x81, 0x22, 0x44, 0x54, 0xce, 0x69, 0xfa, 0x84, 0x6b, 0xa9, 0xc7,
+    0x06, 0x36, 0x10, 0x12, 0x5c, 0x83, 0xab, 0xc1, 0xbc, 0x62, 0x8c, 0x81, 0x71, 0xd8, 0x51, 0xb0,
+    0xf3, 0xa6, 0x25, 0xfb, 0xa7, 0xd5, 0xf8, 0x2f, 0xda, 0x3f, 0x9e, 0x7d, 0xc6, 0x20, 0x61, 0x82,
+    0x14, 0x9b, 0x73, 0x77, 0x4f, 0xfc, 0xed, 0x5b, 0x46, 0x5c, 0x10, 0x25, 0x1b, 0xdb, 0x79, 0x9d,
+    0x98, 0xd1, 0x95, 0xec, 0x29, 0x14, 0xa1, 0xa1, 0xc8, 0xa8, 0xae, 0x49, 0x18, 0x9a, 0x37, 0x9d,
+    0xd6, 0xa4, 0x19, 0x52, 0x46, 0x45, 0xa5, 0x82, 0x15, 0xd3, 0x0b, 0x91, 0x68, 0x98, 0x50, 0x89,
+    0x9c, 0xaf, 0x39, 0x31, 0x84, 0x64, 0x64, 0x48, 0x95, 0xea, 0x43, 0x2c, 0x90, 0x61, 0xe5, 0x54,
+    0x4b, 0x71, 0x12, 0xab, 0x85, 0xd0, 0x35, 0xa2, 0xd6, 0xdc, 0x83, 0xdc, 0x75, 0xa3, 0x95, 0x79,
+    0x5e, 0x4e, 0x90, 0x52, 0xef, 0x25, 0xba, 0x45, 0x56, 0x84, 0x69, 0x08, 0x28, 0x46, 0xde, 0x75,
+    0xda, 0x69, 0xfe, 0x9d, 0xc2, 0xdb, 0xda, 0x62, 0x14, 0x53, 0x5d, 0xd9, 0xfa, 0xac, 0x04, 0x77,
+    0x37, 0xaf, 0x74, 0xab, 0xa7, 0x2d, 0x25, 0x8b, 0x47, 0xd2, 0xc6, 0x02, 0x70, 0x57, 0x8c, 0xfb,
+    0x62, 0xd5, 0xb2, 0xbe, 0x4e, 0x44, 0x22, 0xbd, 0x1c, 0x32, 0xb5, 0xd7, 0x32, 0x4b, 0x85, 0x46,
+    0x73, 0xba, 0x82, 0x82, 0x56, 0x6e, 0x78, 0x3b, 0xd5, 0xd8, 0xd8, 0x9f, 0xde, 0xb5, 0x88, 0xef,
+    0x5b, 0xe5, 0x5b, 0xa6, 0x34, 0xc5, 0x82, 0x74, 0x9d, 0xcc, 0x4d, 0x34, 0x01, 0x2e, 0x07, 0x3b,
+    0x2e, 0xfe, 0x36, 0x19, 0xdf, 0xb5, 0x62, 0xf3, 0xf6, 0xdf, 0xa5, 0x2d, 0x34, 0x97, 0xd4, 0x8d,
+    0x9f, 0x4f, 0x40, 0x43, 0xe4, 0xe0, 0xa9, 0x2d, 0xc5, 0xe0, 0xa6, 0xf3, 0xe0, 0xb9, 0xe1, 0x86,
+    0x23, 0xa9, 0x5d, 0x92, 0xd0, 0xdd, 0x4a, 0x1b, 0xd0, 0xeb, 0x74, 0x3a, 0x69, 0xae, 0xf3, 0xcc,
+    0x20, 0xbb, 0xf4, 0x87, 0x22, 0x8a, 0x70, 0x29, 0xb8, 0x89, 0x0c, 0xf3, 0x92, 0xb4, 0xf1, 0xc7,
+    0x81, 0x06, 0xf2, 0xe0, 0x88, 0x62, 0xfe, 0x7d, 0x5c, 0x75, 0xf7, 0xe3, 0xc9, 0x83, 0x03, 0x4f,
+    0xf5, 0x3c, 0xaa, 0x2d, 0xcc, 0x3c, 0x77, 0xa5, 0x31, 0x7a, 0x27, 0xc0, 0x19, 0xa2, 0x41, 0xd7,
+    0x7d, 0x74, 0xcb, 0x20, 0x17, 0x9e, 0xb2, 0x09, 0x72, 0x69, 0xf1, 0x31, 0x2a, 0xa5, 0x90, 0xdb,
+    0x07, 0xd3, 0x9c, 0x64, 0x8f, 0x9a, 0xcc, 0xec, 0x99, 0x5d, 0x38, 0x57, 0x65, 0x16, 0x17, 0x1d,
+    0x71, 0xda, 0xc4, 0xaa, 0xb5, 0x8d, 0xda, 0xd4, 0x33, 0x7a, 0xce, 0x1e, 0x40, 0xf1, 0x48, 0xf3,
+    0x1c, 0x82, 0xd5, 0x2b, 0x87, 0xd8, 0x3d, 0xd5, 0x3c, 0x07, 0x62, 0x34, 0xa7, 0x22, 0x08, 0xa6,
+    0x61, 0xda, 0xc5, 0xf7, 0x53, 0xb0, 0x73, 0xca, 0x7b, 0x0e, 0x08, 0x55, 0x0b, 0x7d, 0x2a, 0x03,
+    0xc2, 0xf3, 0x6f, 0x76, 0x26, 0xc2, 0xcb, 0xf4, 0x95, 0x36, 0x9e, 0x59, 0xed, 0x3f, 0x91, 0xfe,
+    0x06, 0x21, 0x19, 0xa4, 0xe2, 0x5c, 0x1a, 0x00, 0x00,
+};
+
+// log.html: 537 bytes, 372 gzipped
+static const uint8_t WEB_LOG_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x4d, 0x92, 0x4d, 0x4f, 0x83, 0x40,
+    0x10, 0x86, 0xef, 0xfc, 0x8a, 0x91, 0x5e, 0x6a, 0x6a, 0xa1, 0xf5, 0x64, 0x60, 0xcb, 0x41, 0x6d,
+    0xa2, 0x49, 0x13, 0x4d, 0xec, 0xc5, 0xc4, 0xcb, 0xba, 0x3b, 0xc0, 0x46, 0xd8, 0x25, 0x30, 0x14,
+    0x49, 0xd3, 0xff, 0xee, 0xf0, 0x61, 0x94, 0x64, 0x33, 0xcc, 0xec, 0xc3, 0xbb, 0xef, 0x0c, 0x2b,
+    0xae, 0x1e, 0x5f, 0x1e, 0x8e, 0xef, 0xaf, 0x7b, 0xc8, 0xa9, 0x2c, 0x12, 0x4f, 0xfc, 0x06, 0x94,
+    0x9a, 0x43, 0x89, 0x24, 0x41, 0xe5, 0xb2, 0x6e, 0x90, 0x76, 0x7e, 0x4b, 0xe9, 0xfa, 0xce, 0xe7,
+    0x32, 0x19, 0x2a, 0x30, 0x39, 0x98, 0x13, 0xc2, 0xc1, 0x65, 0x22, 0x9c, 0x72, 0x4f, 0x34, 0xd4,
+    0x0f, 0x11, 0xf8, 0xf9, 0x74, 0xba, 0x87, 0x33, 0xa4, 0xce, 0xd2, 0x3a, 0x95, 0xa5, 0x29, 0xfa,
+    0x08, 0x4a, 0x67, 0x5d, 0x53, 0x49, 0x85, 0x31, 0x7c, 0x4a, 0xf5, 0x95, 0xd5, 0xae, 0xb5, 0x3a,
+    0x5a, 0x6c, 0xb7, 0xdb, 0x18, 0x94, 0x2b, 0x5c, 0x1d, 0x2d, 0x36, 0xe9, 0x26, 0x86, 0x4a, 0x6a,
+    0x6d, 0x6c, 0x16, 0x6d, 0x37, 0xd5, 0x77, 0x0c, 0x97, 0x51, 0x6f, 0x51, 0xb8, 0x8c, 0xf5, 0xba,
+    0xdc, 0x10, 0xae, 0x47, 0x91, 0x08, 0xaa, 0x1a, 0xd7, 0x5d, 0x2d, 0xab, 0x81, 0x11, 0xe1, 0x7c,
+    0xb8, 0x08, 0x67, 0xef, 0x83, 0x83, 0xc9, 0x8b, 0xc8, 0x6f, 0xff, 0x99, 0xe5, 0x64, 0xaa, 0x6a,
+    0x73, 0x02, 0xa3, 0x77, 0x3e, 0x2b, 0xfb, 0x89, 0x08, 0x39, 0x4d, 0x3c, 0xee, 0x41, 0xd5, 0xa6,
+    0xa2, 0xc4, 0x53, 0xce, 0x36, 0x04, 0xbc, 0xf7, 0xc8, 0xd8, 0x0e, 0xb4, 0x53, 0x6d, 0x89, 0x96,
+    0x82, 0x0c, 0x69, 0x5f, 0xe0, 0xf0, 0x7a, 0xdf, 0x3f, 0xeb, 0xe5, 0xf8, 0xf5, 0x75, 0x3c, 0xe3,
+    0x78, 0x22, 0x66, 0x2d, 0x76, 0xb0, 0x3f, 0x31, 0xf1, 0xe6, 0xda, 0x5a, 0xe1, 0xd2, 0x0f, 0x19,
+    0x0a, 0x71, 0xa8, 0x34, 0x03, 0xeb, 0x31, 0x16, 0x70, 0x8f, 0x23, 0x73, 0x30, 0x0d, 0xa1, 0xc5,
+    0x7a, 0x52, 0xba, 0x81, 0xb4, 0xb5, 0x8a, 0x8c, 0xb3, 0x4b, 0xbc, 0x86, 0xf3, 0x68, 0x74, 0xf2,
+    0x10, 0x18, 0xcb, 0xd4, 0x11, 0xbf, 0x09, 0x56, 0x3b, 0xc0, 0x40, 0x4b, 0xfe, 0x35, 0x2b, 0xf0,
+    0x3f, 0xac, 0x1f, 0x8f, 0x58, 0x67, 0xac, 0x76, 0x5d, 0xc0, 0xfe, 0x5d, 0x51, 0x1c, 0xdd, 0x72,
+    0x73, 0xf3, 0x67, 0x7a, 0x98, 0xc5, 0xbc, 0xf3, 0x84, 0x26, 0xcb, 0x89, 0x5d, 0x5c, 0x78, 0xf1,
+    0xd4, 0xe6, 0x76, 0x45, 0x38, 0xcd, 0x8b, 0xe7, 0x33, 0xde, 0x80, 0x1f, 0x63, 0xc3, 0xbc, 0x08,
+    0x19, 0x02, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+    { "/config", "text/html", "\"2113ce2abf0a7403\"", WEB_CONFIG_HTML_GZ, sizeof(WEB_CONFIG_HTML_GZ) },
+    { "/", "text/html", "\"81cce905fd74b18f\"", WEB_INDEX_HTML_GZ, sizeof(WEB_INDEX_HTML_GZ) },
+    { "/log", "text/html", "\"8b26b8e895f59b1b\"", WEB_LOG_HTML_GZ, sizeof(WEB_LOG_HTML_GZ) },
+};
+
+#define WEB_ASSET_COUNT (sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]))
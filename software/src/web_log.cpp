@@ -1,19 +1,355 @@
+/**
+ * @file web_log.cpp
+ * @brief Lock-free log ring buffer and drain job
+ *
+ * The ring is a bounded multi-producer queue with a sequence number per
+ * cell: producers claim a cell with one compare-and-swap and fill it in
+ * place, the single consumer (drain job) formats and releases cells in
+ * order. A full ring drops the new record and counts it.
+ */
+
 #include "web_log.h"
-#include <ESPAsyncWebServer.h>
+#include "task_manager.h"
 #include <stdarg.h>
 
-extern AsyncEventSource logEvents;
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_MAX_SINKS 4
+
+static_assert((LOG_RING_SIZE & LOG_RING_MASK) == 0, "LOG_RING_SIZE must be a power of two");
+
+static LogRecord ring[LOG_RING_SIZE];
+static std::atomic<uint32_t> enqueuePos(0);
+static std::atomic<uint32_t> dequeuePos(0);
+static std::atomic<uint32_t> dropped(0);
+static std::atomic<bool> draining(false);
+static uint32_t droppedReported = 0;
+
+static LogSinkFn sinks[LOG_MAX_SINKS];
+static uint8_t sinkCount = 0;
+
+static TaskJobId drainJob = TASK_JOB_INVALID;
+
+static const char* const MODULE_NAMES[LOG_MOD_COUNT] = {
+    "core", "task", "usb", "bme", "dew", "wifi", "web", "sd", "config", "ui", "ota", "time", "power"
+};
+
+static const char* const LEVEL_NAMES[] = {
+    "debug", "info", "warn", "error", "off"
+};
+
+// Runtime default: everything that was compiled in
+#define LOG_DEFAULT_LEVEL (LOG_LEVEL < LOG_LEVEL_OFF ? LOG_LEVEL : LOG_LEVEL_OFF)
+
+volatile uint8_t log_moduleLevel[LOG_MOD_COUNT] = {
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL
+};
+
+static_assert(LOG_MOD_COUNT == 13, "update MODULE_NAMES and log_moduleLevel");
+
+/**
+ * @brief Cell i starts with sequence i (free for enqueue position i)
+ */
+static struct RingInit {
+    RingInit() {
+        for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+            ring[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+} ringInit;
+
+#if LOG_TO_SERIAL
+static void serialSink(const LogRecord &rec, const char* line) {
+    Serial.printf("[%8lu] %s\n", (unsigned long)rec.timestamp, line);
+}
+#endif
+
+void log_begin() {
+    drainJob = task_register(TASK_LOG, "log", log_drain, LOG_DRAIN_FALLBACK_MS);
+#if LOG_TO_SERIAL
+    log_addSink(serialSink);
+#endif
+}
+
+bool log_addSink(LogSinkFn sink) {
+    if (sink == nullptr || sinkCount >= LOG_MAX_SINKS) return false;
+    sinks[sinkCount++] = sink;
+    return true;
+}
+
+bool log_setLevel(uint8_t module, uint8_t level) {
+    if (level > LOG_LEVEL_OFF) return false;
+    if (module == LOG_MOD_COUNT) {
+        for (uint8_t i = 0; i < LOG_MOD_COUNT; i++) log_moduleLevel[i] = level;
+        return true;
+    }
+    if (module > LOG_MOD_COUNT) return false;
+    log_moduleLevel[module] = level;
+    return true;
+}
+
+uint8_t log_getLevel(uint8_t module) {
+    return module < LOG_MOD_COUNT ? log_moduleLevel[module] : (uint8_t)LOG_LEVEL_OFF;
+}
+
+const char* log_moduleName(uint8_t module) {
+    return module < LOG_MOD_COUNT ? MODULE_NAMES[module] : "?";
+}
+
+const char* log_levelName(uint8_t level) {
+    return level <= LOG_LEVEL_OFF ? LEVEL_NAMES[level] : "?";
+}
+
+int log_moduleFromName(const char* name) {
+    if (strcasecmp(name, "all") == 0) return LOG_MOD_COUNT;
+    for (uint8_t i = 0; i < LOG_MOD_COUNT; i++) {
+        if (strcasecmp(name, MODULE_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int log_levelFromName(const char* name) {
+    for (uint8_t i = 0; i <= LOG_LEVEL_OFF; i++) {
+        if (strcasecmp(name, LEVEL_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+uint32_t log_getDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+LogRecord* log_claim(uint8_t level, uint8_t module) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    LogRecord* rec;
+
+    for (;;) {
+        rec = &ring[pos & LOG_RING_MASK];
+        int32_t diff = (int32_t)(rec->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;     // full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
 
-void webLog(const String& msg) {
-    logEvents.send(msg.c_str(), "log");
-    //Serial.println(msg);
+    rec->timestamp = millis();
+    rec->level = level;
+    rec->module = module;
+    rec->argLen = 0;
+    rec->truncated = false;
+    rec->fmt = nullptr;
+    return rec;
 }
 
-void webLogf(const char* fmt, ...) {
-    char buf[256];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    webLog(String(buf));
+void log_commit(LogRecord* rec) {
+    uint32_t pos = rec->seq.load(std::memory_order_relaxed);
+
+    // seq_cst store/load here and in log_drain(): either the drain job sees
+    // this record before it stops, or we see it stopped here and trigger it
+    rec->seq.store(pos + 1, std::memory_order_seq_cst);
+
+    if (!task_started()) {
+        log_drain();            // setup(): no drain task yet
+    } else if (pos == dequeuePos.load(std::memory_order_seq_cst)) {
+        task_trigger(drainJob); // ring was empty, drain job is sleeping
+    }
+}
+
+void webLog(const char* msg, uint8_t level, uint8_t module) {
+    if (module >= LOG_MOD_COUNT || !log_enabled(module, level)) return;
+    LogRecord* rec = log_claim(level, module);
+    if (rec == nullptr) return;
+
+    size_t n = strnlen(msg, LOG_ARG_BYTES);
+    memcpy(rec->args, msg, n);
+    rec->argLen = n;
+    rec->truncated = msg[n] != '\0';
+    log_commit(rec);
+}
+
+/**
+ * @brief Reads the next packed argument, returns its tag (0 = none left).
+ */
+static uint8_t nextArg(const LogRecord &rec, size_t &off, const uint8_t* &data, size_t &len) {
+    if (off >= rec.argLen) return 0;
+    uint8_t tag = rec.args[off++];
+
+    switch (tag) {
+    case LOG_ARG_INT:    len = sizeof(int64_t); break;
+    case LOG_ARG_DOUBLE: len = sizeof(double); break;
+    case LOG_ARG_PTR:    len = sizeof(void*); break;
+    case LOG_ARG_STR:    len = rec.args[off++]; break;
+    default:             return 0;
+    }
+    if (off + len > rec.argLen) return 0;
+
+    data = &rec.args[off];
+    off += len;
+    return tag;
+}
+
+/**
+ * @brief printf over packed arguments: every conversion is formatted
+ *        separately with the argument type that was stored.
+ */
+/**
+ * @brief Ends a truncated line with LOG_TRUNCATED_MARK, cutting the text if needed.
+ */
+static size_t markTruncated(char* out, size_t o, size_t outLen) {
+    const size_t mark = sizeof(LOG_TRUNCATED_MARK) - 1;
+    if (outLen <= mark) return o;
+    if (o > outLen - 1 - mark) o = outLen - 1 - mark;
+    memcpy(out + o, LOG_TRUNCATED_MARK, mark);
+    return o + mark;
+}
+
+size_t log_format(const LogRecord &rec, char* out, size_t outLen) {
+    if (outLen == 0) return 0;
+
+    if (rec.fmt == nullptr) {
+        size_t n = rec.argLen < outLen - 1 ? rec.argLen : outLen - 1;
+        memcpy(out, rec.args, n);
+        if (rec.truncated) n = markTruncated(out, n, outLen);
+        out[n] = '\0';
+        return n;
+    }
+
+    size_t o = 0;
+    size_t argOff = 0;
+    const char* f = rec.fmt;
+
+    while (*f && o < outLen - 1) {
+        if (*f != '%') {
+            out[o++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[o++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision, drop length modifiers
+        const char* specStart = f;
+        char spec[16];
+        size_t s = 0;
+        uint8_t stars = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0123456789.*", *f) && s < sizeof(spec) - 4) {
+            if (*f == '*') stars++;
+            spec[s++] = *f++;
+        }
+        while (*f && strchr("hlLzjt", *f)) f++;
+        char conv = *f ? *f++ : 's';
+
+        const uint8_t* data = nullptr;
+        size_t len = 0;
+        uint8_t tag = nextArg(rec, argOff, data, len);
+        if (tag == 0 && rec.truncated) break;   // the rest did not fit
+
+        // Width or precision as an argument ("%*d") is not passed on:
+        // the spec is printed as written and its arguments are skipped
+        if (stars > 0) {
+            for (uint8_t i = 0; i < stars; i++) tag = nextArg(rec, argOff, data, len);
+            size_t n = f - specStart;
+            if (n > outLen - 1 - o) n = outLen - 1 - o;
+            memcpy(out + o, specStart, n);
+            o += n;
+            if (tag == 0 && rec.truncated) break;
+            continue;
+        }
+        int n = 0;
+        size_t room = outLen - o;
+
+        if (tag == LOG_ARG_INT && conv == 'c') {
+            int64_t v;
+            memcpy(&v, data, sizeof(v));
+            n = snprintf(out + o, room, "%c", (int)v);
+        } else if (tag == LOG_ARG_INT && strchr("diuxXo", conv)) {
+            int64_t v;
+            memcpy(&v, data, sizeof(v));
+            spec[s++] = 'l';
+            spec[s++] = 'l';
+            spec[s++] = conv;
+            spec[s] = '\0';
+            n = (conv == 'd' || conv == 'i') ? snprintf(out + o, room, spec, (long long)v)
+                                             : snprintf(out + o, room, spec, (unsigned long long)v);
+        } else if (tag == LOG_ARG_DOUBLE && strchr("fFeEgGaA", conv)) {
+            double v;
+            memcpy(&v, data, sizeof(v));
+            spec[s++] = conv;
+            spec[s] = '\0';
+            n = snprintf(out + o, room, spec, v);
+        } else if (tag == LOG_ARG_STR && conv == 's') {
+            char str[LOG_ARG_BYTES];
+            memcpy(str, data, len);
+            str[len] = '\0';
+            spec[s++] = 's';
+            spec[s] = '\0';
+            n = snprintf(out + o, room, spec, str);
+        } else if (tag == LOG_ARG_PTR && conv == 'p') {
+            void* v;
+            memcpy(&v, data, sizeof(v));
+            n = snprintf(out + o, room, "%p", v);
+        } else {
+            n = snprintf(out + o, room, "<?>");     // missing or mismatching argument
+        }
+
+        if (n > 0) o += ((size_t)n < room) ? (size_t)n : room - 1;
+    }
+
+    if (rec.truncated) o = markTruncated(out, o, outLen);
+    out[o] = '\0';
+    return o;
+}
+
+/**
+ * @brief Sends one formatted line to all sinks.
+ */
+static void emit(const LogRecord &rec, const char* line) {
+    for (uint8_t i = 0; i < sinkCount; i++) {
+        sinks[i](rec, line);
+    }
+}
+
+void log_drain() {
+    // Only one consumer at a time (setup() and the drain job may overlap briefly)
+    if (draining.exchange(true, std::memory_order_acquire)) return;
+
+    char line[LOG_LINE_MAX];
+    uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        LogRecord &rec = ring[pos & LOG_RING_MASK];
+        if ((int32_t)(rec.seq.load(std::memory_order_seq_cst) - (pos + 1)) < 0) break;
+
+        log_format(rec, line, sizeof(line));
+        emit(rec, line);
+
+        rec.seq.store(pos + LOG_RING_SIZE, std::memory_order_release);
+        pos++;
+        dequeuePos.store(pos, std::memory_order_seq_cst);
+    }
+
+    uint32_t d = dropped.load(std::memory_order_relaxed);
+    if (d != droppedReported) {
+        LogRecord info;
+        info.timestamp = millis();
+        info.level = LOG_LEVEL_WARN;
+        info.module = 0;
+        info.truncated = false;
+        info.fmt = nullptr;
+        snprintf(line, sizeof(line), "Log: %lu records dropped (ring full)",
+                 (unsigned long)(d - droppedReported));
+        droppedReported = d;
+        emit(info, line);
+    }
+
+    draining.store(false, std::memory_order_release);
 }
@@ -1,9 +1,353 @@
+/**
+ * @file web_log.h
+ * @brief Central logging with a lock-free ring buffer
+ *
+ * LOG()/LOGF() only store a binary record (timestamp, level, module,
+ * format pointer and packed arguments) into a preallocated ring buffer.
+ * Formatting and output to the sinks (SSE /log page, Serial, ...) happens
+ * later in a low-priority drain job, so a slow SSE client never blocks
+ * the caller and no String temporaries are built on the hot path.
+ *
+ * LOGF format strings must be string literals (only the pointer is stored).
+ *
+ * Levels and modules:
+ *  - LOG_DEBUG/LOG_INFO/LOG_WARN/LOG_ERROR below the build flag LOG_LEVEL
+ *    (0 = DEBUG ... 3 = ERROR, 4 = off) are compiled out: their arguments
+ *    are never evaluated and neither code nor format strings end up in
+ *    the binary.
+ *  - Every source file tags its records with a module by defining
+ *    LOG_MODULE before its first #include, e.g.
+ *        #define LOG_MODULE LOG_MOD_USB
+ *    Files without a tag log as LOG_MOD_CORE.
+ *  - Each module has a runtime level (GET/POST /log/level), checked
+ *    inline before anything is stored.
+ */
+
 #pragma once
 #include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Compile-time threshold, lower levels are removed from the binary
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
+/**
+ * @brief Number of records in the ring buffer (power of two)
+ */
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 64
+#endif
+
+/**
+ * @brief Bytes available for packed arguments / message text per record
+ */
+#define LOG_ARG_BYTES 100
+
+/**
+ * @brief Maximum length of a formatted log line
+ */
+#define LOG_LINE_MAX 256
+
+/**
+ * @brief Appended to a line whose arguments did not fit into the record
+ */
+#define LOG_TRUNCATED_MARK "…"
+
+/**
+ * @brief Period of the drain job in case a trigger is missed (ms)
+ */
+#define LOG_DRAIN_FALLBACK_MS 1000
+
+/**
+ * @brief Also print every log line on Serial (Serial must be started)
+ */
+#ifndef LOG_TO_SERIAL
+#define LOG_TO_SERIAL 0
+#endif
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log record
+ */
+enum LogLevel : uint8_t {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_OFF
+};
+
+/**
+ * @enum LogModule
+ * @brief Source module of a log record
+ */
+enum LogModule : uint8_t {
+    LOG_MOD_CORE = 0,   ///< main, pins
+    LOG_MOD_TASK,       ///< task manager
+    LOG_MOD_USB,        ///< cover communication
+    LOG_MOD_BME,        ///< BME280
+    LOG_MOD_DEW,        ///< dew heater control
+    LOG_MOD_WIFI,       ///< WiFi
+    LOG_MOD_WEB,        ///< web server
+    LOG_MOD_SD,         ///< SD card
+    LOG_MOD_CONFIG,     ///< configuration
+    LOG_MOD_UI,         ///< OLED, buttons, LEDs
+    LOG_MOD_OTA,        ///< OTA update
+    LOG_MOD_TIME,       ///< NTP and scheduled actions
+    LOG_MOD_POWER,      ///< power outputs and budget
+    LOG_MOD_COUNT
+};
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MOD_CORE
+#endif
+
+/**
+ * @enum LogArgType
+ * @brief Type tags of packed LOGF arguments
+ */
+enum LogArgType : uint8_t {
+    LOG_ARG_INT = 1,    ///< int64_t
+    LOG_ARG_DOUBLE,     ///< double
+    LOG_ARG_STR,        ///< length byte + characters (copied, may be truncated)
+    LOG_ARG_PTR         ///< pointer value
+};
+
+/**
+ * @struct LogRecord
+ * @brief One entry of the ring buffer
+ *
+ * fmt == nullptr: args holds the plain message text (argLen bytes).
+ * truncated: the text or an argument did not fit, everything after it was
+ * dropped and the line ends with LOG_TRUNCATED_MARK.
+ */
+struct LogRecord {
+    std::atomic<uint32_t> seq;      ///< Ring buffer cell sequence (internal)
+    uint32_t timestamp;             ///< millis() when logged
+    uint8_t level;                  ///< LogLevel
+    uint8_t module;                 ///< Module id
+    uint8_t argLen;                 ///< Used bytes in args
+    bool truncated;                 ///< Arguments missing at the end
+    const char* fmt;                ///< Format string (literal) or nullptr
+    uint8_t args[LOG_ARG_BYTES];    ///< Packed arguments or text
+};
+
+/**
+ * @brief Output sink, called by the drain job for every record.
+ *
+ * @param rec  Record (timestamp, level, module)
+ * @param line Formatted message, null-terminated
+ */
+typedef void (*LogSinkFn)(const LogRecord &rec, const char* line);
+
+/**
+ * @brief Registers the drain job. Call first thing in setup().
+ *
+ * Until the tasks are started, records are drained synchronously.
+ */
+void log_begin();
+
+/**
+ * @brief Adds an output sink (max. 4).
+ */
+bool log_addSink(LogSinkFn sink);
+
+/**
+ * @brief Formats and outputs all queued records (drain job).
+ */
+void log_drain();
+
+/**
+ * @brief Returns the number of records dropped because the ring was full.
+ */
+uint32_t log_getDropped();
+
+/**
+ * @brief Runtime level per module (internal, use log_setLevel()).
+ */
+extern volatile uint8_t log_moduleLevel[LOG_MOD_COUNT];
+
+/**
+ * @brief Returns true if records of this module and level are kept.
+ */
+inline bool log_enabled(uint8_t module, uint8_t level) {
+    return level >= log_moduleLevel[module];
+}
+
+/**
+ * @brief Sets the runtime level of a module.
+ *
+ * @param module Module, LOG_MOD_COUNT = all modules
+ * @param level  Minimum level, LOG_LEVEL_OFF disables the module
+ * @return false if module or level is invalid
+ */
+bool log_setLevel(uint8_t module, uint8_t level);
 
-void webLog(const String& msg);
-void webLogf(const char* fmt, ...);
+/**
+ * @brief Returns the runtime level of a module.
+ */
+uint8_t log_getLevel(uint8_t module);
+
+/**
+ * @brief Module name as used by /log/level ("usb", "dew", ...).
+ */
+const char* log_moduleName(uint8_t module);
+
+/**
+ * @brief Level name ("debug", "info", "warn", "error", "off").
+ */
+const char* log_levelName(uint8_t level);
+
+/**
+ * @brief Looks up a module by name, LOG_MOD_COUNT for "all", -1 if unknown.
+ */
+int log_moduleFromName(const char* name);
+
+/**
+ * @brief Looks up a level by name, -1 if unknown.
+ */
+int log_levelFromName(const char* name);
+
+/**
+ * @brief Formats a record into a text line.
+ *
+ * @return Length of the line
+ */
+size_t log_format(const LogRecord &rec, char* out, size_t len);
+
+/**
+ * @brief Claims a free record, nullptr if the ring is full (internal).
+ */
+LogRecord* log_claim(uint8_t level, uint8_t module);
+
+/**
+ * @brief Publishes a claimed record to the drain job (internal).
+ */
+void log_commit(LogRecord* rec);
+
+/**
+ * @brief Writes packed arguments into a record (internal)
+ *
+ * The first argument that does not fit ends the packing: later, smaller
+ * arguments are not stored either, so no argument ends up at the
+ * conversion of another one.
+ */
+struct LogPacker {
+    LogRecord* rec;
+
+    void putTag(uint8_t tag, const void* data, size_t len) {
+        if (rec->truncated) return;
+        if (rec->argLen + 1 + len > LOG_ARG_BYTES) {
+            rec->truncated = true;
+            return;
+        }
+        rec->args[rec->argLen++] = tag;
+        memcpy(&rec->args[rec->argLen], data, len);
+        rec->argLen += len;
+    }
+
+    void putStr(const char* s) {
+        if (rec->truncated) return;
+        if (s == nullptr) s = "(null)";
+        size_t room = LOG_ARG_BYTES - rec->argLen;
+        if (room < 2) {
+            rec->truncated = true;
+            return;
+        }
+        // A cut string is kept, but it is the last argument
+        size_t n = strnlen(s, room - 2);
+        rec->args[rec->argLen++] = LOG_ARG_STR;
+        rec->args[rec->argLen++] = (uint8_t)n;
+        memcpy(&rec->args[rec->argLen], s, n);
+        rec->argLen += n;
+        if (s[n] != '\0') rec->truncated = true;
+    }
+
+    template <typename T>
+    void put(const T &v) {
+        if constexpr (std::is_same<T, String>::value) {
+            putStr(v.c_str());
+        } else if constexpr (std::is_same<typename std::decay<T>::type, char*>::value ||
+                             std::is_same<typename std::decay<T>::type, const char*>::value) {
+            putStr(v);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            double d = v;
+            putTag(LOG_ARG_DOUBLE, &d, sizeof(d));
+        } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+            int64_t i = (int64_t)v;
+            putTag(LOG_ARG_INT, &i, sizeof(i));
+        } else if constexpr (std::is_pointer<T>::value) {
+            const void* p = v;
+            putTag(LOG_ARG_PTR, &p, sizeof(p));
+        } else {
+            static_assert(sizeof(T) == 0, "unsupported LOGF argument type");
+        }
+    }
+};
+
+/**
+ * @brief Queues a plain text message.
+ */
+void webLog(const char* msg, uint8_t level = LOG_LEVEL_INFO, uint8_t module = 0);
+
+inline void webLog(const String &msg, uint8_t level = LOG_LEVEL_INFO, uint8_t module = 0) {
+    webLog(msg.c_str(), level, module);
+}
+
+/**
+ * @brief Queues a printf-style message, arguments are packed binary.
+ */
+template <typename... Args>
+void webLogf(uint8_t level, uint8_t module, const char* fmt, const Args &... args) {
+    LogRecord* rec = log_claim(level, module);
+    if (rec == nullptr) return;
+    rec->fmt = fmt;
+    LogPacker packer{rec};
+    (packer.put(args), ...);
+    (void)packer;
+    log_commit(rec);
+}
 
 // Zentrale Logging-Makros
-#define LOG(msg) webLog(msg)
-#define LOGF(...) webLogf(__VA_ARGS__)
\ No newline at end of file
+#define LOG_AT(level, fmt, ...) \
+    do { \
+        if (log_enabled(LOG_MODULE, level)) webLogf(level, LOG_MODULE, fmt, ##__VA_ARGS__); \
+    } while (0)
+
+// Disabled: arguments are still type-checked, but never evaluated and no code is emitted
+#define LOG_NONE(fmt, ...) \
+    do { \
+        if (false) webLogf(LOG_LEVEL_OFF, LOG_MODULE, fmt, ##__VA_ARGS__); \
+    } while (0)
+
+#if LOG_LEVEL <= 0
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= 1
+#define LOG_INFO(fmt, ...) LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= 2
+#define LOG_WARN(fmt, ...) LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= 3
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+
+// Plain INFO messages (msg may be a String)
+#define LOG(msg) LOG_INFO("%s", msg)
+#define LOGF(fmt, ...) LOG_INFO(fmt, ##__VA_ARGS__)
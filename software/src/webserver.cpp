@@ -1,446 +1,514 @@
 #include "webserver.h"
 #include <ESPAsyncWebServer.h>
+#include <AsyncJson.h>
 #include "sdcard.h"
 #include "config_manager.h"
+#include "config_parser.h"
 #include <WiFi.h>
+#include "wifi_config.h"
+#include <esp_heap_caps.h>
 #include "web_log.h"
+#include "log_spool.h"
 #include "ArduinoJSON.h"
-#include "bme280_manager.h"
-#include "dew_controller.h"
 #include "usb_manager.h"
-#include "power_control.h"
 #include "button_manager.h"
-#include "time_manager.h"
+#include "web_assets.h"
+#include "status_stream.h"
+#include "metrics.h"
+#include "task_manager.h"
 
 AsyncWebServer server(80);
 AsyncEventSource logEvents("/log/events");
 
-// Cached HTML for WiFi scan results
-static String wifiScanHtml = "";
+/**
+ * @brief Log sink: forwards drained log lines to the /log page.
+ */
+static void logEventSink(const LogRecord &rec, const char* line) {
+    if (logEvents.count() == 0) return;
+    logEvents.send(line, "log");
+}
+
+/**
+ * @brief Revalidate embedded pages on every load (answered with 304 while unchanged)
+ */
+#define WEB_CACHE_CONTROL "no-cache"
+
+/**
+ * @brief Initial size of the /metrics response buffer (grows if needed)
+ */
+#define METRICS_RESPONSE_SIZE 4096
 
 /**
- * @brief Reads the entire config.txt file from the SD card.
+ * @brief Maximum JSON body of PATCH /config and POST /save_config
+ */
+#define CONFIG_JSON_MAX_BYTES 2048
+
+/**
+ * @brief Maximum text body of POST /save_config
+ */
+#ifndef CONFIG_UPLOAD_MAX_BYTES
+#define CONFIG_UPLOAD_MAX_BYTES 8192
+#endif
+
+/**
+ * @struct ConfigUpload
+ * @brief The config upload in progress (web server task only)
  *
- * @return String containing the file contents, or an error message.
+ * One static instance: memory use does not depend on the upload. A text
+ * body is validated and written to the temp file chunk by chunk, a JSON
+ * body is collected (up to CONFIG_JSON_MAX_BYTES) and converted to lines.
+ */
+struct ConfigUpload {
+    AsyncWebServerRequest *owner;   ///< nullptr = no upload running
+    bool json;
+    bool tooLarge;
+    bool writing;                   ///< Temp file is open
+    size_t jsonLength;
+    char jsonBody[CONFIG_JSON_MAX_BYTES];
+    ConfigWriter writer;
+    ConfigParser parser;
+    ConfigData parsed;
+};
+
+static ConfigUpload upload;
+
+/**
+ * @struct RouteMetric
+ * @brief Request counter of one route
  */
-String loadConfigFileAsString() {
-    File f = openConfigFile();
-    if (!f) return "Could not open config.txt";
+struct RouteMetric {
+    const char* url;        ///< Exact path, nullptr = everything else
+    const char* labels;
+    MetricCounter requests;
+};
+
+#define ROUTE(url) { url, "route=\"" url "\"" }
+
+static RouteMetric routeMetrics[] = {
+    ROUTE("/"),
+    ROUTE("/config"),
+    ROUTE("/log"),
+    ROUTE("/status"),
+    ROUTE("/status/events"),
+    ROUTE("/log/events"),
+    ROUTE("/log/level"),
+    ROUTE("/config.txt"),
+    ROUTE("/wifi/networks"),
+    ROUTE("/save_config"),
+    ROUTE("/reload_config"),
+    ROUTE("/rescan_wifi"),
+    ROUTE("/action/open_cover"),
+    ROUTE("/action/close_cover"),
+    ROUTE("/action/turn_off_light"),
+    ROUTE("/action/set_brightness"),
+    ROUTE("/metrics"),
+    { nullptr, "route=\"other\"" }
+};
+
+#define ROUTE_METRIC_COUNT (sizeof(routeMetrics) / sizeof(routeMetrics[0]))
+
+static float freeHeap() { return ESP.getFreeHeap(); }
+static float minFreeHeap() { return ESP.getMinFreeHeap(); }
+static float largestFreeBlock() { return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
 
-    String content = f.readString();
-    f.close();
-    return content;
+/**
+ * @brief Registers the web server and heap metrics.
+ */
+static void registerMetrics() {
+    for (size_t i = 0; i < ROUTE_METRIC_COUNT; i++) {
+        metrics_register("cover_http_requests_total", "HTTP requests per route",
+                         routeMetrics[i].labels, routeMetrics[i].requests);
+    }
+    metrics_register("cover_heap_free_bytes", "Free heap", nullptr, freeHeap);
+    metrics_register("cover_heap_min_free_bytes", "Lowest free heap since boot", nullptr, minFreeHeap);
+    metrics_register("cover_heap_largest_block_bytes", "Largest allocatable heap block", nullptr, largestFreeBlock);
 }
 
 /**
- * @brief Scans for WiFi networks and generates an HTML table.
- *
- * The result is stored in wifiScanHtml and displayed on /config.
+ * @brief Middleware: counts every request by its path.
  */
-void updateWiFiScanResults() {
-    int n = WiFi.scanNetworks();
-    wifiScanHtml = "<table>";
-    wifiScanHtml += "<tr><th>SSID</th><th>RSSI</th></tr>";
+static void countRequest(AsyncWebServerRequest *request, ArMiddlewareNext next) {
+    const char* url = request->url().c_str();
+    size_t i = 0;
+    while (i < ROUTE_METRIC_COUNT - 1 && strcmp(routeMetrics[i].url, url) != 0) i++;
+    metric_inc(routeMetrics[i].requests);
+    next();
+}
 
-    if (n <= 0) {
-        wifiScanHtml += "<tr><td colspan='2'>No networks found</td></tr>";
+/**
+ * @brief Converts a JSON value of PATCH /config to the config.txt notation.
+ */
+static bool jsonToConfigValue(JsonVariantConst v, char* buf, size_t size, ConfigDiagCode &problem) {
+    int n;
+    if (v.is<const char*>()) {
+        n = snprintf(buf, size, "%s", v.as<const char*>());
+    } else if (v.is<bool>()) {
+        n = snprintf(buf, size, "%d", v.as<bool>() ? 1 : 0);
+    } else if (v.is<long>()) {
+        n = snprintf(buf, size, "%ld", v.as<long>());
+    } else if (v.is<float>()) {
+        n = snprintf(buf, size, "%.1f", v.as<float>());      // CKEY_DECI
     } else {
-        for (int i = 0; i < n; i++) {
-            wifiScanHtml += "<tr>";
-            wifiScanHtml += "<td>" + WiFi.SSID(i) + "</td>";
-            wifiScanHtml += "<td>" + String(WiFi.RSSI(i)) + "</td>";
-            wifiScanHtml += "</tr>";
-        }
+        problem = CDIAG_INVALID;
+        return false;
     }
 
-    wifiScanHtml += "</table>";
+    if (n < 0 || (size_t)n >= size) {
+        problem = CDIAG_TOO_LONG;
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief Initializes the web server and registers all HTTP routes.
+ * @brief PATCH /config: applies the given keys, or none if one is rejected.
  */
-void initWebServer() {
-
-    // --- /config page ---
-    server.on("/config", HTTP_GET, [](AsyncWebServerRequest *request) {
-        String cfg = loadConfigFileAsString();
-
-        String html = R"rawliteral(
-            <html>
-            <head>
-                <title>Configuration</title>
-                <style>
-                    body {
-                        font-family: Arial;
-                        display: flex;
-                        gap: 20px;
-                        padding: 20px;
-                    }
-                    .left {
-                        width: 60%;
-                    }
-                    .right {
-                        width: 40%;
-                    }
-                    textarea {
-                        width: 100%;
-                        height: 400px;
-                        font-family: monospace;
-                    }
-                    button {
-                        margin-top: 10px;
-                        padding: 8px 16px;
-                    }
-                    table {
-                        width: 100%;
-                        border-collapse: collapse;
-                        margin-top: 10px;
-                    }
-                    th, td {
-                        border: 1px solid #ccc;
-                        padding: 6px 10px;
-                        text-align: left;
-                    }
-                    th {
-                        background: #eee;
-                    }
-                </style>
-            </head>
-            <body>
-                <div class="left">
-                    <h2>Configuration</h2>
-                    <form action="/save_config" method="POST">
-                        <textarea name="cfg">)rawliteral";
-
-        html += cfg;
-
-        html += R"rawliteral(</textarea><br>
-                        <button type="submit">Save Config</button>
-                    </form>
-                    <form action="/reload_config" method="POST">
-                        <button type="submit">Reload Config</button>
-                    </form>
-                </div>
-
-                <div class="right">
-                    <h2>WiFi Networks</h2>
-        )rawliteral";
-
-        html += wifiScanHtml;
-
-        html += R"rawliteral(
-                    <form action="/rescan_wifi" method="POST">
-                        <button type="submit">Rescan WiFi Networks</button>
-                    </form>
-                </div>
-            </body>
-            </html>
-        )rawliteral";
-
-        request->send(200, "text/html", html);
-    });
+static void patchConfig(AsyncWebServerRequest *request, JsonVariant &json) {
+    JsonObject changes = json.as<JsonObject>();
+    if (changes.isNull()) {
+        request->send(400, "text/plain", "Expected a JSON object");
+        return;
+    }
 
-    // --- Save Config ---
-    server.on("/save_config", HTTP_POST, [](AsyncWebServerRequest *request) {
-        if (!request->hasParam("cfg", true)) {
-            request->send(400, "text/plain", "Missing cfg parameter");
-            return;
+    static ConfigData next;     // web server task only, kept off its stack
+    next = config_get();
+    char value[CPARSER_MAX_LINE + 1];
+
+    for (JsonPair change : changes) {
+        const char* key = change.key().c_str();
+        ConfigDiagCode problem;
+        bool ok;
+
+        if (change.value().is<JsonArray>()) {
+            // A list replaces all entries of the key
+            ok = cparser_clearList(next, key, problem);
+            for (JsonVariant item : change.value().as<JsonArray>()) {
+                if (!ok) break;
+                ok = jsonToConfigValue(item, value, sizeof(value), problem) &&
+                     cparser_set(next, key, value, problem);
+            }
+        } else {
+            ok = jsonToConfigValue(change.value(), value, sizeof(value), problem) &&
+                 cparser_set(next, key, value, problem);
         }
 
-        String newCfg = request->getParam("cfg", true)->value();
-
-        File f = SD.open("/config.txt", FILE_WRITE);
-        if (!f) {
-            request->send(500, "text/plain", "Could not write config.txt");
+        if (!ok) {
+            request->send(400, "text/plain", String(key) + ": " + cparser_diagText(problem));
             return;
         }
+    }
 
-        f.print(newCfg);
-        f.close();
-
-        loadConfigFromSD();  // reload configuration
-
-        request->redirect("/config");
-    });
+    if (!config_update(next)) {
+        request->send(500, "text/plain", "Applied, but could not be stored");
+        return;
+    }
+    request->send(200, "text/plain", "OK");
+}
 
-    // --- Reload Config ---
-    server.on("/reload_config", HTTP_POST, [](AsyncWebServerRequest *request) {
-        loadConfigFromSD();
-        request->redirect("/config");
-    });
+/**
+ * @brief Validates and writes the next piece of the uploaded config.txt.
+ */
+static void uploadWrite(const char* data, size_t len) {
+    cparser_feed(upload.parser, data, len);
+    configWriteChunk(upload.writer, data, len);
+}
 
-    // --- Rescan WiFi ---
-    server.on("/rescan_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
-        updateWiFiScanResults();
-        request->redirect("/config");
-    });
+/**
+ * @brief Ends the upload, the temp file is discarded unless it was committed.
+ */
+static void uploadRelease() {
+    if (upload.writing) configWriteAbort(upload.writer);
+    upload.writing = false;
+    upload.owner = nullptr;
+}
 
-    // Initial scan
-    updateWiFiScanResults();
+/**
+ * @brief Writes a JSON upload ({"key": value, "wifi": ["SSID;PASSWORD", ...]}) as config lines.
+ *
+ * @return nullptr, or the reason the body was rejected
+ */
+static const char* uploadJson() {
+    JsonDocument doc;
+    if (deserializeJson(doc, upload.jsonBody, upload.jsonLength) || !doc.is<JsonObject>()) {
+        return "Expected a JSON object";
+    }
 
-    // --- Log Event Source ---
-    server.addHandler(&logEvents);
+    char value[CPARSER_MAX_LINE + 1];
+    for (JsonPair entry : doc.as<JsonObject>()) {
+        JsonArray list = entry.value().as<JsonArray>();
+        size_t count = list.isNull() ? 1 : list.size();
+        for (size_t i = 0; i < count; i++) {
+            ConfigDiagCode problem;
+            JsonVariantConst v = list.isNull() ? JsonVariantConst(entry.value()) : JsonVariantConst(list[i]);
+            if (!jsonToConfigValue(v, value, sizeof(value), problem)) return cparser_diagText(problem);
+
+            const char* key = entry.key().c_str();
+            if (strpbrk(key, "=\r\n") != nullptr || strpbrk(value, "\r\n") != nullptr) {
+                return "Invalid character in key or value";
+            }
+            uploadWrite(key, strlen(key));
+            uploadWrite("=", 1);
+            uploadWrite(value, strlen(value));
+            uploadWrite("\n", 1);
+        }
+    }
+    return nullptr;
+}
 
-    // --- Log Endpoint ---
-    server.on("/log", HTTP_GET, [](AsyncWebServerRequest *request) {
-        String html = R"rawliteral(
-        <html>
-        <head>
-            <title>Live Log</title>
-            <style>
-                body { font-family: monospace; background:#111; color:#0f0; padding:10px; }
-                #log { white-space: pre-wrap; }
-            </style>
-        </head>
-        <body>
-            <h2>Live Log</h2>
-            <div id="log"></div>
-
-            <script>
-                const logDiv = document.getElementById("log");
-                const evt = new EventSource("/log/events");
-
-                evt.addEventListener("log", function(e) {
-                    logDiv.innerText += e.data + "\n";
-                    window.scrollTo(0, document.body.scrollHeight);
-                });
-            </script>
-        </body>
-        </html>
-        )rawliteral";
-
-        request->send(200, "text/html", html);
-    });
+/**
+ * @brief POST /save_config body: called per received chunk.
+ */
+static void configUploadBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        if (upload.owner != nullptr) return;    // another upload is running
+        upload.owner = request;
+        upload.json = request->contentType().startsWith("application/json");
+        upload.tooLarge = false;
+        upload.jsonLength = 0;
+        upload.writing = configWriteBegin(upload.writer);
+        cparser_begin(upload.parser, upload.parsed);
+        request->onDisconnect([request]() {
+            if (upload.owner == request) uploadRelease();
+        });
+    }
+    if (upload.owner != request || upload.tooLarge || !upload.writing) return;
 
-    // Status Page with JSON
-    server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+    // Content-Length is checked per chunk, the data is dropped once it is exceeded
+    size_t limit = upload.json ? sizeof(upload.jsonBody) : CONFIG_UPLOAD_MAX_BYTES;
+    if (total > limit || index + len > limit) {
+        upload.tooLarge = true;
+        return;
+    }
 
-    BmeStatus bme = bme_getStatus();
-    DewStatus dew = dew_getStatus();
-    const WandererStatus* w = usb_manager_get_parsed_status();
-    uint8_t potibrightness = getPotiBrightness();
-    unsigned long now = millis();
-
-    StaticJsonDocument<768> doc;
-
-    // --- BME and internals ---
-    doc["bme"]["present"]     = bme.present;
-    doc["bme"]["temperature"] = bme.temperature;
-    doc["bme"]["humidity"]    = bme.humidity;
-    doc["bme"]["pressure"]    = bme.pressure;
-    doc["bme"]["voltage"]    = power_readSupplyVoltage();
-    doc["bme"]["systime"]    = now;
-    doc["bme"]["time"]    = getTimeString();
-
-    // --- Dew ---
-    doc["dew"]["temperature"] = dew.temperature;
-    doc["dew"]["humidity"]    = dew.humidity;
-    doc["dew"]["dewPoint"]    = dew.dewPoint;
-    doc["dew"]["dew1Power"]   = power_getDew1Level();
-    doc["dew"]["dew1MaxPower"]   = dew1Level;
-    doc["dew"]["dew2Power"]   = power_getDew2Level();
-    doc["dew"]["dew2MaxPower"]   = dew2Level;
-    doc["dew"]["active"]      = dew.active;
-
-
-    // --- Wanderer ---
-    if (w) {
-        doc["wanderer"]["firmware"]          = w->firmware;
-        doc["wanderer"]["close_position"]    = w->close_position;
-        doc["wanderer"]["open_position"]     = w->open_position;
-        doc["wanderer"]["current_position"]  = w->current_position;
-        doc["wanderer"]["input_voltage"]     = w->input_voltage;
-        doc["wanderer"]["brightness"]        = w->brightness;
-        doc["wanderer"]["dew_heater"]         = w->dew_heater;
-        doc["wanderer"]["asiair_enabled"]     = w->asiair_enabled;
-        doc["wanderer"]["connection_status"]  = w->connection_status;
-        doc["wanderer"]["poti_brightness"]    = potibrightness;
+    if (upload.json) {
+        memcpy(upload.jsonBody + index, data, len);
+        upload.jsonLength = index + len;
     } else {
-        doc["wanderer"]["connection_status"] = false;
+        uploadWrite(reinterpret_cast<const char*>(data), len);
     }
+}
 
-    String json;
-    serializeJson(doc, json);
-    request->send(200, "application/json", json);
-});
-
-server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-
-    String html = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<meta charset="utf-8">
-<title>Status</title>
-<style>
-    body {
-        font-family: Arial, sans-serif;
-        background: #111;
-        color: #eee;
-        margin: 0;
-        padding: 20px;
+/**
+ * @brief POST /save_config: called once the body is complete.
+ */
+static void configUploadDone(AsyncWebServerRequest *request) {
+    const String &type = request->contentType();
+    if (type.startsWith("application/x-www-form-urlencoded") || type.startsWith("multipart/")) {
+        request->send(415, "text/plain", "Send config.txt as the request body (text or JSON)");
+        return;
     }
-    h1 {
-        margin-bottom: 10px;
+    if (upload.owner != request) {
+        if (request->contentLength() == 0) request->send(400, "text/plain", "Empty body");
+        else request->send(409, "text/plain", "Another upload is running");
+        return;
     }
-    .grid {
-        display: grid;
-        grid-template-columns: repeat(auto-fit, minmax(260px, 1fr));
-        gap: 15px;
+    if (upload.tooLarge) {
+        uploadRelease();
+        request->send(413, "text/plain", "Config too large");
+        return;
     }
-    .card {
-        background: #1e1e1e;
-        border-radius: 8px;
-        padding: 15px;
-        box-shadow: 0 0 10px rgba(0,0,0,0.4);
+    if (!upload.writing) {
+        uploadRelease();
+        request->send(500, "text/plain", "Could not write config.txt");
+        return;
+    }
+
+    if (upload.json) {
+        const char* error = uploadJson();
+        if (error != nullptr) {
+            uploadRelease();
+            request->send(400, "text/plain", error);
+            return;
+        }
     }
-    .card h2 {
-        margin-top: 0;
-        font-size: 18px;
-        border-bottom: 1px solid #333;
-        padding-bottom: 6px;
+
+    // Rejected if any line has a problem, config.txt stays unchanged
+    cparser_end(upload.parser);
+    if (upload.parser.problems > 0) {
+        char text[512];
+        size_t n = snprintf(text, sizeof(text), "config.txt not saved, %u problem(s):\n", upload.parser.problems);
+        for (uint8_t i = 0; i < upload.parser.diagCount && n < sizeof(text); i++) {
+            const ConfigDiag &d = upload.parser.diags[i];
+            n += snprintf(text + n, sizeof(text) - n, "line %u: %s%s%s\n", d.line,
+                          cparser_diagText(d.code), d.key[0] ? " - " : "", d.key);
+        }
+        uploadRelease();
+        request->send(400, "text/plain", text);
+        return;
     }
-    .row {
-        display: flex;
-        justify-content: space-between;
-        margin: 6px 0;
+
+    // Temp file + rename: a power loss keeps the old config.txt
+    upload.writing = false;
+    bool written = configWriteCommit(upload.writer);
+    if (!written) {
+        uploadRelease();
+        request->send(500, "text/plain", "Could not write config.txt");
+        return;
     }
-    .ok { color: #4caf50; }
-    .warn { color: #ff9800; }
-    .err { color: #f44336; }
-</style>
-</head>
-<body>
-
-<h1>System Status</h1>
-
-<div class="grid">
-
-    <div class="card">
-        <h2>Environment</h2>
-        <div class="row"><span>Sensor Present</span><span id="bme_present">-</span></div>
-        <div class="row"><span>Temp</span><span id="bme_temp">-</span></div>
-        <div class="row"><span>Humidity</span><span id="bme_hum">-</span></div>
-        <div class="row"><span>Pressure</span><span id="bme_pres">-</span></div>
-        <div class="row"><span>Supply Voltage</span><span id="bme_volt">-</span></div>
-        <div class="row"><span>System Time</span><span id="bme_systime">-</span></div>
-        <div class="row"><span>Local Time</span><span id="bme_time">-</span></div>
-    </div>
-
-    <div class="card">
-        <h2>Dew Control</h2>
-        <div class="row"><span>Temp</span><span id="dew_temp">-</span></div>
-        <div class="row"><span>Humidity</span><span id="dew_hum">-</span></div>
-        <div class="row"><span>Dew Point</span><span id="dew_dp">-</span></div>
-        <div class="row"><span>Heater 1</span><span id="dew1">-</span></div>
-        <div class="row"><span>Heater 1 Max</span><span id="dew1max">-</span></div>
-        <div class="row"><span>Heater 2</span><span id="dew2">-</span></div>
-        <div class="row"><span>Heater 2 Max</span><span id="dew2max">-</span></div>
-        <div class="row"><span>Status</span><span id="dew_active">-</span></div>
-    </div>
-
-    <div class="card">
-        <h2>Wanderer Cover</h2>
-        <div class="row"><span>Firmware</span><span id="fw">-</span></div>
-        <div class="row"><span>Position</span><span id="pos">-</span></div>
-        <div class="row"><span>Voltage</span><span id="vin">-</span></div>
-        <div class="row"><span>Brightness</span><span id="bright">-</span></div>
-        <div class="row"><span>ASIAIR</span><span id="asiair">-</span></div>
-        <div class="row"><span>Connection</span><span id="conn">-</span></div>
-        <div class="row"><span>Poti Position</span><span id="poti">-</span></div>
-    </div>
-
-</div>
-
-<div class="grid">
-    <div class="card">
-        <h2>Actions</h2>
-        <div class="row">
-            <button onclick="openCover()">Open Cover</button>
-            <button onclick="setBrightness()">Turn On Light</button>
-
-        </div>
-        <div class="row" style="margin-top:10px;">
-            <button onclick="closeCover()">Close Cover</button>
-            <button onclick="turnOffLight()">Turn Off Light</button>
-        </div>
-    </div>
-
-</div>
-
-<script>
-async function updateStatus() {
-    try {
-        const r = await fetch("/status");
-        const s = await r.json();
-
-        document.getElementById("bme_present").innerText = s.bme.present ? "YES" : "NO";
-        document.getElementById("bme_temp").innerText = s.bme.temperature.toFixed(1) + " °C";
-        document.getElementById("bme_hum").innerText = s.bme.humidity.toFixed(1) + " %";
-        document.getElementById("bme_pres").innerText = s.bme.pressure.toFixed(0) + " hPa";
-        document.getElementById("bme_volt").innerText = s.bme.voltage.toFixed(2) + " V";
-        document.getElementById("bme_systime").innerText = s.bme.systime + " ms";
-        document.getElementById("bme_time").innerText = s.bme.time;
-
-        document.getElementById("dew_temp").innerText = s.dew.temperature.toFixed(1) + " °C";
-        document.getElementById("dew_hum").innerText = s.dew.humidity.toFixed(1) + " %";
-        document.getElementById("dew_dp").innerText = s.dew.dewPoint.toFixed(1) + " °C";
-        document.getElementById("dew1").innerText = s.dew.dew1Power + " %";
-        document.getElementById("dew1max").innerText = s.dew.dew1MaxPower + " %";
-        document.getElementById("dew2").innerText = s.dew.dew2Power + " %";
-        document.getElementById("dew2max").innerText = s.dew.dew2MaxPower + " %";
-        document.getElementById("dew_active").innerText = s.dew.active ? "ACTIVE" : "OFF";
-
-        document.getElementById("fw").innerText = s.wanderer.firmware;
-        document.getElementById("pos").innerText =
-            s.wanderer.current_position.toFixed(1) + " °";
-        document.getElementById("vin").innerText =
-            s.wanderer.input_voltage.toFixed(2) + " V";
-        document.getElementById("bright").innerText = s.wanderer.brightness;
-        document.getElementById("asiair").innerText =
-            s.wanderer.asiair_enabled ? "ENABLED" : "DISABLED";
-        document.getElementById("conn").innerText =
-            s.wanderer.connection_status ? "CONNECTED" : "DISCONNECTED";
-        document.getElementById("poti").innerText = s.wanderer.poti_brightness;
-
-    } catch (e) {
-        console.log("Status update failed", e);
+
+    // Parsed while it was written, no need to read it back from SD
+    bool stored = config_importParsed(upload.parsed);
+    uploadRelease();
+    if (!stored) {
+        request->send(500, "text/plain", "Applied, but could not be stored");
+        return;
     }
+    request->send(200, "text/plain", "OK");
 }
 
-updateStatus();
-setInterval(updateStatus, 2000);
+/**
+ * @brief Sends an embedded gzipped page, or 304 if the browser has it cached.
+ */
+static void sendAsset(AsyncWebServerRequest *request, const WebAsset &asset) {
+    AsyncWebServerResponse *response;
 
-function sendCommand(url) {
-    fetch(url, { method: "POST" })
-        .then(r => console.log("Command sent:", url))
-        .catch(e => console.error("Command failed:", url, e));
+    const AsyncWebHeader *match = request->getHeader("If-None-Match");
+    if (match != nullptr && match->value() == asset.etag) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", WEB_CACHE_CONTROL);
+    request->send(response);
 }
 
-function openCover() {
-    sendCommand("/action/open_cover");
-}
+/**
+ * @brief Initializes the web server and registers all HTTP routes.
+ */
+void initWebServer() {
 
-function closeCover() {
-    sendCommand("/action/close_cover");
-}
+    registerMetrics();
+    server.addMiddleware(countRequest);
 
-function turnOffLight() {
-    sendCommand("/action/turn_off_light");
-}
+    // --- Prometheus metrics, formatted only here ---
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+        AsyncResponseStream *response =
+            request->beginResponseStream("text/plain; version=0.0.4", METRICS_RESPONSE_SIZE);
+        metrics_write(*response);
+        request->send(response);
+    });
 
-function setBrightness() {
-    sendCommand("/action/set_brightness");
-}
+#if TASK_PROFILE
+    // --- Job run-time profile (reset before /profile, which would also match) ---
+    server.on("/profile/reset", HTTP_POST, [](AsyncWebServerRequest *request) {
+        task_profileReset();
+        request->send(200, "text/plain", "OK");
+    });
 
-</script>
+    server.on("/profile", HTTP_GET, [](AsyncWebServerRequest *request) {
+        AsyncResponseStream *response = request->beginResponseStream("text/plain", 2048);
+        task_profileWrite(*response);
+        request->send(response);
+    });
+#endif
 
-</body>
-</html>
-)rawliteral";
+    // --- config.txt for the /config page ---
+    server.on("/config.txt", HTTP_GET, [](AsyncWebServerRequest *request) {
+        if (!SD.exists("/config.txt")) {
+            request->send(404, "text/plain", "Could not open config.txt");
+            return;
+        }
+        request->send(SD, "/config.txt", "text/plain");
+    });
 
-    request->send(200, "text/html", html);
-});
+    // --- WiFi scan result for the /config page ---
+    server.on("/wifi/networks", HTTP_GET, [](AsyncWebServerRequest *request) {
+        WifiScanResult scan = wifi_getScanResult();
+        JsonDocument doc;
+        JsonArray list = doc.to<JsonArray>();
+        for (uint8_t i = 0; i < scan.count; i++) {
+            JsonObject net = list.add<JsonObject>();
+            net["ssid"] = scan.networks[i].ssid;
+            net["rssi"] = scan.networks[i].rssi;
+        }
+
+        // 202 while a scan is running: the list is the previous result
+        String json;
+        serializeJson(doc, json);
+        request->send(scan.scanning ? 202 : 200, "application/json", json);
+    });
+
+    // --- Save Config: streamed body, config.txt as text or JSON ---
+    server.on("/save_config", HTTP_POST, configUploadDone, nullptr, configUploadBody);
+
+    // --- Reload Config ---
+    server.on("/reload_config", HTTP_POST, [](AsyncWebServerRequest *request) {
+        loadConfigFromSD();
+        request->redirect("/config");
+    });
+
+    // --- Change single keys, e.g. {"dew1_level": 50, "wifi": ["SSID;PASSWORD"]} ---
+    // Stored in NVS only: config.txt is not rewritten or re-parsed
+    AsyncCallbackJsonWebHandler *configPatch = new AsyncCallbackJsonWebHandler("/config", patchConfig);
+    configPatch->setMethod(HTTP_PATCH);
+    configPatch->setMaxContentLength(CONFIG_JSON_MAX_BYTES);
+    server.addHandler(configPatch);
+
+    // --- Rescan WiFi ---
+    server.on("/rescan_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
+        wifi_requestScan();
+        request->send(200, "text/plain", "OK");
+    });
+
+    // --- Log Event Source ---
+    logEvents.onConnect([](AsyncEventSourceClient *client) {
+        // Replay the boot log; a reconnecting browser sends Last-Event-ID and gets only new lines
+        if (client->lastId() != 0) return;
+        static char bootLog[LOG_BOOT_BYTES];
+        size_t n = log_spool_copyBootLog(bootLog, sizeof(bootLog));
+        if (n > 0 && bootLog[n - 1] == '\n') bootLog[--n] = '\0';
+        if (n > 0) client->send(bootLog, "log", 1);
+    });
+    server.addHandler(&logEvents);
+    log_addSink(logEventSink);
+
+    // --- Log levels (before /log, which would also match /log/level) ---
+    server.on("/log/level", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["compiled"] = log_levelName(LOG_LEVEL);
+        for (uint8_t m = 0; m < LOG_MOD_COUNT; m++) {
+            doc["modules"][log_moduleName(m)] = log_levelName(log_getLevel(m));
+        }
+
+        String json;
+        serializeJson(doc, json);
+        request->send(200, "application/json", json);
+    });
+
+    // POST /log/level?module=usb&level=debug  (module=all sets every module)
+    server.on("/log/level", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (!request->hasParam("module") || !request->hasParam("level")) {
+            request->send(400, "text/plain", "Missing module or level parameter");
+            return;
+        }
+
+        int module = log_moduleFromName(request->getParam("module")->value().c_str());
+        int level = log_levelFromName(request->getParam("level")->value().c_str());
+        if (module < 0 || level < 0) {
+            request->send(400, "text/plain", "Unknown module or level");
+            return;
+        }
+        if (level < LOG_LEVEL) {
+            request->send(400, "text/plain", "Level not compiled in (LOG_LEVEL)");
+            return;
+        }
+
+        log_setLevel(module, level);
+        request->send(200, "text/plain", "OK");
+    });
+
+    // Pushed status updates (before /status, which would also match /status/events)
+    status_stream_begin(server);
+
+    // Status snapshot as JSON (fallback for clients without SSE)
+    server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+        // Written field by field into the pre-sized response buffer
+        AsyncResponseStream *response = request->beginResponseStream("application/json", STATUS_JSON_MAX);
+        status_stream_writeSnapshot(*response);
+        request->send(response);
+    });
 
 server.on("/action/open_cover", HTTP_POST, [](AsyncWebServerRequest *request){
     usb_manager_open_cover();
@@ -468,6 +536,14 @@ server.on("/action/set_brightness", HTTP_POST, [](AsyncWebServerRequest *request
     request->send(200, "text/plain", "OK");
 });
 
+    // --- Embedded pages (/, /config, /log), after the more specific /log/... routes ---
+    for (size_t i = 0; i < WEB_ASSET_COUNT; i++) {
+        const WebAsset &asset = WEB_ASSETS[i];
+        server.on(asset.url, HTTP_GET, [&asset](AsyncWebServerRequest *request) {
+            sendAsset(request, asset);
+        });
+    }
+
     // Start server
     server.begin();
 }
@@ -6,7 +6,9 @@
  * @brief Web interface for configuration and WiFi scanning.
  *
  * This module provides:
- *  - A configuration page at /config
+ *  - The pages /, /config and /log, embedded gzipped from web/ (web_assets.h)
+ *    and cached by the browser via ETag
+ *  - JSON endpoints for the dynamic data (/status, /wifi/networks, /log/level)
  *  - Display and editing of config.txt from the SD card
  *  - WiFi network scanning with RSSI display
  *  - Buttons for reloading and saving configuration
@@ -19,11 +21,3 @@
  * Must be called once after WiFi initialization.
  */
 void initWebServer();
-
-/**
- * @brief Performs a WiFi scan and updates the HTML table content.
- *
- * Called automatically at startup and when the user presses
- * the "Rescan WiFi Networks" button.
- */
-void updateWiFiScanResults();
@@ -3,18 +3,259 @@
  * @brief WiFi management
  *
  * - initWiFi(): Sets the WiFi mode
- * - handleWiFi(): Cyclically connects to known networks
+ * - handleWiFi(): Scan/connect state machine, never blocks the network task
+ *
+ * The last network that worked (SSID, BSSID, channel) is kept in NVS.
+ * After boot or a connection loss it is tried first with a direct,
+ * channel-locked connect; the full scan is only the fallback.
  */
 
+#define LOG_MODULE LOG_MOD_WIFI
+
 #include "wifi_config.h"
 #include "config_manager.h"
 #include "led_manager.h"
 #include "time_manager.h"
+#include "task_manager.h"
 #include <WiFi.h>
+#include <Preferences.h>
+#include <atomic>
 #include "web_log.h"
+#include "metrics.h"
+#include "snapshot.h"
+
+/**
+ * @brief A scan that has not completed after this time is abandoned (ms)
+ */
+#define WIFI_SCAN_TIMEOUT_MS 15000
+
+/**
+ * @brief NVS namespace of the last good network
+ */
+#define WIFI_NVS_NAMESPACE "wifi"
+
+/**
+ * @struct WifiLastGood
+ * @brief Last network a connection succeeded with (persisted in NVS)
+ */
+struct WifiLastGood {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;    ///< 0 = no entry
+};
+
+/**
+ * @enum WifiState
+ * @brief State of handleWiFi()
+ */
+enum WifiState : uint8_t {
+    WIFI_SM_IDLE,           ///< Not connected, nothing to do (no known networks)
+    WIFI_SM_SCANNING,       ///< Async scan running
+    WIFI_SM_CONNECTING,     ///< WiFi.begin() issued, waiting for WL_CONNECTED
+    WIFI_SM_CONNECTED,
+    WIFI_SM_BACKOFF         ///< All candidates failed, waiting before the next scan
+};
+
+static MetricCounter connects;
+static MetricCounter connectAttempts;
+
+// Time from boot/connection loss to WL_CONNECTED, in ms
+static const uint32_t CONNECT_BOUNDS_MS[] = { 500, 1000, 2000, 3000, 5000, 10000, 20000, 60000 };
+static MetricHistogram connectTimeFast;
+static MetricHistogram connectTimeScan;
+
+// State machine, network task only
+static WifiState state = WIFI_SM_IDLE;
+static bool linkUp = false;
+static uint32_t stateSince = 0;
+static uint32_t backoffMs = WIFI_BACKOFF_MIN_MS;
+static uint32_t linkDownSince = 0;
+static TaskJobId wifiJob = TASK_JOB_INVALID;
+
+static WifiLastGood lastGood;
+static bool fastTried = false;      // direct connect already tried since the link went down
+static bool fastActive = false;     // current attempt is the direct connect
+
+// Copy of the wifi list from the configuration, network task only
+static WifiEntry known[WIFI_LIST_SIZE];
+static uint8_t knownCount = 0;
+static std::atomic<bool> knownChanged(true);    // set by the config listener
+
+// Known networks found by the last scan, strongest first (indices into known)
+static uint8_t candidates[WIFI_LIST_SIZE];
+static uint8_t candidateCount = 0;
+static uint8_t candidateNext = 0;
+
+static std::atomic<bool> scanRequested(true);   // scan once after boot for /config
+static WifiScanResult scanWork;                 // network task only
+static Snapshot<WifiScanResult> scanPublished;  // read by the web server
+
+static void enterState(WifiState next) {
+    state = next;
+    stateSince = millis();
+}
+
+/**
+ * @brief Takes over a changed wifi list from the configuration.
+ */
+static void refreshKnown() {
+    if (!knownChanged.exchange(false, std::memory_order_relaxed)) return;
+    ConfigData c = config_get();
+    memcpy(known, c.wifi, sizeof(known));
+    knownCount = c.wifiCount;
+    LOG_DEBUG("WiFi: %u known networks", knownCount);
+}
+
+/**
+ * @brief Config listener (web server task): wifi list changed.
+ */
+static void onWifiListChanged(const ConfigData &) {
+    knownChanged.store(true, std::memory_order_relaxed);
+    // Not connected: try the new entries now instead of after the backoff
+    if (!isWiFiConnected()) wifi_requestScan();
+}
+
+/**
+ * @brief Loads the last good network from NVS.
+ */
+static void loadLastGood() {
+    Preferences prefs;
+    memset(&lastGood, 0, sizeof(lastGood));
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, true)) return;
+    if (prefs.getBytes("last", &lastGood, sizeof(lastGood)) != sizeof(lastGood)) {
+        memset(&lastGood, 0, sizeof(lastGood));
+    }
+    prefs.end();
+}
+
+/**
+ * @brief Stores the current connection as last good network (only if changed).
+ */
+static void saveLastGood() {
+    WifiLastGood current;
+    memset(&current, 0, sizeof(current));
+    strlcpy(current.ssid, WiFi.SSID().c_str(), sizeof(current.ssid));
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = (uint8_t)WiFi.channel();
+
+    if (memcmp(&current, &lastGood, sizeof(current)) == 0) return;     // spare the flash
+
+    Preferences prefs;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        LOG_WARN("WiFi: cannot open NVS");
+        return;
+    }
+    prefs.putBytes("last", &current, sizeof(current));
+    prefs.end();
+    lastGood = current;
+    LOGF("WiFi: saved %s (channel %u)", lastGood.ssid, lastGood.channel);
+}
+
+/**
+ * @brief Direct connect to the last good network, without a scan.
+ *
+ * @return false if there is no usable entry (unknown or removed from config.txt)
+ */
+static bool connectLastGood() {
+    if (lastGood.channel == 0) return false;
+
+    for (uint8_t j = 0; j < knownCount; j++) {
+        if (strcmp(known[j].ssid, lastGood.ssid) != 0) continue;
+
+        LOGF("Connecting to %s (cached, channel %u)", lastGood.ssid, lastGood.channel);
+        metric_inc(connectAttempts);
+        WiFi.begin(lastGood.ssid, known[j].password, lastGood.channel, lastGood.bssid);
+        fastActive = true;
+        enterState(WIFI_SM_CONNECTING);
+        task_runIn(wifiJob, WIFI_POLL_INTERVAL_MS);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Starts an async scan (returns immediately).
+ */
+static void startScan() {
+    scanRequested.store(false, std::memory_order_relaxed);
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        LOG_WARN("WiFi scan could not be started");
+        enterState(WIFI_SM_IDLE);
+        return;
+    }
+    LOG("WiFi scanning...");
+    scanWork.scanning = true;
+    scanPublished.publish(scanWork);
+    enterState(WIFI_SM_SCANNING);
+    task_runIn(wifiJob, WIFI_POLL_INTERVAL_MS);
+}
+
+/**
+ * @brief Copies a completed scan into the cache and ranks the known networks.
+ *
+ * @param n Result of WiFi.scanComplete(), < 0 if the scan failed
+ */
+static void storeScan(int n) {
+    if (n < 0) {
+        LOG_WARN("WiFi scan failed");
+        n = 0;
+    }
 
-static unsigned long lastCheck = 0;
-static const unsigned long CHECK_INTERVAL = 10000;
+    scanWork.count = 0;
+    for (int i = 0; i < n && scanWork.count < WIFI_SCAN_MAX; i++) {
+        WifiNetwork &net = scanWork.networks[scanWork.count++];
+        strlcpy(net.ssid, WiFi.SSID(i).c_str(), sizeof(net.ssid));
+        net.rssi = WiFi.RSSI(i);
+        LOG_DEBUG("%s (RSSI %d)", net.ssid, (int)net.rssi);
+    }
+    WiFi.scanDelete();
+    scanWork.scanning = false;
+    scanPublished.publish(scanWork);
+
+    // Best RSSI per known network, then insertion sort (at most 10 entries)
+    int32_t rssi[WIFI_LIST_SIZE];
+    candidateCount = 0;
+    candidateNext = 0;
+    for (uint8_t j = 0; j < knownCount; j++) {
+        int32_t best = INT32_MIN;
+        for (uint8_t i = 0; i < scanWork.count; i++) {
+            if (strcmp(known[j].ssid, scanWork.networks[i].ssid) == 0 && scanWork.networks[i].rssi > best) {
+                best = scanWork.networks[i].rssi;
+            }
+        }
+        if (best == INT32_MIN) continue;
+
+        uint8_t k = candidateCount++;
+        while (k > 0 && rssi[k - 1] < best) {
+            candidates[k] = candidates[k - 1];
+            rssi[k] = rssi[k - 1];
+            k--;
+        }
+        candidates[k] = j;
+        rssi[k] = best;
+    }
+
+    LOGF("WiFi scan: %u networks, %u known", scanWork.count, candidateCount);
+}
+
+/**
+ * @brief Tries the next candidate, or starts the backoff if none is left.
+ */
+static void connectNext() {
+    if (candidateNext >= candidateCount) {
+        LOGF("No known network reachable, next scan in %lus", (unsigned long)(backoffMs / 1000));
+        enterState(WIFI_SM_BACKOFF);
+        return;
+    }
+
+    const WifiEntry &entry = known[candidates[candidateNext++]];
+    LOGF("Connecting to %s", entry.ssid);
+    metric_inc(connectAttempts);
+    fastActive = false;
+    WiFi.begin(entry.ssid, entry.password);
+    enterState(WIFI_SM_CONNECTING);
+    task_runIn(wifiJob, WIFI_POLL_INTERVAL_MS);
+}
 
 /**
  * @brief Initializes the WiFi module.
@@ -27,79 +268,121 @@ void initWiFi() {
     WiFi.disconnect(true);
     setLedMode(LED_WLAN, LED_MODE_OFF);
     delay(100);
+    loadLastGood();
+
+    metrics_register("cover_wifi_connects_total", "WiFi connections established", nullptr, connects);
+    metrics_register("cover_wifi_connect_attempts_total", "WiFi.begin() calls", nullptr, connectAttempts);
+    metrics_register("cover_wifi_connect_duration_ms", "Time from boot or connection loss to connected",
+                     "path=\"cached\"", connectTimeFast, CONNECT_BOUNDS_MS);
+    metrics_register("cover_wifi_connect_duration_ms", "Time from boot or connection loss to connected",
+                     "path=\"scan\"", connectTimeScan, CONNECT_BOUNDS_MS);
+    wifiJob = task_register(TASK_NET, "wifi", handleWiFi, WIFI_CHECK_INTERVAL_MS);
+    config_subscribe("wifi", onWifiListChanged);
+
+    // React to connect/disconnect at once instead of at the next check
+    WiFi.onEvent([](arduino_event_id_t, arduino_event_info_t) { task_trigger(wifiJob); },
+                 ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent([](arduino_event_id_t, arduino_event_info_t) { task_trigger(wifiJob); },
+                 ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
 }
 
 /**
  * @brief Handles WiFi connection management.
  *
- * Periodically scans for available networks and attempts to connect to the strongest known network.
+ * Runs every WIFI_CHECK_INTERVAL_MS as a network task job, and every
+ * WIFI_POLL_INTERVAL_MS while a scan or connection attempt is running.
+ * Every call returns immediately.
  * Updates the WiFi LED indicator based on connection status.
  * Initializes the time manager upon successful connection.
  */
 void handleWiFi() {
-    static wl_status_t lastStatus = WL_IDLE_STATUS;
-
-    if (millis() - lastCheck < CHECK_INTERVAL) return;
-    lastCheck = millis();
-
+    uint32_t now = millis();
     wl_status_t status = WiFi.status();
+    bool connected = (status == WL_CONNECTED);
 
-    // --- Detect status change ---
-    if (status != lastStatus) {
-        lastStatus = status;
+    // --- Connection established or lost (in any state, a running scan is finished first) ---
+    if (connected != linkUp) {
+        linkUp = connected;
+        backoffMs = WIFI_BACKOFF_MIN_MS;
 
-        if (status == WL_CONNECTED) {
-            LOG("WiFi connected");
+        if (connected) {
+            uint32_t took = now - linkDownSince;
+            LOGF("WiFi connected after %lums", (unsigned long)took);
+            metric_inc(connects);
+            metric_observe(fastActive ? connectTimeFast : connectTimeScan, took);
             setLedMode(LED_WLAN, LED_MODE_ON);
-
+            saveLastGood();
             initTimeManager();
-            return;
+            if (state != WIFI_SM_SCANNING) enterState(WIFI_SM_CONNECTED);
         } else {
+            LOG_WARN("WiFi connection lost");
             setLedMode(LED_WLAN, LED_MODE_BLINK_SLOW);
+            linkDownSince = now;
+            fastTried = false;
+            if (state == WIFI_SM_CONNECTED) enterState(WIFI_SM_IDLE);
         }
     }
 
-    if (status == WL_CONNECTED) return;
-    if (wifiCount == 0) return;
-
-    setLedMode(LED_WLAN, LED_MODE_BLINK_SLOW);
+    // The candidates of a running scan/connect refer to the current list
+    if (state != WIFI_SM_SCANNING && state != WIFI_SM_CONNECTING) refreshKnown();
 
-    LOG("WiFi scanning...");
-
-    int n = WiFi.scanNetworks();
-    if (n <= 0) {
-        LOG("No networks found");
-        return;
-    }
+    switch (state) {
+    case WIFI_SM_IDLE:
+        if (!fastTried) {
+            fastTried = true;
+            if (connectLastGood()) break;
+        }
+        if (scanRequested.load(std::memory_order_relaxed) || knownCount > 0) startScan();
+        break;
 
-    int bestIndex = -1;
-    int bestRssi = -1000;
-    LOG("Found following networks:");
-    for (int i = 0; i < n; i++) {
-        String ssid = WiFi.SSID(i);
-        int rssi = WiFi.RSSI(i);
+    case WIFI_SM_CONNECTED:
+        if (scanRequested.load(std::memory_order_relaxed)) startScan();
+        break;
 
-        LOG(ssid + " (RSSI " + String(rssi) + ")");
+    case WIFI_SM_SCANNING: {
+        int n = WiFi.scanComplete();
+        if (n == WIFI_SCAN_RUNNING && now - stateSince < WIFI_SCAN_TIMEOUT_MS) {
+            task_runIn(wifiJob, WIFI_POLL_INTERVAL_MS);
+            break;
+        }
+        storeScan(n == WIFI_SCAN_RUNNING ? WIFI_SCAN_FAILED : n);
 
-        for (int j = 0; j < wifiCount; j++) {
-            if (ssid == wifiList[j].ssid && rssi > bestRssi) {
-                bestRssi = rssi;
-                bestIndex = j;
-            }
+        if (linkUp) {
+            enterState(WIFI_SM_CONNECTED);      // scan requested by /config
+        } else if (knownCount == 0) {
+            enterState(WIFI_SM_IDLE);
+        } else {
+            setLedMode(LED_WLAN, LED_MODE_BLINK_SLOW);
+            connectNext();
         }
+        break;
     }
 
-    if (bestIndex < 0) {
-        LOG("No known networks found");
-        return;
+    case WIFI_SM_CONNECTING: {
+        bool failed = (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL);
+        uint32_t timeout = fastActive ? WIFI_FAST_CONNECT_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS;
+        if (!failed && now - stateSince < timeout) {
+            task_runIn(wifiJob, WIFI_POLL_INTERVAL_MS);
+            break;
+        }
+        LOG_WARN("%s", failed ? "WiFi connection failed" : "WiFi connection attempt timed out");
+        WiFi.disconnect();
+        if (fastActive) {
+            fastActive = false;
+            startScan();            // AP moved or gone: fall back to a full scan
+        } else {
+            connectNext();
+        }
+        break;
     }
 
-    LOG("Connecting to " + wifiList[bestIndex].ssid + " (RSSI " + String(bestRssi) + ")");
-
-    WiFi.begin(
-        wifiList[bestIndex].ssid.c_str(),
-        wifiList[bestIndex].password.c_str()
-    );
+    case WIFI_SM_BACKOFF:
+        if (scanRequested.load(std::memory_order_relaxed) || now - stateSince >= backoffMs) {
+            backoffMs = constrain(backoffMs * 2, WIFI_BACKOFF_MIN_MS, WIFI_BACKOFF_MAX_MS);
+            startScan();
+        }
+        break;
+    }
 }
 
 /**
@@ -110,3 +393,14 @@ void handleWiFi() {
 bool isWiFiConnected() {
     return WiFi.status() == WL_CONNECTED;
 }
+
+void wifi_requestScan() {
+    scanRequested.store(true, std::memory_order_relaxed);
+    task_trigger(wifiJob);
+}
+
+WifiScanResult wifi_getScanResult() {
+    WifiScanResult r = scanPublished.read();
+    r.scanning |= scanRequested.load(std::memory_order_relaxed);
+    return r;
+}
@@ -1,6 +1,17 @@
 /**
  * @file wifi_config.h
  * @brief WiFi initialization and reconnect logic
+ *
+ * handleWiFi() is a non-blocking state machine on the network task:
+ *  - scans asynchronously (scanNetworks(true), polled with scanComplete())
+ *  - first tries the last good network from NVS directly (cached BSSID
+ *    and channel, no scan)
+ *  - tries the known networks found by the scan, strongest first,
+ *    each for at most WIFI_CONNECT_TIMEOUT_MS
+ *  - if none connects, waits with exponential backoff before the next scan
+ *
+ * The last scan result is cached for the /config page, which requests
+ * scans through wifi_requestScan() instead of scanning itself.
  */
 
 #ifndef WIFI_CONFIG_H
@@ -8,8 +19,59 @@
 
 #include <Arduino.h>
 
+/**
+ * @brief Interval of the WiFi connection check (ms)
+ */
+#define WIFI_CHECK_INTERVAL_MS 10000
+
+/**
+ * @brief Poll interval while a scan or connection attempt is running (ms)
+ */
+#define WIFI_POLL_INTERVAL_MS 250
+
+/**
+ * @brief Time allowed for one connection attempt (ms)
+ */
+#define WIFI_CONNECT_TIMEOUT_MS 15000
+
+/**
+ * @brief Time allowed for the direct connect to the cached network (ms)
+ */
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 5000
+
+/**
+ * @brief Backoff after all known networks failed: first and maximum delay (ms)
+ */
+#define WIFI_BACKOFF_MIN_MS 10000
+#define WIFI_BACKOFF_MAX_MS 300000
+
+/**
+ * @brief Maximum number of networks kept from a scan
+ */
+#define WIFI_SCAN_MAX 20
+
+/**
+ * @struct WifiNetwork
+ * @brief One entry of the last WiFi scan
+ */
+struct WifiNetwork {
+    char ssid[33];
+    int32_t rssi;
+};
+
+/**
+ * @struct WifiScanResult
+ * @brief Cached result of the last completed scan
+ */
+struct WifiScanResult {
+    WifiNetwork networks[WIFI_SCAN_MAX];
+    uint8_t count;
+    bool scanning;      ///< A scan is requested or running
+};
+
 /**
  * @brief Initializes the WiFi module.
+ * Registers handleWiFi() with the network task.
  */
 void initWiFi();
 
@@ -24,4 +86,17 @@ void handleWiFi();
  */
 bool isWiFiConnected();
 
+/**
+ * @brief Requests a new scan, safe to call from any task.
+ *
+ * The scan starts on the next run of handleWiFi() unless a connection
+ * attempt is in progress, then it starts right after it.
+ */
+void wifi_requestScan();
+
+/**
+ * @brief Returns the cached scan result (consistent copy, any task).
+ */
+WifiScanResult wifi_getScanResult();
+
 #endif
@@ -0,0 +1,131 @@
+/**
+ * @file test_main.cpp
+ * @brief Button debouncing and poti hysteresis
+ *
+ * The buttons are driven through the fake GPIOs, whose edges fire the
+ * interrupt like on the board. The poti is read through analog_input.
+ */
+
+#include <unity.h>
+#include "hal_native.h"
+#include "pins.h"
+#include "analog_input.h"
+#include "button_manager.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+// Events seen by the handler since the last reset
+static int pressed = 0;
+static int clicked = 0;
+static int released = 0;
+
+static void onButton() {
+    if (buttonPressed(BTN_OPEN)) pressed++;
+    if (buttonClicked(BTN_OPEN)) clicked++;
+    if (buttonReleased(BTN_OPEN)) released++;
+}
+
+void setUp() {
+    pressed = clicked = released = 0;
+}
+
+void tearDown() {}
+
+static void test_press_and_click() {
+    hal_setDigital(PIN_BTN_OPEN, LOW);
+    hal_runTasks(20);
+    TEST_ASSERT_EQUAL(0, pressed);                  // still debouncing
+    TEST_ASSERT_FALSE(buttonIsDown(BTN_OPEN));
+
+    hal_runTasks(100);
+    TEST_ASSERT_EQUAL(1, pressed);
+    TEST_ASSERT_TRUE(buttonIsDown(BTN_OPEN));
+
+    hal_setDigital(PIN_BTN_OPEN, HIGH);
+    hal_runTasks(100);
+    TEST_ASSERT_EQUAL(1, pressed);
+    TEST_ASSERT_EQUAL(1, clicked);
+    TEST_ASSERT_EQUAL(0, released);
+    TEST_ASSERT_FALSE(buttonIsDown(BTN_OPEN));
+}
+
+static void test_bounce_ignored() {
+    for (int i = 0; i < 5; i++) {
+        hal_setDigital(PIN_BTN_OPEN, LOW);
+        hal_runTasks(10);
+        hal_setDigital(PIN_BTN_OPEN, HIGH);
+        hal_runTasks(10);
+    }
+    hal_runTasks(200);
+    TEST_ASSERT_EQUAL(0, pressed);
+    TEST_ASSERT_EQUAL(0, clicked);
+    TEST_ASSERT_FALSE(buttonIsDown(BTN_OPEN));
+}
+
+static void test_bouncing_press_reported_once() {
+    for (int i = 0; i < 3; i++) {
+        hal_setDigital(PIN_BTN_OPEN, LOW);
+        hal_runTasks(5);
+        hal_setDigital(PIN_BTN_OPEN, HIGH);
+        hal_runTasks(5);
+    }
+    hal_setDigital(PIN_BTN_OPEN, LOW);
+    hal_runTasks(200);
+    TEST_ASSERT_EQUAL(1, pressed);
+
+    hal_setDigital(PIN_BTN_OPEN, HIGH);
+    hal_runTasks(200);
+    TEST_ASSERT_EQUAL(1, clicked);
+}
+
+static void test_poti_scaling() {
+    // Inverted: full scale is dark. The hysteresis may stop the
+    // filtered value up to 3 counts short of the end.
+    hal_setAnalog(PIN_POT_LIGHT, 4095);
+    hal_runTasks(2000);
+    TEST_ASSERT_INT_WITHIN(1, 0, getPotiBrightness());
+
+    hal_setAnalog(PIN_POT_LIGHT, 0);
+    hal_runTasks(2000);
+    TEST_ASSERT_INT_WITHIN(1, 255, getPotiBrightness());
+}
+
+static void test_poti_hysteresis() {
+    // Raw 2055 and 2056 give different brightness steps (128 / 127)
+    hal_setAnalog(PIN_POT_LIGHT, 2056);
+    hal_runTasks(2000);
+    uint8_t level = getPotiBrightness();
+    TEST_ASSERT_INT_WITHIN(1, 127, level);
+
+    // A knob on the edge does not make the panel flicker
+    for (int i = 0; i < 20; i++) {
+        hal_setAnalog(PIN_POT_LIGHT, i % 2 ? 2056 : 2055);
+        hal_runTasks(POTI_UPDATE_INTERVAL_MS);
+        TEST_ASSERT_EQUAL(level, getPotiBrightness());
+    }
+
+    hal_setAnalog(PIN_POT_LIGHT, 2096);
+    hal_runTasks(2000);
+    TEST_ASSERT_INT_WITHIN(1, 125, getPotiBrightness());
+}
+
+int main(int argc, char** argv) {
+    log_begin();
+    initPins();
+    hal_setDigital(PIN_BTN_OPEN, HIGH);
+    hal_setDigital(PIN_BTN_CLOSE, HIGH);
+    hal_setDigital(PIN_BTN_LIGHT_ON, HIGH);
+    hal_setDigital(PIN_BTN_LIGHT_OFF, HIGH);
+    analog_init();
+    initButtons();
+    setButtonEventHandler(onButton);
+    task_start();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_press_and_click);
+    RUN_TEST(test_bounce_ignored);
+    RUN_TEST(test_bouncing_press_reported_once);
+    RUN_TEST(test_poti_scaling);
+    RUN_TEST(test_poti_hysteresis);
+    return UNITY_END();
+}
@@ -0,0 +1,630 @@
+/**
+ * @file test_main.cpp
+ * @brief config.txt parser: property tests and mutation fuzzing over a seed corpus
+ *
+ * config.txt is written by hand or uploaded through the web UI, so the
+ * parser has to cope with anything. Every input, hand written or mutated,
+ * must leave the parser and ConfigData in a valid state, give the same
+ * result however it is chunked, and export to a text that parses back to
+ * the same configuration without problems.
+ *
+ * The mutator is a fixed-seed LCG, a failure is reproducible from the
+ * iteration number in the message.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include "config_parser.h"
+
+// ---------------- Seed corpus ----------------
+
+static const char* const CORPUS[] = {
+    // Full file as shipped
+    "# WLAN (max 10)\r\n"
+    "wifi=MeinWLAN;passwort\r\n"
+    "wifi=Hotspot;12345678\r\n"
+    "ota_password=update123\r\n"
+    "led_brightness=80\r\n"
+    "led_brightness_dark=20\r\n"
+    "autoclose_cover=0\r\n"
+    "autoclose_time=05:00\r\n"
+    "dew1_level=70\r\n"
+    "dew2_level=70\r\n"
+    "dew_mode=ramp\r\n"
+    "lens1_probe=none\r\n"
+    "lens2_probe=none\r\n"
+    "dew_target_offset=3\r\n"
+    "dew_slew_rate=20\r\n"
+    "panel_slew_rate=50\r\n"
+    "dew1_watts=12\r\n"
+    "dew2_watts=12\r\n"
+    "panel_watts=6\r\n"
+    "power_budget=0\r\n"
+    "low_voltage=11.5\r\n"
+    "critical_voltage=10.5\r\n",
+
+    // Spacing, case and alternative spellings
+    "  LED_Brightness =  255 \t\n"
+    "AutoClose_Cover = yes\n"
+    "AUTOCLOSE_TIME=23:59\n"
+    "Dew_Mode = MPC\n"
+    "lens1_probe = DS18B20\n"
+    "low_voltage = 11,8\n"
+    "wifi =  Cafe Net ; pass word with spaces  \n",
+
+    // Values at and past the limits
+    "dew_target_offset=1\n"
+    "dew_target_offset=10\n"
+    "dew_target_offset=11\n"
+    "critical_voltage=25.5\n"
+    "critical_voltage=25.6\n"
+    "ota_password=0123456789012345678901234567890\n"
+    "ota_password=01234567890123456789012345678901\n"
+    "wifi=ssid;\n"
+    "wifi=;password\n",
+
+    // Bad numbers
+    "led_brightness=\n"
+    "led_brightness=-1\n"
+    "led_brightness=+5\n"
+    "led_brightness=0x10\n"
+    "led_brightness=1e2\n"
+    "led_brightness=99999\n"
+    "led_brightness=100000\n"
+    "low_voltage=11.55\n"
+    "low_voltage=.5\n"
+    "autoclose_time=5\n"
+    "autoclose_time=:\n",
+
+    // Duplicates and unknown keys
+    "dew1_level=10\n"
+    "dew1_level=20\n"
+    "DEW1_LEVEL=30\n"
+    "dew3_level=40\n"
+    "=50\n"
+    "no separator\n"
+    "# dew1_level=60\n",
+
+    // Truncated: no final newline, cut in the middle of a value
+    "wifi=a;b\n"
+    "autoclose_time=05:",
+
+    // Overlong line followed by a valid one
+    "# xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\n"
+    "dew2_level=5\n",
+
+    // Wifi list overflow
+    "wifi=n0;p\nwifi=n1;p\nwifi=n2;p\nwifi=n3;p\nwifi=n4;p\nwifi=n5;p\n"
+    "wifi=n6;p\nwifi=n7;p\nwifi=n8;p\nwifi=n9;p\nwifi=n10;p\n",
+
+    // Empty, blank lines only, lone separators
+    "",
+    "\n\n\r\n  \t\n",
+    "=\n;\n:\n#\n",
+};
+
+static const size_t CORPUS_SIZE = sizeof(CORPUS) / sizeof(CORPUS[0]);
+
+// ---------------- Helpers ----------------
+
+/**
+ * @brief Deterministic generator (Numerical Recipes LCG)
+ */
+static uint32_t rngState;
+
+static uint32_t rnd(uint32_t n) {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (rngState >> 8) % n;
+}
+
+static ConfigParser p, q;
+static ConfigData c, d;
+
+static void parse(ConfigParser &parser, ConfigData &out, const char* text, size_t len) {
+    cparser_begin(parser, out);
+    cparser_feed(parser, text, len);
+    cparser_end(parser);
+}
+
+/**
+ * @brief Parses text in random chunks of 1..maxChunk bytes.
+ */
+static void parseChunked(ConfigParser &parser, ConfigData &out, const char* text, size_t len, uint32_t maxChunk) {
+    cparser_begin(parser, out);
+    size_t pos = 0;
+    while (pos < len) {
+        size_t n = 1 + rnd(maxChunk);
+        if (n > len - pos) n = len - pos;
+        cparser_feed(parser, text + pos, n);
+        pos += n;
+    }
+    cparser_end(parser);
+}
+
+static bool terminated(const char* s, size_t size) {
+    return memchr(s, '\0', size) != nullptr;
+}
+
+static uint8_t choiceCount(const char* choices) {
+    uint8_t n = 1;
+    for (; *choices; choices++) {
+        if (*choices == '|') n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Checks that the parser state and every value are within the schema.
+ *
+ * @return nullptr if valid, otherwise what is wrong
+ */
+static const char* invalidState(const ConfigParser &parser, const ConfigData &cfg) {
+    if (parser.diagCount > CPARSER_MAX_DIAGS) return "diagCount > CPARSER_MAX_DIAGS";
+    if (parser.diagCount > parser.problems) return "diagCount > problems";
+    if (parser.length > CPARSER_MAX_LINE) return "line length";
+    for (uint8_t i = 0; i < parser.diagCount; i++) {
+        const ConfigDiag &diag = parser.diags[i];
+        if (diag.line < 1 || diag.line > parser.lineNo) return "diag line number";
+        if (diag.code > CDIAG_LIST_FULL) return "diag code";
+        if (!terminated(diag.key, sizeof(diag.key))) return "diag key not terminated";
+        if (i > 0 && diag.line < parser.diags[i - 1].line) return "diags out of order";
+    }
+
+    if (cfg.wifiCount > WIFI_LIST_SIZE) return "wifiCount";
+    for (uint8_t i = 0; i < WIFI_LIST_SIZE; i++) {
+        if (!terminated(cfg.wifi[i].ssid, sizeof(cfg.wifi[i].ssid))) return "ssid not terminated";
+        if (!terminated(cfg.wifi[i].password, sizeof(cfg.wifi[i].password))) return "password not terminated";
+        if (i < cfg.wifiCount && cfg.wifi[i].ssid[0] == '\0') return "empty ssid";
+    }
+
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const ConfigKey &k = CONFIG_KEYS[i];
+        const uint8_t* v = reinterpret_cast<const uint8_t*>(&cfg) + k.offset;
+        switch (k.type) {
+        case CKEY_BOOL:   if (v[0] > 1) return k.name;                                   break;
+        case CKEY_UINT8:
+        case CKEY_DECI:   if (v[0] < k.min || v[0] > k.max) return k.name;               break;
+        case CKEY_STRING: if (!terminated(reinterpret_cast<const char*>(v), k.size)) return k.name; break;
+        case CKEY_TIME:   if (v[0] > 23 || v[1] > 59) return k.name;                     break;
+        case CKEY_CHOICE: if (v[0] >= choiceCount(k.choices)) return k.name;             break;
+        case CKEY_WIFI:                                                                  break;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Compares two configurations by value (bytes after a string's terminator may differ).
+ */
+static bool sameConfig(const ConfigData &a, const ConfigData &b) {
+    char va[CPARSER_MAX_LINE + 1], vb[CPARSER_MAX_LINE + 1];
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        cparser_formatValue(CONFIG_KEYS[i], a, va, sizeof(va));
+        cparser_formatValue(CONFIG_KEYS[i], b, vb, sizeof(vb));
+        if (strcmp(va, vb) != 0) return false;
+    }
+    if (a.wifiCount != b.wifiCount) return false;
+    for (uint8_t i = 0; i < a.wifiCount; i++) {
+        if (strcmp(a.wifi[i].ssid, b.wifi[i].ssid) != 0) return false;
+        if (strcmp(a.wifi[i].password, b.wifi[i].password) != 0) return false;
+    }
+    return true;
+}
+
+static bool sameResult(const ConfigParser &a, const ConfigParser &b) {
+    return a.problems == b.problems && a.diagCount == b.diagCount && a.lineNo == b.lineNo &&
+           memcmp(a.diags, b.diags, a.diagCount * sizeof(ConfigDiag)) == 0;
+}
+
+/**
+ * @brief Writes cfg as config.txt, like the export of the web UI.
+ *
+ * @return Length, 0 if it did not fit
+ */
+static size_t exportText(const ConfigData &cfg, char* out, size_t size) {
+    size_t len = 0;
+    char value[CPARSER_MAX_LINE + 1];
+    for (uint8_t i = 0; i < cfg.wifiCount; i++) {
+        int n = snprintf(out + len, size - len, "wifi=%s;%s\n", cfg.wifi[i].ssid, cfg.wifi[i].password);
+        if (n < 0 || (size_t)n >= size - len) return 0;
+        len += n;
+    }
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (CONFIG_KEYS[i].type == CKEY_WIFI) continue;
+        cparser_formatValue(CONFIG_KEYS[i], cfg, value, sizeof(value));
+        int n = snprintf(out + len, size - len, "%s=%s\n", CONFIG_KEYS[i].name, value);
+        if (n < 0 || (size_t)n >= size - len) return 0;
+        len += n;
+    }
+    return len;
+}
+
+/**
+ * @brief Checks all properties for one input, fails the test with a message.
+ */
+static void checkInput(const char* text, size_t len, const char* what, uint32_t iteration) {
+    char msg[96];
+    static char exported[4096];
+
+    parse(p, c, text, len);
+    const char* bad = invalidState(p, c);
+    snprintf(msg, sizeof(msg), "%s #%lu: %s", what, (unsigned long)iteration, bad ? bad : "");
+    TEST_ASSERT_NULL_MESSAGE(bad, msg);
+
+    // Same result whatever the chunk size
+    parseChunked(q, d, text, len, 1 + rnd(CPARSER_MAX_LINE + 40));
+    snprintf(msg, sizeof(msg), "%s #%lu: chunked result differs", what, (unsigned long)iteration);
+    TEST_ASSERT_TRUE_MESSAGE(sameConfig(c, d) && sameResult(p, q), msg);
+
+    // Export and parse back: no problems, same configuration
+    size_t n = exportText(c, exported, sizeof(exported));
+    snprintf(msg, sizeof(msg), "%s #%lu: export", what, (unsigned long)iteration);
+    TEST_ASSERT_TRUE_MESSAGE(n > 0, msg);
+    parse(q, d, exported, n);
+    snprintf(msg, sizeof(msg), "%s #%lu: export does not parse back (%u problems)",
+             what, (unsigned long)iteration, (unsigned)q.problems);
+    TEST_ASSERT_TRUE_MESSAGE(q.problems == 0 && sameConfig(c, d), msg);
+}
+
+/**
+ * @brief Parses "key=value" and returns the single diagnostic code, -1 if accepted.
+ */
+static int diagOf(const char* line) {
+    parse(p, c, line, strlen(line));
+    if (p.problems == 0) return -1;
+    TEST_ASSERT_EQUAL_UINT16(1, p.problems);
+    return p.diags[0].code;
+}
+
+void setUp() {
+    rngState = 12345;
+}
+
+void tearDown() {}
+
+// ---------------- Property tests ----------------
+
+static void test_corpus_properties() {
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        checkInput(CORPUS[i], strlen(CORPUS[i]), "seed", i);
+    }
+}
+
+/**
+ * Every prefix of every seed, i.e. the file cut at any byte (upload
+ * aborted, SD card removed while writing). Lines completed before the cut
+ * keep their values; only the key of the cut line may differ.
+ */
+static void test_truncated_anywhere() {
+    for (size_t s = 0; s < CORPUS_SIZE; s++) {
+        const char* text = CORPUS[s];
+        size_t len = strlen(text);
+        for (size_t cut = 0; cut <= len; cut++) {
+            checkInput(text, cut, "prefix", s * 10000 + cut);
+
+            size_t complete = cut;
+            while (complete > 0 && text[complete - 1] != '\n') complete--;
+            parse(p, c, text, cut);
+            parse(q, d, text, complete);
+
+            // Key of the cut line
+            char key[CPARSER_MAX_LINE + 1];
+            size_t keyLen = 0;
+            for (size_t i = complete; i < cut && text[i] != '=' && keyLen < CPARSER_MAX_LINE; i++) {
+                if (text[i] != ' ' && text[i] != '\t') key[keyLen++] = text[i];
+            }
+            key[keyLen] = '\0';
+            int cutKey = cparser_findKey(key);
+
+            char va[CPARSER_MAX_LINE + 1], vb[CPARSER_MAX_LINE + 1];
+            for (uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) {
+                if (k == cutKey) continue;
+                cparser_formatValue(CONFIG_KEYS[k], c, va, sizeof(va));
+                cparser_formatValue(CONFIG_KEYS[k], d, vb, sizeof(vb));
+                TEST_ASSERT_EQUAL_STRING_MESSAGE(vb, va, CONFIG_KEYS[k].name);
+            }
+            if (cutKey < 0 || CONFIG_KEYS[cutKey].type != CKEY_WIFI) {
+                TEST_ASSERT_EQUAL_UINT8(d.wifiCount, c.wifiCount);
+            }
+            TEST_ASSERT_TRUE(p.problems >= q.problems);
+        }
+    }
+}
+
+static void test_truncated_lines() {
+    parse(p, c, "dew1_level=7", 12);                    // no final newline
+    TEST_ASSERT_EQUAL_UINT16(0, p.problems);
+    TEST_ASSERT_EQUAL_UINT8(7, c.dew1Level);
+
+    TEST_ASSERT_EQUAL_INT(CDIAG_SYNTAX, diagOf("dew1_le"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_SYNTAX, diagOf("dew1_level"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("dew1_level="));
+    TEST_ASSERT_EQUAL_INT(CDIAG_UNKNOWN_KEY, diagOf("dew1_le=7"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("wifi=MeinWLAN"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("autoclose_time=05:"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("low_voltage=11."));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("dew_mode=mp"));
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, diagOf("autoclose_cover=tr"));
+}
+
+static void test_overlong_lines() {
+    static char text[3 * CPARSER_MAX_LINE];
+
+    // CPARSER_MAX_LINE characters fit, one more does not
+    memset(text, ' ', CPARSER_MAX_LINE);
+    memcpy(text, "dew2_level=5", 12);
+    strcpy(text + CPARSER_MAX_LINE, "\ndew1_level=6\n");
+    parse(p, c, text, strlen(text));
+    TEST_ASSERT_EQUAL_UINT16(0, p.problems);
+    TEST_ASSERT_EQUAL_UINT8(5, c.dew2Level);
+
+    memset(text, ' ', CPARSER_MAX_LINE + 1);
+    memcpy(text, "dew2_level=5", 12);
+    strcpy(text + CPARSER_MAX_LINE + 1, "\ndew1_level=6\n");
+    parse(p, c, text, strlen(text));
+    TEST_ASSERT_EQUAL_UINT16(1, p.problems);
+    TEST_ASSERT_EQUAL(CDIAG_TOO_LONG, p.diags[0].code);
+    TEST_ASSERT_EQUAL_UINT16(1, p.diags[0].line);
+    TEST_ASSERT_EQUAL_UINT8(70, c.dew2Level);           // not applied, not even the start of it
+    TEST_ASSERT_EQUAL_UINT8(6, c.dew1Level);            // next line parsed normally
+
+    // Overlong last line without newline, and three times the buffer
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    parse(p, c, text, strlen(text));
+    TEST_ASSERT_EQUAL_UINT16(1, p.problems);
+    TEST_ASSERT_EQUAL(CDIAG_TOO_LONG, p.diags[0].code);
+}
+
+static void test_overlong_values() {
+    char line[128];
+
+    // ota_password: 32 characters fit
+    snprintf(line, sizeof(line), "ota_password=%s", "01234567890123456789012345678901");
+    TEST_ASSERT_EQUAL_INT(-1, diagOf(line));
+    snprintf(line, sizeof(line), "ota_password=%s", "012345678901234567890123456789012");
+    TEST_ASSERT_EQUAL_INT(CDIAG_RANGE, diagOf(line));
+    TEST_ASSERT_EQUAL_STRING("update123", c.otaPassword);
+
+    // Earlier value is kept when a later one is too long
+    const char* text = "ota_password=first\nota_password=012345678901234567890123456789012\n";
+    parse(p, c, text, strlen(text));
+    TEST_ASSERT_EQUAL_STRING("first", c.otaPassword);
+
+    // SSID 32, password 64
+    snprintf(line, sizeof(line), "wifi=%s;%s", "0123456789012345678901234567890x",
+             "0123456789012345678901234567890123456789012345678901234567890xyz");
+    TEST_ASSERT_EQUAL_INT(-1, diagOf(line));
+    snprintf(line, sizeof(line), "wifi=%s;p", "0123456789012345678901234567890xy");
+    TEST_ASSERT_EQUAL_INT(CDIAG_RANGE, diagOf(line));
+    TEST_ASSERT_EQUAL_UINT8(0, c.wifiCount);
+    snprintf(line, sizeof(line), "wifi=s;%s", "0123456789012345678901234567890123456789012345678901234567890wxyz");
+    TEST_ASSERT_EQUAL_INT(CDIAG_RANGE, diagOf(line));
+    TEST_ASSERT_EQUAL_UINT8(0, c.wifiCount);
+
+    // Eleventh network
+    parse(p, c, CORPUS[7], strlen(CORPUS[7]));
+    TEST_ASSERT_EQUAL_UINT16(1, p.problems);
+    TEST_ASSERT_EQUAL(CDIAG_LIST_FULL, p.diags[0].code);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LIST_SIZE, c.wifiCount);
+    TEST_ASSERT_EQUAL_STRING("n9", c.wifi[WIFI_LIST_SIZE - 1].ssid);
+}
+
+/**
+ * Every rejected number leaves the default in place, and cparser_set()
+ * (web UI) rejects it the same way as the file.
+ */
+static void test_bad_numbers() {
+    static const struct {
+        const char* key;
+        const char* value;
+        int code;
+    } CASES[] = {
+        { "led_brightness",    "",          CDIAG_INVALID },
+        { "led_brightness",    "abc",       CDIAG_INVALID },
+        { "led_brightness",    "-1",        CDIAG_INVALID },
+        { "led_brightness",    "+5",        CDIAG_INVALID },
+        { "led_brightness",    "0x10",      CDIAG_INVALID },
+        { "led_brightness",    "1e2",       CDIAG_INVALID },
+        { "led_brightness",    "12 3",      CDIAG_INVALID },
+        { "led_brightness",    "12.0",      CDIAG_INVALID },
+        { "led_brightness",    "256",       CDIAG_RANGE },
+        { "led_brightness",    "99999",     CDIAG_RANGE },
+        { "led_brightness",    "100000",    CDIAG_INVALID },
+        { "led_brightness",    "4294967296", CDIAG_INVALID },
+        { "dew1_level",        "101",       CDIAG_RANGE },
+        { "dew_target_offset", "0",         CDIAG_RANGE },
+        { "dew_target_offset", "11",        CDIAG_RANGE },
+        { "low_voltage",       "25.6",      CDIAG_RANGE },
+        { "low_voltage",       "11.55",     CDIAG_INVALID },
+        { "low_voltage",       ".5",        CDIAG_INVALID },
+        { "low_voltage",       "11.5.",     CDIAG_INVALID },
+        { "low_voltage",       "11,x",      CDIAG_INVALID },
+        { "low_voltage",       "-11.5",     CDIAG_INVALID },
+        { "autoclose_time",    "24:00",     CDIAG_RANGE },
+        { "autoclose_time",    "12:60",     CDIAG_RANGE },
+        { "autoclose_time",    "1200",      CDIAG_INVALID },
+        { "autoclose_time",    ":30",       CDIAG_INVALID },
+        { "autoclose_time",    "12:30:00",  CDIAG_INVALID },
+        { "autoclose_cover",   "2",         CDIAG_INVALID },
+        { "dew_mode",          "1",         CDIAG_INVALID },
+    };
+
+    ConfigData defaults;
+    config_setDefaults(defaults);
+    char line[64];
+
+    for (const auto &t : CASES) {
+        snprintf(line, sizeof(line), "%s=%s\n", t.key, t.value);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(t.code, diagOf(line), line);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(t.key, p.diags[0].key, line);
+        TEST_ASSERT_TRUE_MESSAGE(sameConfig(defaults, c), line);
+
+        ConfigDiagCode problem;
+        ConfigData web = defaults;
+        TEST_ASSERT_FALSE_MESSAGE(cparser_set(web, t.key, t.value, problem), line);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(t.code, problem, line);
+        TEST_ASSERT_TRUE_MESSAGE(sameConfig(defaults, web), line);
+    }
+}
+
+static void test_duplicate_keys() {
+    parse(p, c, CORPUS[4], strlen(CORPUS[4]));
+    TEST_ASSERT_EQUAL_UINT8(30, c.dew1Level);           // last value wins
+    TEST_ASSERT_EQUAL(CDIAG_DUPLICATE, p.diags[0].code);
+    TEST_ASSERT_EQUAL_UINT16(2, p.diags[0].line);
+    TEST_ASSERT_EQUAL(CDIAG_DUPLICATE, p.diags[1].code);
+    TEST_ASSERT_EQUAL_UINT16(3, p.diags[1].line);
+    TEST_ASSERT_EQUAL_STRING("DEW1_LEVEL", p.diags[1].key);
+
+    // An invalid repetition is reported twice and keeps the earlier value
+    const char* text = "dew1_level=10\ndew1_level=abc\n";
+    parse(p, c, text, strlen(text));
+    TEST_ASSERT_EQUAL_UINT16(2, p.problems);
+    TEST_ASSERT_EQUAL(CDIAG_DUPLICATE, p.diags[0].code);
+    TEST_ASSERT_EQUAL(CDIAG_INVALID, p.diags[1].code);
+    TEST_ASSERT_EQUAL_UINT8(10, c.dew1Level);
+
+    // Every key twice: all problems counted, CPARSER_MAX_DIAGS kept
+    static char twice[4096];
+    size_t len = 0;
+    for (int round = 0; round < 2; round++) {
+        for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+            char value[CPARSER_MAX_LINE + 1];
+            cparser_formatValue(CONFIG_KEYS[i], c, value, sizeof(value));
+            if (CONFIG_KEYS[i].type == CKEY_WIFI) strcpy(value, "net;pass");
+            len += snprintf(twice + len, sizeof(twice) - len, "%s=%s\n", CONFIG_KEYS[i].name, value);
+        }
+    }
+    parse(p, c, twice, len);
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_KEY_COUNT - 1, p.problems);     // wifi lines append
+    TEST_ASSERT_EQUAL_UINT8(CPARSER_MAX_DIAGS, p.diagCount);
+    TEST_ASSERT_EQUAL_UINT8(2, c.wifiCount);
+}
+
+// ---------------- Fuzzing ----------------
+
+/**
+ * @brief Bytes the mutator prefers: separators, digits, line ends
+ */
+static const char INTERESTING[] = "=;:,.#|\n\r\t -+0123456789aAzZ\xff";
+
+/**
+ * @brief Applies 1..8 random edits to buf (len bytes), returns the new length.
+ */
+static size_t mutate(char* buf, size_t len, size_t size) {
+    uint32_t edits = 1 + rnd(8);
+    for (uint32_t e = 0; e < edits; e++) {
+        size_t pos = len ? rnd(len + 1) : 0;
+        switch (rnd(7)) {
+        case 0:     // replace a byte
+            if (pos < len) buf[pos] = (char)rnd(256);
+            break;
+        case 1:     // insert an interesting byte
+            if (len < size) {
+                memmove(buf + pos + 1, buf + pos, len - pos);
+                buf[pos] = INTERESTING[rnd(sizeof(INTERESTING) - 1)];
+                len++;
+            }
+            break;
+        case 2: {   // delete a range
+            size_t n = 1 + rnd(16);
+            if (pos + n > len) n = len - pos;
+            memmove(buf + pos, buf + pos + n, len - pos - n);
+            len -= n;
+            break;
+        }
+        case 3: {   // repeat a range (long lines, long values, duplicate keys)
+            size_t n = 1 + rnd(64);
+            if (pos + n > len) n = len - pos;
+            uint32_t times = 1 + rnd(4);
+            for (uint32_t t = 0; t < times && len + n <= size; t++) {
+                memmove(buf + pos + n, buf + pos, len - pos);
+                len += n;
+            }
+            break;
+        }
+        case 4: {   // splice in a line of another seed
+            const char* seed = CORPUS[rnd(CORPUS_SIZE)];
+            size_t seedLen = strlen(seed);
+            if (seedLen == 0) break;
+            const char* from = seed + rnd(seedLen);
+            const char* to = strchr(from, '\n');
+            size_t n = to ? (size_t)(to - from + 1) : strlen(from);
+            if (len + n > size) break;
+            memmove(buf + pos + n, buf + pos, len - pos);
+            memcpy(buf + pos, from, n);
+            len += n;
+            break;
+        }
+        case 5:     // cut the file
+            len = pos;
+            break;
+        case 6:     // replace a digit by a random number
+            if (pos < len && buf[pos] >= '0' && buf[pos] <= '9') {
+                char num[12];
+                int n = snprintf(num, sizeof(num), "%lu", (unsigned long)(rnd(3) ? rnd(300) : rngState));
+                if (len + n > size) break;
+                memmove(buf + pos + n, buf + pos + 1, len - pos - 1);
+                memcpy(buf + pos, num, n);
+                len += n - 1;
+            }
+            break;
+        }
+    }
+    return len;
+}
+
+static void test_mutated_corpus() {
+    static char buf[2048];
+    const uint32_t runs = 30000;
+    uint32_t codes[CDIAG_LIST_FULL + 1] = {};
+    uint32_t clean = 0;
+
+    for (uint32_t i = 0; i < runs; i++) {
+        const char* seed = CORPUS[i % CORPUS_SIZE];
+        size_t len = strlen(seed);
+        memcpy(buf, seed, len);
+        len = mutate(buf, len, sizeof(buf));
+
+        checkInput(buf, len, "mutation", i);
+        parse(p, c, buf, len);
+        if (p.problems == 0) clean++;
+        for (uint8_t k = 0; k < p.diagCount; k++) codes[p.diags[k].code]++;
+    }
+
+    char msg[192];
+    snprintf(msg, sizeof(msg), "%lu inputs, %lu clean; diags syntax %lu long %lu key %lu invalid %lu range %lu dup %lu full %lu",
+             (unsigned long)runs, (unsigned long)clean, (unsigned long)codes[0], (unsigned long)codes[1],
+             (unsigned long)codes[2], (unsigned long)codes[3], (unsigned long)codes[4], (unsigned long)codes[5],
+             (unsigned long)codes[6]);
+    TEST_MESSAGE(msg);
+
+    // The mutator reaches every diagnostic
+    for (uint8_t k = 0; k <= CDIAG_LIST_FULL; k++) TEST_ASSERT_TRUE(codes[k] > 0);
+}
+
+static void test_random_bytes() {
+    static char buf[1024];
+    for (uint32_t i = 0; i < 5000; i++) {
+        size_t len = rnd(sizeof(buf));
+        for (size_t j = 0; j < len; j++) buf[j] = (char)rnd(256);
+        checkInput(buf, len, "random", i);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_corpus_properties);
+    RUN_TEST(test_truncated_anywhere);
+    RUN_TEST(test_truncated_lines);
+    RUN_TEST(test_overlong_lines);
+    RUN_TEST(test_overlong_values);
+    RUN_TEST(test_bad_numbers);
+    RUN_TEST(test_duplicate_keys);
+    RUN_TEST(test_mutated_corpus);
+    RUN_TEST(test_random_bytes);
+    return UNITY_END();
+}
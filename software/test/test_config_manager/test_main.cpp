@@ -0,0 +1,135 @@
+/**
+ * @file test_main.cpp
+ * @brief Configuration store: boot from NVS, config.txt import and export
+ *
+ * The SD card is a fresh temporary directory, NVS is the in-memory
+ * Preferences of the host build. The tests build on each other in the
+ * order of main(); every config_begin() stands for one boot.
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "hal_native.h"
+#include <SD.h>
+#include <Preferences.h>
+#include "sdcard.h"
+#include "config_manager.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void writeConfigFile(const char* text) {
+    File f = SD.open(CONFIG_FILE_PATH, FILE_WRITE);
+    TEST_ASSERT_TRUE(f);
+    f.print(text);
+    f.close();
+}
+
+/**
+ * @brief Returns the stored blob; flip = true changes one byte of it.
+ */
+static size_t nvsBlob(bool flip) {
+    Preferences prefs;
+    prefs.begin("config", false);
+    std::vector<uint8_t> blob(prefs.getBytesLength("data"));
+    size_t len = prefs.getBytes("data", blob.data(), blob.size());
+    if (flip && len > 0) {
+        blob[len / 2] ^= 0x01;
+        prefs.putBytes("data", blob.data(), len);
+    }
+    prefs.end();
+    return len;
+}
+
+static void setDew1Level(uint8_t level) {
+    ConfigData c = config_get();
+    c.dew1Level = level;
+    TEST_ASSERT_TRUE(config_update(c));
+}
+
+static void test_defaults_without_sd_and_nvs() {
+    TEST_ASSERT_FALSE(config_begin(false));
+
+    ConfigData d;
+    config_setDefaults(d);
+    TEST_ASSERT_EQUAL(d.dew1Level, config_get().dew1Level);
+    TEST_ASSERT_EQUAL(d.dewMode, config_get().dewMode);
+}
+
+static void test_import_from_sd() {
+    writeConfigFile("dew1_level=33\ndew_mode=mpc\n");
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(33, config_get().dew1Level);
+    TEST_ASSERT_EQUAL(1, config_get().dewMode);
+    TEST_ASSERT_TRUE(nvsBlob(false) > 0);
+}
+
+static void test_boot_from_nvs_without_reimport() {
+    // Changed at run time, config.txt still says 33
+    setDew1Level(44);
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(44, config_get().dew1Level);
+    TEST_ASSERT_EQUAL(1, config_get().dewMode);
+}
+
+static void test_changed_file_reimported() {
+    writeConfigFile("dew1_level=55\n# edited on the PC\n");
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(55, config_get().dew1Level);
+    TEST_ASSERT_EQUAL(0, config_get().dewMode);         // default again
+}
+
+static void test_corrupt_nvs_falls_back_to_file() {
+    setDew1Level(66);
+    nvsBlob(true);
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(55, config_get().dew1Level);
+}
+
+static void test_corrupt_nvs_without_sd_keeps_running() {
+    setDew1Level(66);
+    nvsBlob(true);
+    TEST_ASSERT_FALSE(config_begin(false));
+    TEST_ASSERT_EQUAL(66, config_get().dew1Level);      // running config untouched
+}
+
+static void test_missing_file_exported() {
+    setDew1Level(77);
+    SD.remove(CONFIG_FILE_PATH);
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(77, config_get().dew1Level);
+    TEST_ASSERT_TRUE(SD.exists(CONFIG_FILE_PATH));
+
+    // The export is a complete config.txt: with NVS lost it brings back 77
+    setDew1Level(10);
+    Preferences prefs;
+    prefs.begin("config", false);
+    prefs.remove("data");
+    prefs.end();
+    TEST_ASSERT_TRUE(config_begin(true));
+    TEST_ASSERT_EQUAL(77, config_get().dew1Level);
+}
+
+int main(int argc, char** argv) {
+    char root[] = "/tmp/test_config_manager_XXXXXX";
+    if (mkdtemp(root) == nullptr) return 1;
+    hal_setSdRoot(root);
+
+    log_begin();
+    initSD();
+    task_start();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_without_sd_and_nvs);
+    RUN_TEST(test_import_from_sd);
+    RUN_TEST(test_boot_from_nvs_without_reimport);
+    RUN_TEST(test_changed_file_reimported);
+    RUN_TEST(test_corrupt_nvs_falls_back_to_file);
+    RUN_TEST(test_corrupt_nvs_without_sd_keeps_running);
+    RUN_TEST(test_missing_file_exported);
+    return UNITY_END();
+}
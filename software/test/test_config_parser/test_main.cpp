@@ -0,0 +1,149 @@
+/**
+ * @file test_main.cpp
+ * @brief config.txt parser: values, diagnostics, chunking and export round trip
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "config_parser.h"
+
+static const char SAMPLE[] =
+    "# WLAN (max 10)\r\n"
+    "wifi=MeinWLAN;passwort\n"
+    "wifi=Hotspot;12345678\n"
+    "ota_password=update123\n"
+    "LED_Brightness = 80\n"
+    "led_brightness_dark=15\n"
+    "AutoClose_Cover=1\n"
+    "AutoClose_Time=05:00\n"
+    "dew1_level=70\n"
+    "dew_mode=MPC\n"
+    "lens2_probe=ntc\n"
+    "low_voltage=11,8\n"
+    "critical_voltage=10\n";
+
+static ConfigParser p;
+static ConfigData c;
+
+static void parse(const char* text) {
+    cparser_begin(p, c);
+    cparser_feed(p, text, strlen(text));
+    cparser_end(p);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_sample_values() {
+    parse(SAMPLE);
+    TEST_ASSERT_EQUAL_UINT16(0, p.problems);
+    TEST_ASSERT_EQUAL_UINT8(2, c.wifiCount);
+    TEST_ASSERT_EQUAL_STRING("Hotspot", c.wifi[1].ssid);
+    TEST_ASSERT_EQUAL_STRING("12345678", c.wifi[1].password);
+    TEST_ASSERT_EQUAL_STRING("update123", c.otaPassword);
+    TEST_ASSERT_EQUAL_UINT8(80, c.ledBrightnessNormal);
+    TEST_ASSERT_TRUE(c.autoCloseCover);
+    TEST_ASSERT_EQUAL_UINT8(5, c.autoCloseHour);
+    TEST_ASSERT_EQUAL_UINT8(0, c.autoCloseMinute);
+    TEST_ASSERT_EQUAL_UINT8(70, c.dew1Level);
+    TEST_ASSERT_EQUAL_UINT8(1, c.dewMode);
+    TEST_ASSERT_EQUAL_UINT8(2, c.lens2Probe);
+    TEST_ASSERT_EQUAL_UINT8(118, c.lowVoltage);
+    TEST_ASSERT_EQUAL_UINT8(100, c.criticalVoltage);
+}
+
+static void test_missing_keys_keep_defaults() {
+    ConfigData defaults;
+    config_setDefaults(defaults);
+    parse("");
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &c, sizeof(c));
+}
+
+static void test_chunk_size_does_not_matter() {
+    ConfigData whole;
+    parse(SAMPLE);
+    whole = c;
+
+    for (size_t chunk = 1; chunk <= 17; chunk++) {
+        cparser_begin(p, c);
+        for (size_t i = 0; i < sizeof(SAMPLE) - 1; i += chunk) {
+            size_t n = sizeof(SAMPLE) - 1 - i < chunk ? sizeof(SAMPLE) - 1 - i : chunk;
+            cparser_feed(p, SAMPLE + i, n);
+        }
+        cparser_end(p);
+        TEST_ASSERT_EQUAL_MEMORY(&whole, &c, sizeof(c));
+    }
+}
+
+static void test_diagnostics_with_line_numbers() {
+    parse("dew1_level=70\n"
+          "no equals sign\n"
+          "colour=red\n"
+          "dew2_level=101\n"
+          "dew_mode=auto\n"
+          "dew1_level=60\n");
+    TEST_ASSERT_EQUAL_UINT16(5, p.problems);
+    TEST_ASSERT_EQUAL_UINT8(5, p.diagCount);
+    TEST_ASSERT_EQUAL_UINT16(2, p.diags[0].line);
+    TEST_ASSERT_EQUAL_INT(CDIAG_SYNTAX, p.diags[0].code);
+    TEST_ASSERT_EQUAL_INT(CDIAG_UNKNOWN_KEY, p.diags[1].code);
+    TEST_ASSERT_EQUAL_STRING("colour", p.diags[1].key);
+    TEST_ASSERT_EQUAL_INT(CDIAG_RANGE, p.diags[2].code);
+    TEST_ASSERT_EQUAL_INT(CDIAG_INVALID, p.diags[3].code);
+    TEST_ASSERT_EQUAL_INT(CDIAG_DUPLICATE, p.diags[4].code);
+    TEST_ASSERT_EQUAL_UINT16(6, p.diags[4].line);
+    TEST_ASSERT_EQUAL_UINT8(60, c.dew1Level);       // last value wins
+}
+
+static void test_export_round_trip() {
+    parse(SAMPLE);
+    ConfigData original = c;
+
+    // Write every key the way config_exportToSD() does and parse it again
+    char text[2048] = "";
+    char value[CPARSER_MAX_LINE];
+    for (uint8_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const ConfigKey &k = CONFIG_KEYS[i];
+        if (k.type == CKEY_WIFI) {
+            for (uint8_t w = 0; w < original.wifiCount; w++) {
+                snprintf(text + strlen(text), sizeof(text) - strlen(text), "%s=%s;%s\n",
+                         k.name, original.wifi[w].ssid, original.wifi[w].password);
+            }
+            continue;
+        }
+        cparser_formatValue(k, original, value, sizeof(value));
+        snprintf(text + strlen(text), sizeof(text) - strlen(text), "%s=%s\n", k.name, value);
+    }
+
+    parse(text);
+    TEST_ASSERT_EQUAL_UINT16(0, p.problems);
+    TEST_ASSERT_EQUAL_MEMORY(&original, &c, sizeof(c));
+}
+
+static void test_set_and_clear_list() {
+    ConfigDiagCode problem;
+    config_setDefaults(c);
+    TEST_ASSERT_TRUE(cparser_set(c, "Dew_Slew_Rate", "35", problem));
+    TEST_ASSERT_EQUAL_UINT8(35, c.dewSlewRate);
+    TEST_ASSERT_FALSE(cparser_set(c, "dew_target_offset", "0", problem));
+    TEST_ASSERT_EQUAL_INT(CDIAG_RANGE, problem);
+    TEST_ASSERT_FALSE(cparser_set(c, "nope", "1", problem));
+    TEST_ASSERT_EQUAL_INT(CDIAG_UNKNOWN_KEY, problem);
+
+    TEST_ASSERT_TRUE(cparser_set(c, "wifi", "net;secret", problem));
+    TEST_ASSERT_EQUAL_UINT8(1, c.wifiCount);
+    TEST_ASSERT_TRUE(cparser_clearList(c, "wifi", problem));
+    TEST_ASSERT_EQUAL_UINT8(0, c.wifiCount);
+    TEST_ASSERT_FALSE(cparser_clearList(c, "dew1_level", problem));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_values);
+    RUN_TEST(test_missing_keys_keep_defaults);
+    RUN_TEST(test_chunk_size_does_not_matter);
+    RUN_TEST(test_diagnostics_with_line_numbers);
+    RUN_TEST(test_export_round_trip);
+    RUN_TEST(test_set_and_clear_list);
+    return UNITY_END();
+}
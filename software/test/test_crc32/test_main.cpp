@@ -0,0 +1,53 @@
+/**
+ * @file test_main.cpp
+ * @brief CRC-32 against the zlib reference values
+ */
+
+#include <unity.h>
+#include "crc32.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_check_value() {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32("123456789", 9));
+}
+
+static void test_empty_is_zero() {
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, crc32("", 0));
+}
+
+static void test_known_strings() {
+    TEST_ASSERT_EQUAL_HEX32(0xE8B7BE43, crc32("a", 1));
+    TEST_ASSERT_EQUAL_HEX32(0x414FA339, crc32("The quick brown fox jumps over the lazy dog", 43));
+}
+
+static void test_blocks_continue() {
+    const char* text = "The quick brown fox jumps over the lazy dog";
+    for (size_t split = 0; split <= 43; split++) {
+        uint32_t crc = crc32(text, split);
+        crc = crc32(text + split, 43 - split, crc);
+        TEST_ASSERT_EQUAL_HEX32(0x414FA339, crc);
+    }
+}
+
+static void test_single_bit_flip_detected() {
+    uint8_t data[64];
+    for (uint8_t i = 0; i < sizeof(data); i++) data[i] = i * 7;
+    uint32_t ref = crc32(data, sizeof(data));
+    for (uint16_t bit = 0; bit < sizeof(data) * 8; bit++) {
+        data[bit / 8] ^= 1 << (bit % 8);
+        TEST_ASSERT_NOT_EQUAL(ref, crc32(data, sizeof(data)));
+        data[bit / 8] ^= 1 << (bit % 8);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_check_value);
+    RUN_TEST(test_empty_is_zero);
+    RUN_TEST(test_known_strings);
+    RUN_TEST(test_blocks_continue);
+    RUN_TEST(test_single_bit_flip_detected);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_main.cpp
+ * @brief Dew heater control: ramp, MPC and lens probe PID
+ *
+ * Runs dew_controller against the fake BME280 and DS18B20. The tests
+ * build on each other in the order of main(); every test sets the mode
+ * and probes it needs.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "hal_native.h"
+#include "pins.h"
+#include "analog_input.h"
+#include "power_control.h"
+#include "bme280_manager.h"
+#include "dew_controller.h"
+#include "dew_model.h"
+#include "lens_probe.h"
+#include "config_manager.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+#define AMBIENT_C 10.0f
+
+// Long enough for a BME reading and a dew update after it
+#define SETTLE_MS (BME_READ_INTERVAL_MS + DEW_UPDATE_INTERVAL)
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Sets the BME280 to AMBIENT_C and the humidity of a dew point spread.
+ */
+static void setSpread(float spread) {
+    const float a = 17.62f;
+    const float c = 243.12f;
+    float td = AMBIENT_C - spread;
+    float h = 100.0f * expf(a * td / (c + td) - a * AMBIENT_C / (c + AMBIENT_C));
+    hal_bmeSet(AMBIENT_C, h, 1000.0f);
+}
+
+static void configure(uint8_t mode, uint8_t probe1, uint8_t probe2) {
+    ConfigData c = config_get();
+    c.dew1Level = 80;
+    c.dew2Level = 40;
+    c.dewMode = mode;
+    c.lens1Probe = probe1;
+    c.lens2Probe = probe2;
+    config_update(c);
+}
+
+static void test_ramp() {
+    configure(DEW_MODE_RAMP, LENS_PROBE_NONE, LENS_PROBE_NONE);
+
+    setSpread(6.0f);
+    hal_runTasks(SETTLE_MS);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, AMBIENT_C - 6.0f, s.dewPoint);
+    TEST_ASSERT_EQUAL(0, s.dew1Power);
+    TEST_ASSERT_EQUAL(0, s.dew2Power);
+    TEST_ASSERT_FALSE(s.active);
+
+    // Half way between DEW_START_DELTA and full power
+    setSpread(3.0f);
+    hal_runTasks(SETTLE_MS);
+    s = dew_getStatus();
+    TEST_ASSERT_INT_WITHIN(1, 40, s.dew1Power);
+    TEST_ASSERT_INT_WITHIN(1, 20, s.dew2Power);
+    TEST_ASSERT_TRUE(s.active);
+
+    // Capped by dew1_level / dew2_level
+    setSpread(1.0f);
+    hal_runTasks(SETTLE_MS);
+    s = dew_getStatus();
+    TEST_ASSERT_EQUAL(80, s.dew1Power);
+    TEST_ASSERT_EQUAL(40, s.dew2Power);
+    TEST_ASSERT_EQUAL(POWER_DUTY_FULL * 80 / 100, power_getTargetDuty(POWER_DEW1));
+}
+
+static void test_level_applies_immediately() {
+    ConfigData c = config_get();
+    c.dew1Level = 50;
+    config_update(c);
+
+    hal_runTasks(100);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_EQUAL(50, s.dew1Max);
+    TEST_ASSERT_EQUAL(50, s.dew1Power);
+}
+
+static void test_invalid_reading_switches_off() {
+    hal_bmeSet(AMBIENT_C, 0.0f, 1000.0f);
+    hal_runTasks(SETTLE_MS);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_FALSE(s.active);
+    TEST_ASSERT_EQUAL(0, power_getTargetDuty(POWER_DEW1));
+    TEST_ASSERT_EQUAL(0, power_getTargetDuty(POWER_DEW2));
+}
+
+static void test_mpc() {
+    configure(DEW_MODE_MPC, LENS_PROBE_NONE, LENS_PROBE_NONE);
+
+    // Far from the dew point and steady: no heating needed
+    setSpread(10.0f);
+    hal_runTasks(DEW_TREND_SAMPLES * DEW_UPDATE_INTERVAL);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_EQUAL(DEW_MODE_MPC, s.mode);
+    TEST_ASSERT_EQUAL(0, s.dew1Power);
+    TEST_ASSERT_EQUAL(0, s.dew2Power);
+
+    // Steady inside DEW_MPC_MARGIN: some power, never above the cap
+    setSpread(0.5f);
+    hal_runTasks(DEW_TREND_SAMPLES * DEW_UPDATE_INTERVAL);
+    s = dew_getStatus();
+    TEST_ASSERT_TRUE(s.dew1Power > 0);
+    TEST_ASSERT_TRUE(s.dew1Power <= 80);
+    TEST_ASSERT_TRUE(s.dew2Power > 0);
+    TEST_ASSERT_TRUE(s.dew2Power <= 40);
+}
+
+static void test_probe_pid() {
+    configure(DEW_MODE_RAMP, LENS_PROBE_DS18B20, LENS_PROBE_NONE);
+
+    // Ramp alone would not heat, the lens sits on the dew point
+    setSpread(10.0f);
+    hal_ds18b20Set(0, AMBIENT_C - 10.0f);
+    hal_runTasks(2 * LENS_PROBE_INTERVAL_MS + SETTLE_MS);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, AMBIENT_C - 10.0f, s.lens1Temp);
+    TEST_ASSERT_TRUE(isnan(s.lens2Temp));
+    TEST_ASSERT_TRUE(s.dew1Power > 0);
+    TEST_ASSERT_TRUE(s.dew1Power <= 80);
+    TEST_ASSERT_EQUAL(0, s.dew2Power);
+
+    // Lens well above the target: PID backs off
+    hal_ds18b20Set(0, AMBIENT_C);
+    hal_runTasks(20 * DEW_UPDATE_INTERVAL);
+    TEST_ASSERT_EQUAL(0, dew_getStatus().dew1Power);
+}
+
+static void test_probe_lost_falls_back_to_ramp() {
+    setSpread(3.0f);
+    hal_ds18b20Set(0, AMBIENT_C + 5.0f);
+    hal_runTasks(SETTLE_MS);
+    TEST_ASSERT_EQUAL(0, dew_getStatus().dew1Power);    // PID, lens warm
+
+    hal_ds18b20Set(0, NAN);
+    hal_runTasks(2 * LENS_PROBE_INTERVAL_MS + SETTLE_MS);
+    DewStatus s = dew_getStatus();
+    TEST_ASSERT_TRUE(isnan(s.lens1Temp));
+    TEST_ASSERT_INT_WITHIN(1, 40, s.dew1Power);          // ramp
+}
+
+static void test_one_probe_missing() {
+    configure(DEW_MODE_RAMP, LENS_PROBE_DS18B20, LENS_PROBE_DS18B20);
+
+    // Only one probe on the bus: heater 1 keeps its PID across the rescans
+    setSpread(3.0f);
+    hal_ds18b20Set(0, AMBIENT_C + 5.0f);
+    hal_runTasks(LENS_PROBE_RESCAN_MS + SETTLE_MS);
+    for (int i = 0; i < 3 * LENS_PROBE_RESCAN_MS / DEW_UPDATE_INTERVAL; i++) {
+        hal_runTasks(DEW_UPDATE_INTERVAL);
+        DewStatus s = dew_getStatus();
+        TEST_ASSERT_FLOAT_WITHIN(0.1f, AMBIENT_C + 5.0f, s.lens1Temp);
+        TEST_ASSERT_TRUE(isnan(s.lens2Temp));
+        TEST_ASSERT_EQUAL(0, s.dew1Power);                // PID, lens warm
+        TEST_ASSERT_INT_WITHIN(1, 20, s.dew2Power);       // ramp
+    }
+}
+
+int main(int argc, char** argv) {
+    log_begin();
+    initPins();
+    analog_init();
+    power_init();
+    hal_bmeSetPresent(true);
+    setSpread(10.0f);
+    bme_init();
+    dew_init();
+    task_start();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ramp);
+    RUN_TEST(test_level_applies_immediately);
+    RUN_TEST(test_invalid_reading_switches_off);
+    RUN_TEST(test_mpc);
+    RUN_TEST(test_probe_pid);
+    RUN_TEST(test_probe_lost_falls_back_to_ramp);
+    RUN_TEST(test_one_probe_missing);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file test_main.cpp
+ * @brief Spread trend, thermal model, predictive duty and PID of the dew control
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "dew_model.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_trend_needs_three_samples() {
+    DewTrend t;
+    dewtrend_reset(t);
+    dewtrend_add(t, 0, 5.0f);
+    dewtrend_add(t, 30000, 4.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, dewtrend_slope(t));
+}
+
+static void test_trend_slope_of_line() {
+    DewTrend t;
+    dewtrend_reset(t);
+    // -1 °C per 10 min, more samples than the ring holds, across the millis() wrap
+    uint32_t start = 0xFFFFFFFFUL - 200000;
+    for (uint8_t i = 0; i < DEW_TREND_SAMPLES + 10; i++) {
+        dewtrend_add(t, start + i * 30000UL, 8.0f - i * 30.0f / 600.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -1.0f / 600.0f, dewtrend_slope(t));
+}
+
+static void test_model_settles_at_gain() {
+    DewModel m;
+    dewmodel_init(m);
+    for (uint16_t i = 0; i < 400; i++) dewmodel_step(m, 0.5f, 30.0f, NAN);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, DEW_MODEL_GAIN * 0.5f, m.excess);
+    TEST_ASSERT_FALSE(m.measured);
+}
+
+static void test_model_step_ignores_zero_dt() {
+    DewModel m;
+    dewmodel_init(m);
+    dewmodel_step(m, 1.0f, 0.0f, NAN);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, m.excess);
+}
+
+static void test_fit_converges_to_plant() {
+    const float tau = 500.0f, gain = 12.0f, dt = 30.0f;
+    DewModel m;
+    dewmodel_init(m);
+    float excess = 0;
+    for (uint16_t i = 0; i < 600; i++) {
+        float duty = (i / 40) % 2 ? 0.8f : 0.1f;      // square wave excites both parameters
+        float a = expf(-dt / tau);
+        dewmodel_step(m, duty, dt, excess);
+        excess = excess * a + gain * duty * (1.0f - a);
+    }
+    TEST_ASSERT_TRUE(m.measured);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * tau, tau, m.tau);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * gain, gain, m.gain);
+}
+
+static void test_min_duty_zero_with_large_spread() {
+    DewModel m;
+    dewmodel_init(m);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, dewmodel_minDuty(m, 10.0f, 0.0f, DEW_MPC_MARGIN, 1.0f));
+}
+
+static void test_min_duty_keeps_margin_at_horizon() {
+    DewModel m;
+    dewmodel_init(m);
+    float slope = -1.0f / 3600.0f;
+    float duty = dewmodel_minDuty(m, 1.0f, slope, DEW_MPC_MARGIN, 1.0f);
+    TEST_ASSERT_GREATER_THAN(0.0f, duty);
+
+    // Apply it over the horizon: the margin holds at every checked point
+    for (uint8_t j = 1; j <= DEW_MPC_POINTS; j++) {
+        float h = DEW_MPC_HORIZON_S * j / DEW_MPC_POINTS;
+        float lensOverDew = 1.0f + slope * h + m.gain * duty * (1.0f - expf(-h / m.tau));
+        TEST_ASSERT_GREATER_OR_EQUAL(DEW_MPC_MARGIN - 1e-4f, lensOverDew);
+    }
+}
+
+static void test_min_duty_limited() {
+    DewModel m;
+    dewmodel_init(m);
+    TEST_ASSERT_EQUAL_FLOAT(0.4f, dewmodel_minDuty(m, -5.0f, 0.0f, DEW_MPC_MARGIN, 0.4f));
+}
+
+static void test_pid_bumpless_start() {
+    DewPid p;
+    dewpid_start(p, 35.0f, 4.0f);
+    // At the setpoint and without movement the output stays where it was
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 35.0f, dewpid_update(p, 4.0f, 4.0f, 30.0f, 100.0f));
+}
+
+static void test_pid_output_limits_and_windup() {
+    DewPid p;
+    dewpid_start(p, 0.0f, -10.0f);
+    for (uint16_t i = 0; i < 200; i++) {
+        float out = dewpid_update(p, 5.0f, -10.0f, 30.0f, 60.0f);
+        TEST_ASSERT_LESS_OR_EQUAL(60.0f, out);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(60.0f, p.integral);
+
+    // Once above the setpoint the output drops at once, no stored windup
+    dewpid_update(p, 5.0f, 5.0f, 30.0f, 60.0f);
+    float out = dewpid_update(p, 5.0f, 7.0f, 30.0f, 60.0f);
+    TEST_ASSERT_LESS_THAN(60.0f, out);
+    TEST_ASSERT_GREATER_OR_EQUAL(0.0f, out);
+}
+
+static void test_pid_closed_loop_reaches_setpoint() {
+    const float tau = 300.0f, gain = 8.0f, dt = 30.0f, ambient = 0.0f, setpoint = 3.0f;
+    DewPid p;
+    dewpid_start(p, 0.0f, ambient);
+    float lens = ambient;
+    for (uint16_t i = 0; i < 240; i++) {      // 2 h
+        float duty = dewpid_update(p, setpoint, lens, dt, 100.0f);
+        float a = expf(-dt / tau);
+        lens = ambient + (lens - ambient) * a + gain * duty / 100.0f * (1.0f - a);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, setpoint, lens);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_trend_needs_three_samples);
+    RUN_TEST(test_trend_slope_of_line);
+    RUN_TEST(test_model_settles_at_gain);
+    RUN_TEST(test_model_step_ignores_zero_dt);
+    RUN_TEST(test_fit_converges_to_plant);
+    RUN_TEST(test_min_duty_zero_with_large_spread);
+    RUN_TEST(test_min_duty_keeps_margin_at_horizon);
+    RUN_TEST(test_min_duty_limited);
+    RUN_TEST(test_pid_bumpless_start);
+    RUN_TEST(test_pid_output_limits_and_windup);
+    RUN_TEST(test_pid_closed_loop_reaches_setpoint);
+    return UNITY_END();
+}
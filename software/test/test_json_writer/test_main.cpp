@@ -0,0 +1,96 @@
+/**
+ * @file test_main.cpp
+ * @brief JsonWriter output and JsonBuffer bounds
+ */
+
+#include <unity.h>
+#include "json_writer.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_nested_object() {
+    char buf[128];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+
+    json.beginObject();
+    json.field("a", (int32_t)-5);
+    json.beginObject("b");
+    json.field("c", (uint32_t)4000000000UL);
+    json.field("d", true);
+    json.endObject();
+    json.field("e", "x");
+    json.endObject();
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":-5,\"b\":{\"c\":4000000000,\"d\":true},\"e\":\"x\"}", out.c_str());
+    TEST_ASSERT_FALSE(out.overflow());
+}
+
+static void test_empty_object() {
+    char buf[16];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+    json.beginObject();
+    json.beginObject("o");
+    json.endObject();
+    json.endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"o\":{}}", out.c_str());
+}
+
+static void test_float_decimals_and_nan() {
+    char buf[96];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+    json.beginObject();
+    json.field("t", 12.345f, 1);
+    json.field("v", -0.06f, 2);
+    json.field("n", NAN, 1);
+    json.field("i", INFINITY, 1);
+    json.endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"t\":12.3,\"v\":-0.06,\"n\":null,\"i\":null}", out.c_str());
+}
+
+static void test_float_too_wide_is_null() {
+    char buf[96];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+    json.beginObject();
+    json.field("w", -3.0e38f, 2);       // 42 characters, buffer holds 23
+    json.field("x", 1.5f, 1);
+    json.endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"w\":null,\"x\":1.5}", out.c_str());
+}
+
+static void test_string_escaping() {
+    char buf[96];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+    json.beginObject();
+    json.field("s", "a\"b\\c\n\x01z");
+    json.endObject();
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"a\\\"b\\\\c\\u000a\\u0001z\"}", out.c_str());
+}
+
+static void test_buffer_overflow_is_flagged() {
+    char buf[8];
+    JsonBuffer out(buf, sizeof(buf));
+    JsonWriter json(out);
+    json.beginObject();
+    json.field("long", "value that does not fit");
+    json.endObject();
+    TEST_ASSERT_TRUE(out.overflow());
+    TEST_ASSERT_LESS_THAN(sizeof(buf), out.length());
+    TEST_ASSERT_EQUAL(strlen(buf), out.length());     // always terminated
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_nested_object);
+    RUN_TEST(test_empty_object);
+    RUN_TEST(test_float_decimals_and_nan);
+    RUN_TEST(test_float_too_wide_is_null);
+    RUN_TEST(test_string_escaping);
+    RUN_TEST(test_buffer_overflow_is_flagged);
+    return UNITY_END();
+}
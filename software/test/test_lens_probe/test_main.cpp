@@ -0,0 +1,79 @@
+/**
+ * @file test_main.cpp
+ * @brief DS18B20 lens probes: assignment, hot-plug and loss
+ *
+ * Both heaters are configured for a DS18B20. The tests build on each
+ * other in the order of main(): one probe on the bus, then the second is
+ * plugged in, then the first is unplugged and plugged in again.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "hal_native.h"
+#include "lens_probe.h"
+#include "config_manager.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_one_present_one_missing() {
+    hal_ds18b20Set(0, 5.0f);
+
+    ConfigData c;
+    config_setDefaults(c);
+    c.lens1Probe = LENS_PROBE_DS18B20;
+    c.lens2Probe = LENS_PROBE_DS18B20;
+    config_update(c);
+
+    // Conversion requested at the first run, read at the second
+    hal_runTasks(2 * LENS_PROBE_INTERVAL_MS + 500);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 5.0f, lensprobe_get(1));
+    TEST_ASSERT_TRUE(isnan(lensprobe_get(2)));
+
+    // The rescans for the missing probe do not interrupt the readings
+    for (uint8_t i = 0; i < 4; i++) {
+        float t = 5.0f + i;
+        hal_ds18b20Set(0, t);
+        hal_runTasks(LENS_PROBE_RESCAN_MS / 2);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f, t, lensprobe_get(1));
+        TEST_ASSERT_TRUE(isnan(lensprobe_get(2)));
+    }
+}
+
+static void test_second_probe_plugged_in() {
+    hal_ds18b20Set(1, 3.0f);
+    hal_runTasks(LENS_PROBE_RESCAN_MS + 2 * LENS_PROBE_INTERVAL_MS);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 8.0f, lensprobe_get(1));   // keeps its probe
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, lensprobe_get(2));
+}
+
+static void test_first_probe_lost_and_back() {
+    hal_ds18b20Set(0, NAN);
+    hal_runTasks(2 * LENS_PROBE_INTERVAL_MS);
+    TEST_ASSERT_TRUE(isnan(lensprobe_get(1)));                // no stale value
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, lensprobe_get(2));
+
+    // Probe 2 is not taken over by heater 1 at the rescan
+    hal_runTasks(LENS_PROBE_RESCAN_MS);
+    TEST_ASSERT_TRUE(isnan(lensprobe_get(1)));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, lensprobe_get(2));
+
+    hal_ds18b20Set(0, 6.0f);
+    hal_runTasks(LENS_PROBE_RESCAN_MS + 2 * LENS_PROBE_INTERVAL_MS);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 6.0f, lensprobe_get(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, lensprobe_get(2));
+}
+
+int main(int argc, char** argv) {
+    log_begin();
+    lensprobe_init();
+    task_start();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_one_present_one_missing);
+    RUN_TEST(test_second_probe_plugged_in);
+    RUN_TEST(test_first_probe_lost_and_back);
+    return UNITY_END();
+}
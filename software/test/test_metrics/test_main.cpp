@@ -0,0 +1,120 @@
+/**
+ * @file test_main.cpp
+ * @brief Metric registry and Prometheus text output
+ *
+ * The registry is global and only grows, the tests build on each other
+ * in the order of main().
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "metrics.h"
+#include "task_manager.h"
+#include "web_log.h"
+
+/**
+ * @brief Print into a static text buffer
+ */
+class TextBuffer : public Print {
+public:
+    size_t write(uint8_t c) override {
+        if (len + 1 >= sizeof(text)) return 0;
+        text[len++] = (char)c;
+        text[len] = '\0';
+        return 1;
+    }
+    void clear() { len = 0; text[0] = '\0'; }
+
+    char text[8192];
+    size_t len = 0;
+};
+
+static TextBuffer out;
+
+static MetricCounter requestsA, requestsB;
+static MetricGauge temperature;
+static MetricHistogram duration;
+static const uint32_t DURATION_BOUNDS[] = { 10, 100 };
+
+static float halfFn() { return 0.5f; }
+
+/**
+ * @brief Number of occurrences of s in the output
+ */
+static int count(const char* s) {
+    int n = 0;
+    for (const char* p = strstr(out.text, s); p != nullptr; p = strstr(p + 1, s)) n++;
+    return n;
+}
+
+void setUp() {
+    out.clear();
+}
+
+void tearDown() {}
+
+static void test_sample_format() {
+    TEST_ASSERT_TRUE(metrics_register("t_requests_total", "Requests", "route=\"a\"", requestsA));
+    TEST_ASSERT_TRUE(metrics_register("t_temperature", "Temperature", nullptr, temperature));
+    TEST_ASSERT_TRUE(metrics_register("t_half", "Constant", nullptr, halfFn));
+    TEST_ASSERT_TRUE(metrics_register("t_duration_us", "Duration", nullptr, duration, DURATION_BOUNDS));
+
+    metric_inc(requestsA, 3);
+    metric_set(temperature, -4);
+    metric_observe(duration, 5);
+    metric_observe(duration, 50);
+    metric_observe(duration, 500);
+    metrics_write(out);
+
+    TEST_ASSERT_NOT_NULL(strstr(out.text, "# HELP t_requests_total Requests\n# TYPE t_requests_total counter\n"
+                                          "t_requests_total{route=\"a\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out.text, "# TYPE t_temperature gauge\nt_temperature -4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out.text, "# TYPE t_half gauge\nt_half 0.5\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out.text, "# TYPE t_duration_us histogram\n"
+                                          "t_duration_us_bucket{le=\"10\"} 1\n"
+                                          "t_duration_us_bucket{le=\"100\"} 2\n"
+                                          "t_duration_us_bucket{le=\"+Inf\"} 3\n"
+                                          "t_duration_us_sum 555\n"
+                                          "t_duration_us_count 3\n"));
+}
+
+static void test_family_written_once_and_together() {
+    // Second label variant of t_requests_total after other families
+    TEST_ASSERT_TRUE(metrics_register("t_requests_total", "Requests", "route=\"b\"", requestsB));
+    metric_inc(requestsB);
+    metrics_write(out);
+
+    TEST_ASSERT_EQUAL_INT(1, count("# HELP t_requests_total "));
+    TEST_ASSERT_EQUAL_INT(1, count("# TYPE t_requests_total "));
+    TEST_ASSERT_NOT_NULL(strstr(out.text, "t_requests_total{route=\"a\"} 3\n"
+                                          "t_requests_total{route=\"b\"} 1\n"
+                                          "# HELP t_temperature "));
+}
+
+static void test_registry_full() {
+    static MetricCounter filler[METRICS_MAX];
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < METRICS_MAX; i++) {
+        if (metrics_register("t_filler_total", "Filler", "i=\"x\"", filler[i])) accepted++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(METRICS_MAX - 5, accepted);
+}
+
+static void test_rejected_after_task_start() {
+    static MetricGauge late;
+    task_start();
+    TEST_ASSERT_FALSE(metrics_register("t_late", "Registered by a task", nullptr, late));
+    metrics_write(out);
+    TEST_ASSERT_NULL(strstr(out.text, "t_late"));
+}
+
+int main(int argc, char** argv) {
+    log_begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_format);
+    RUN_TEST(test_family_written_once_and_together);
+    RUN_TEST(test_registry_full);
+    RUN_TEST(test_rejected_after_task_start);
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/**
+ * @file test_main.cpp
+ * @brief Load shedding and power budget against the fake 12 V sense
+ *
+ * The modules keep their state between the tests, so every test leaves
+ * the supply healthy and all limits lifted.
+ */
+
+#include <unity.h>
+#include "hal_native.h"
+#include "pins.h"
+#include "analog_input.h"
+#include "power_control.h"
+#include "power_budget.h"
+#include "config_manager.h"
+#include "web_log.h"
+
+/**
+ * @brief Sets the sense input to a supply voltage (divider 100k / 22k, 3.3 V full scale)
+ */
+static void setSupply(float volts) {
+    const float divider = (100000.0f + 22000.0f) / 22000.0f;
+    hal_setAnalog(PIN_VIN_12V_SENSE, (uint16_t)(volts / divider / 3.3f * 4095.0f + 0.5f));
+}
+
+static void configure(uint8_t budget) {
+    ConfigData c;
+    config_setDefaults(c);
+    c.dew1Watts = 12;
+    c.dew2Watts = 12;
+    c.panelWatts = 6;
+    c.powerBudget = budget;
+    c.lowVoltage = 115;
+    c.criticalVoltage = 105;
+    config_update(c);
+}
+
+static void allOn() {
+    power_setDuty(POWER_DEW1, POWER_DUTY_FULL);
+    power_setDuty(POWER_DEW2, POWER_DUTY_FULL);
+    power_setDuty(POWER_PANEL, POWER_DUTY_FULL);
+}
+
+/**
+ * @brief Healthy supply until every limit is lifted again
+ */
+static void recover() {
+    configure(0);
+    setSupply(12.6f);
+    hal_runTasks(4 * POWER_RESTORE_DELAY_MS);
+}
+
+void setUp() {
+    allOn();
+}
+
+void tearDown() {
+    recover();
+}
+
+static void test_healthy_supply_no_limits() {
+    hal_runTasks(5000);
+    PowerBudgetStatus s = powerbudget_getStatus();
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 12.6f, s.voltage);
+    TEST_ASSERT_EQUAL_UINT8(0, s.shedLevel);
+    TEST_ASSERT_FALSE(s.budgetLimited);
+    for (uint8_t i = 0; i < POWER_OUTPUT_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit((PowerOutput)i));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 30.0f * (12.6f / 12) * (12.6f / 12), s.totalWatts);
+}
+
+static void test_budget_granted_in_priority_order() {
+    setSupply(12.0f);
+    configure(15);
+    hal_runTasks(5000);
+
+    // Heater 1 gets its 12 W, heater 2 the remaining 3 W, the panel does not fit
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_DEW1));
+    TEST_ASSERT_UINT16_WITHIN(POWER_DUTY_FULL / 50, POWER_DUTY_FULL / 4, power_getLimit(POWER_DEW2));
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_PANEL));
+    PowerBudgetStatus s = powerbudget_getStatus();
+    TEST_ASSERT_TRUE(s.budgetLimited);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 15.0f, s.totalWatts);
+    TEST_ASSERT_EQUAL_UINT8(0, s.shedLevel);
+
+    // The requested duty is kept: lifting the budget restores it
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getTargetDuty(POWER_PANEL));
+}
+
+static void test_low_voltage_sheds_one_output_per_step() {
+    setSupply(11.2f);
+    hal_runTasks(10 * POWER_BUDGET_INTERVAL_MS);     // filter settles, first step
+    TEST_ASSERT_EQUAL_UINT8(1, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_PANEL));
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_DEW2));
+
+    hal_runTasks(POWER_SHED_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT8(2, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_DEW2));
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_DEW1));
+
+    hal_runTasks(POWER_SHED_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT8(3, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_DEW1));
+    hal_runTasks(POWER_UPDATE_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT16(0, power_getDuty(POWER_DEW1));    // applied at the next output run, no slew
+}
+
+static void test_restore_in_reverse_order_after_delay() {
+    setSupply(11.2f);
+    hal_runTasks(10 * POWER_BUDGET_INTERVAL_MS + 3 * POWER_SHED_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT8(3, powerbudget_getStatus().shedLevel);
+
+    // Inside the hysteresis nothing comes back
+    setSupply(11.7f);
+    hal_runTasks(2 * POWER_RESTORE_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT8(3, powerbudget_getStatus().shedLevel);
+
+    setSupply(12.4f);
+    hal_runTasks(POWER_RESTORE_DELAY_MS + 10 * POWER_BUDGET_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(2, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_DEW1));
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_DEW2));
+
+    hal_runTasks(POWER_RESTORE_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT8(1, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_DEW2));
+    TEST_ASSERT_EQUAL_UINT16(0, power_getLimit(POWER_PANEL));
+}
+
+static void test_critical_voltage_sheds_everything() {
+    setSupply(10.0f);
+    hal_runTasks(10 * POWER_BUDGET_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(3, powerbudget_getStatus().shedLevel);
+    for (uint8_t i = 0; i < POWER_OUTPUT_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT16(0, power_getLimit((PowerOutput)i));
+    }
+}
+
+static void test_no_supply_is_not_watched() {
+    // USB powered only: nothing to protect, outputs stay enabled
+    setSupply(0.0f);
+    hal_runTasks(10 * POWER_BUDGET_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(0, powerbudget_getStatus().shedLevel);
+    TEST_ASSERT_EQUAL_UINT16(POWER_DUTY_FULL, power_getLimit(POWER_PANEL));
+}
+
+int main(int argc, char** argv) {
+    log_begin();
+    initPins();
+    analog_init();
+    power_init();
+    powerbudget_init();
+    recover();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_supply_no_limits);
+    RUN_TEST(test_budget_granted_in_priority_order);
+    RUN_TEST(test_low_voltage_sheds_one_output_per_step);
+    RUN_TEST(test_restore_in_reverse_order_after_delay);
+    RUN_TEST(test_critical_voltage_sheds_everything);
+    RUN_TEST(test_no_supply_is_not_watched);
+    return UNITY_END();
+}
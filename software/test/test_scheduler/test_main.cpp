@@ -0,0 +1,257 @@
+/**
+ * @file test_main.cpp
+ * @brief Deadline scheduler with fake time
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "scheduler.h"
+#include "task_manager.h"
+#include "hal_native.h"
+
+static Scheduler s;
+
+static void jobA() {}
+
+// --- Fake-time runner: the loop of a task in task_manager.cpp ---
+
+#define LOG_SIZE 64
+
+static uint32_t now;
+static uint32_t busyMs[SCHED_MAX_JOBS];     // simulated run time per job
+static struct { uint8_t job; uint32_t at; } runLog[LOG_SIZE];
+static uint8_t runCount;
+
+static void record(uint8_t job) {
+    if (runCount < LOG_SIZE) {
+        runLog[runCount].job = job;
+        runLog[runCount].at = now;
+        runCount++;
+    }
+    now += busyMs[job];
+}
+
+static void job0() { record(0); }
+static void job1() { record(1); }
+static void job2() { record(2); }
+
+/**
+ * @brief Runs all due jobs, then sleeps until the next deadline, until end
+ */
+static void runUntil(uint32_t end) {
+    while ((int32_t)(end - now) > 0) {
+        int i;
+        while ((i = sched_nextDue(s, now)) >= 0) s.jobs[i].fn();
+        uint32_t wait = sched_timeToNext(s, now);
+        if (wait == SCHED_NO_DEADLINE || (int32_t)(end - now) < (int32_t)wait) {
+            now = end;
+        } else {
+            now += wait;
+        }
+    }
+}
+
+void setUp() {
+    s.count = 0;
+    now = 0;
+    runCount = 0;
+    memset(busyMs, 0, sizeof(busyMs));
+}
+
+void tearDown() {}
+
+static void test_add_and_table_full() {
+    for (uint8_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        TEST_ASSERT_EQUAL_INT(i, sched_add(s, "job", jobA, 100, 0));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, sched_add(s, "full", jobA, 100, 0));
+}
+
+static void test_add_rejects_missing_function() {
+    TEST_ASSERT_EQUAL_INT(-1, sched_add(s, "nofn", nullptr, 100, 0));
+    TEST_ASSERT_EQUAL_UINT8(0, s.count);
+}
+
+static void test_periodic_runs_first_at_add() {
+    int a = sched_add(s, "a", jobA, 100, 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, sched_timeToNext(s, 1000));
+    TEST_ASSERT_EQUAL_INT(a, sched_nextDue(s, 1000));
+    TEST_ASSERT_EQUAL_INT(-1, sched_nextDue(s, 1000));
+    TEST_ASSERT_EQUAL_UINT32(100, sched_timeToNext(s, 1000));
+    TEST_ASSERT_EQUAL_UINT32(40, sched_timeToNext(s, 1060));
+}
+
+static void test_event_job_not_armed() {
+    sched_add(s, "ev", jobA, 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(SCHED_NO_DEADLINE, sched_timeToNext(s, 0));
+    TEST_ASSERT_EQUAL_INT(-1, sched_nextDue(s, 5000));
+}
+
+static void test_run_in_only_pulls_forward() {
+    int a = sched_add(s, "a", jobA, 1000, 0);
+    sched_nextDue(s, 0);                      // next regular deadline 1000
+    sched_runIn(s, a, 2000, 0);
+    TEST_ASSERT_EQUAL_UINT32(1000, sched_timeToNext(s, 0));
+    sched_runIn(s, a, 300, 0);
+    TEST_ASSERT_EQUAL_UINT32(300, sched_timeToNext(s, 0));
+}
+
+static void test_run_in_arms_event_job_once() {
+    int e = sched_add(s, "ev", jobA, 0, 0);
+    sched_runIn(s, e, 50, 0);
+    TEST_ASSERT_EQUAL_INT(-1, sched_nextDue(s, 49));
+    TEST_ASSERT_EQUAL_INT(e, sched_nextDue(s, 50));
+    TEST_ASSERT_EQUAL_UINT32(SCHED_NO_DEADLINE, sched_timeToNext(s, 50));
+}
+
+static void test_millis_wrap() {
+    uint32_t start = 0xFFFFFFFFUL - 50;
+    int a = sched_add(s, "a", jobA, 100, start);
+    TEST_ASSERT_EQUAL_INT(a, sched_nextDue(s, start));
+    TEST_ASSERT_EQUAL_UINT32(100, sched_timeToNext(s, start));
+    TEST_ASSERT_EQUAL_INT(-1, sched_nextDue(s, start + 99));     // wrapped past 0
+    TEST_ASSERT_EQUAL_INT(a, sched_nextDue(s, start + 100));
+}
+
+static void test_runs_in_deadline_order() {
+    sched_add(s, "slow", job0, 100, 0);
+    sched_add(s, "fast", job1, 30, 0);
+    sched_add(s, "mid", job2, 70, 0);
+    runUntil(211);
+
+    // Ties (t = 0, 210) in registration order
+    const uint8_t expectJob[] = { 0, 1, 2, 1, 1, 2, 1, 0, 1, 2, 1, 1, 0, 1, 2 };
+    const uint32_t expectAt[] = { 0, 0, 0, 30, 60, 70, 90, 100, 120, 140, 150, 180, 200, 210, 210 };
+    TEST_ASSERT_EQUAL_UINT8(sizeof(expectJob), runCount);
+    for (uint8_t i = 0; i < runCount; i++) {
+        TEST_ASSERT_EQUAL_UINT8(expectJob[i], runLog[i].job);
+        TEST_ASSERT_EQUAL_UINT32(expectAt[i], runLog[i].at);
+    }
+}
+
+static void test_short_overrun_keeps_phase() {
+    sched_add(s, "a", job0, 100, 0);
+    busyMs[0] = 30;             // every run takes 30 ms
+    runUntil(1001);
+    TEST_ASSERT_EQUAL_UINT8(11, runCount);
+    for (uint8_t i = 0; i < runCount; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i * 100UL, runLog[i].at);   // no drift by the run time
+    }
+}
+
+static void test_long_overrun_resyncs_without_burst() {
+    sched_add(s, "a", job0, 100, 0);
+    int b = sched_add(s, "b", job1, 0, 0);
+    busyMs[1] = 350;            // another job blocks the task for 3.5 periods
+    runUntil(150);
+    sched_trigger(s, b);
+    runUntil(800);
+
+    // a: 0, 100, late at 500 (once, no catch-up burst for 200..400), then every 100 from there
+    const uint32_t expectA[] = { 0, 100, 500, 600, 700 };
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < runCount; i++) {
+        if (runLog[i].job != 0) continue;
+        TEST_ASSERT_LESS_THAN(sizeof(expectA) / sizeof(expectA[0]), n);
+        TEST_ASSERT_EQUAL_UINT32(expectA[n], runLog[i].at);
+        n++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(5, n);
+}
+
+static void test_trigger_runs_before_deadline() {
+    int a = sched_add(s, "a", job0, 1000, 0);
+    runUntil(10);                   // first run at 0, next deadline 1000
+    TEST_ASSERT_EQUAL_UINT8(1, runCount);
+
+    now = 250;
+    sched_trigger(s, a);
+    TEST_ASSERT_EQUAL_UINT32(0, sched_timeToNext(s, now));
+    runUntil(260);
+    TEST_ASSERT_EQUAL_UINT8(2, runCount);
+    TEST_ASSERT_EQUAL_UINT32(250, runLog[1].at);
+
+    // The period restarts at the triggered run
+    TEST_ASSERT_EQUAL_UINT32(990, sched_timeToNext(s, now));
+}
+
+static void test_triggered_job_comes_first() {
+    sched_add(s, "due", job0, 100, 0);
+    int ev = sched_add(s, "event", job1, 0, 0);
+    runUntil(1);
+    runCount = 0;
+
+    now = 100;                      // periodic job is due ...
+    sched_trigger(s, ev);           // ... and an event arrives
+    runUntil(101);
+    TEST_ASSERT_EQUAL_UINT8(2, runCount);
+    TEST_ASSERT_EQUAL_UINT8(1, runLog[0].job);
+    TEST_ASSERT_EQUAL_UINT8(0, runLog[1].job);
+}
+
+static void test_wakeup_jitter_bounded_no_drift() {
+    // Period 50 ms, a neighbour job (30 ms) with a varying run time of 0..20 ms
+    sched_add(s, "tick", job0, 50, 0);
+    sched_add(s, "noise", job1, 30, 0);
+    uint32_t seed = 1;
+    uint32_t maxLate = 0;
+    uint32_t ticks = 0;
+    while (now < 60000) {
+        seed = seed * 1103515245UL + 12345;
+        busyMs[1] = (seed >> 16) % 21;
+        runCount = 0;
+        runUntil(now + 1);
+        for (uint8_t i = 0; i < runCount; i++) {
+            if (runLog[i].job != 0) continue;
+            uint32_t ideal = (runLog[i].at + 25) / 50 * 50;
+            uint32_t late = runLog[i].at > ideal ? runLog[i].at - ideal : 0;
+            if (late > maxLate) maxLate = late;
+            ticks++;
+        }
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%lu ticks, max wake-up lateness %lu ms", (unsigned long)ticks, (unsigned long)maxLate);
+    TEST_MESSAGE(msg);
+
+    // Late by at most one neighbour run, and no tick lost over 60 s
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(20, maxLate);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(60000 / 50, ticks);
+}
+
+// --- Through the task manager API (native single-threaded runner) ---
+
+static uint32_t taskRuns;
+static uint32_t taskRunAt;
+static void taskJob() { taskRuns++; taskRunAt = millis(); }
+
+static void test_task_trigger_runs_job_early() {
+    hal_setMillis(0);
+    TaskJobId id = task_register(TASK_NET, "slow", taskJob, 10000);
+    hal_runTasks(100);
+    TEST_ASSERT_EQUAL_UINT32(1, taskRuns);       // first run at registration time
+
+    hal_runTasks(400);
+    task_trigger(id);
+    hal_runTasks(5);
+    TEST_ASSERT_EQUAL_UINT32(2, taskRuns);
+    TEST_ASSERT_EQUAL_UINT32(500, taskRunAt);    // not at 10000
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_and_table_full);
+    RUN_TEST(test_add_rejects_missing_function);
+    RUN_TEST(test_periodic_runs_first_at_add);
+    RUN_TEST(test_event_job_not_armed);
+    RUN_TEST(test_run_in_only_pulls_forward);
+    RUN_TEST(test_run_in_arms_event_job_once);
+    RUN_TEST(test_millis_wrap);
+    RUN_TEST(test_runs_in_deadline_order);
+    RUN_TEST(test_short_overrun_keeps_phase);
+    RUN_TEST(test_long_overrun_resyncs_without_burst);
+    RUN_TEST(test_trigger_runs_before_deadline);
+    RUN_TEST(test_triggered_job_comes_first);
+    RUN_TEST(test_wakeup_jitter_bounded_no_drift);
+    RUN_TEST(test_task_trigger_runs_job_early);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_main.cpp
+ * @brief Snapshot<T> publish/read, single-threaded and under concurrent readers
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "snapshot.h"
+
+struct Sample {
+    uint32_t a;
+    float b;
+    char text[20];
+};
+
+void setUp() {}
+void tearDown() {}
+
+static void test_default_is_zero() {
+    Snapshot<Sample> snap;
+    Sample s = snap.read();
+    TEST_ASSERT_EQUAL_UINT32(0, s.a);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.b);
+    TEST_ASSERT_EQUAL_STRING("", s.text);
+}
+
+static void test_initial_value() {
+    Sample init = { 7, 1.5f, "boot" };
+    Snapshot<Sample> snap(init);
+    Sample s = snap.read();
+    TEST_ASSERT_EQUAL_UINT32(7, s.a);
+    TEST_ASSERT_EQUAL_STRING("boot", s.text);
+}
+
+static void test_read_returns_latest() {
+    Snapshot<Sample> snap;
+    for (uint32_t i = 1; i <= 5; i++) {
+        Sample v = { i, i * 0.5f, "" };
+        snprintf(v.text, sizeof(v.text), "value %lu", (unsigned long)i);
+        snap.publish(v);
+        Sample s = snap.read();
+        TEST_ASSERT_EQUAL_UINT32(i, s.a);
+        TEST_ASSERT_EQUAL_FLOAT(i * 0.5f, s.b);
+        TEST_ASSERT_EQUAL_STRING(v.text, s.text);
+    }
+}
+
+static void test_read_is_a_copy() {
+    Snapshot<Sample> snap;
+    Sample v = { 1, 0, "one" };
+    snap.publish(v);
+    Sample s = snap.read();
+    v.a = 2;
+    snap.publish(v);
+    TEST_ASSERT_EQUAL_UINT32(1, s.a);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.read().a);
+}
+
+// ---------------- Stress: one writer, several reader threads ----------------
+
+#define STRESS_READERS 3
+#define STRESS_MS 1500
+
+/**
+ * @brief Large enough that a copy is often preempted; every word is derived
+ *        from one counter, so a torn copy breaks the invariant.
+ */
+struct Frame {
+    uint32_t counter;
+    uint32_t words[1000];   ///< words[i] == counter * 2654435761 + i
+    uint32_t check;         ///< ~counter
+};
+
+static Snapshot<Frame> frames;
+static std::atomic<bool> stressRunning;
+
+struct ReaderStats {
+    uint32_t reads;
+    uint32_t torn;
+    uint32_t backwards;     ///< Older value than one seen before
+    uint32_t lastCounter;
+};
+
+static void fill(Frame &f, uint32_t counter) {
+    f.counter = counter;
+    for (uint32_t i = 0; i < sizeof(f.words) / sizeof(f.words[0]); i++) {
+        f.words[i] = (uint32_t)(counter * 2654435761u + i);
+    }
+    f.check = ~counter;
+}
+
+static bool consistent(const Frame &f) {
+    if (f.check != ~f.counter) return false;
+    for (uint32_t i = 0; i < sizeof(f.words) / sizeof(f.words[0]); i++) {
+        if (f.words[i] != (uint32_t)(f.counter * 2654435761u + i)) return false;
+    }
+    return true;
+}
+
+static void readerThread(ReaderStats* stats) {
+    while (stressRunning.load(std::memory_order_relaxed)) {
+        Frame f = frames.read();
+        stats->reads++;
+        if (!consistent(f)) stats->torn++;
+        else if (f.counter < stats->lastCounter) stats->backwards++;
+        else stats->lastCounter = f.counter;
+    }
+}
+
+static void test_concurrent_readers_never_see_torn_values() {
+    static Frame f;
+    fill(f, 0);
+    frames.publish(f);
+
+    ReaderStats stats[STRESS_READERS] = {};
+    stressRunning = true;
+    std::thread readers[STRESS_READERS];
+    for (uint8_t i = 0; i < STRESS_READERS; i++) readers[i] = std::thread(readerThread, &stats[i]);
+
+    // Single writer: this thread
+    uint32_t published = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(STRESS_MS);
+    while (std::chrono::steady_clock::now() < end) {
+        fill(f, ++published);
+        frames.publish(f);
+    }
+    stressRunning = false;
+    for (uint8_t i = 0; i < STRESS_READERS; i++) readers[i].join();
+
+    uint32_t reads = 0;
+    for (uint8_t i = 0; i < STRESS_READERS; i++) {
+        reads += stats[i].reads;
+        TEST_ASSERT_EQUAL_UINT32(0, stats[i].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, stats[i].backwards);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(published, stats[i].lastCounter);
+    }
+    char msg[80];
+    snprintf(msg, sizeof(msg), "%lu publishes, %lu consistent reads", (unsigned long)published, (unsigned long)reads);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(1000, published);
+    TEST_ASSERT_GREATER_THAN_UINT32(1000, reads);
+    TEST_ASSERT_EQUAL_UINT32(published, frames.read().counter);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_is_zero);
+    RUN_TEST(test_initial_value);
+    RUN_TEST(test_read_returns_latest);
+    RUN_TEST(test_read_is_a_copy);
+    RUN_TEST(test_concurrent_readers_never_see_torn_values);
+    return UNITY_END();
+}
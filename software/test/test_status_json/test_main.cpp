@@ -0,0 +1,231 @@
+/**
+ * @file test_main.cpp
+ * @brief Size, content and cost of the /status document
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include "status_json.h"
+#include "json_writer.h"
+
+// ---------------- Heap accounting ----------------
+
+static size_t heapCalls;
+static size_t heapBytes;
+static size_t heapPeak;
+
+void* operator new(size_t n) {
+    heapCalls++;
+    heapBytes += n;
+    if (heapBytes > heapPeak) heapPeak = heapBytes;
+    size_t* p = (size_t*)malloc(n + sizeof(size_t));
+    if (p == nullptr) throw std::bad_alloc();
+    *p = n;
+    return p + 1;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    size_t* q = (size_t*)p - 1;
+    heapBytes -= *q;
+    free(q);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+static void heapReset() {
+    heapCalls = 0;
+    heapPeak = heapBytes;
+}
+
+// ---------------- Samples ----------------
+
+/**
+ * @brief Widest value of every field
+ *
+ * Values from the cover come from the wire: the parser accepts up to 9
+ * digits per number and any byte but 'A' in the firmware field, which
+ * JsonWriter escapes as \u00XX. Local values are bounded by the sensor or
+ * the controller.
+ */
+static void worstCase(StatusSample &s) {
+    memset(&s, 0, sizeof(s));
+    s.bmePresent = false;
+    s.bmeTemp = -40.0f;                 // BME280 range -40..85 °C
+    s.bmeHum = 100.0f;
+    s.bmePres = 1100.0f;                // 300..1100 hPa
+    s.voltage = -99.99f;
+    s.systime = 4294967295UL;
+    memset(s.time, '8', sizeof(s.time) - 1);
+
+    s.dewTemp = -40.0f;
+    s.dewHum = 100.0f;
+    s.dewPoint = -99.99f;
+    s.dew1 = 100;                       // %
+    s.dew1Max = 100;
+    s.dew2 = 100;
+    s.dew2Max = 100;
+    s.dewActive = false;
+    s.dewTrend = -9999.99f;             // °C/h from a fit over a few minutes
+    s.lens1 = -127.0f;                  // DS18B20 range -55..125, NTC clamped
+    s.lens2 = -127.0f;
+
+    s.supply = -99.99f;
+    s.powerTotal = 999.99f;             // 3 outputs of at most 255 W
+    s.shedLevel = 3;
+    s.budgetLimited = false;
+
+    memset(s.firmware, 0x01, sizeof(s.firmware) - 1);
+    s.closePos = -999999999.0f;
+    s.openPos = -999999999.0f;
+    s.curPos = -999999999.0f;
+    s.inputVoltage = -999999999.0f;
+    s.brightness = -999999999;
+    s.dewHeater = -999999999;
+    s.asiair = -999999999;
+    s.connected = false;
+    s.poti = 255;
+}
+
+static void typical(StatusSample &s) {
+    memset(&s, 0, sizeof(s));
+    s.bmePresent = true;
+    s.bmeTemp = 4.5f;
+    s.bmeHum = 82.3f;
+    s.bmePres = 1013.2f;
+    s.voltage = 12.45f;
+    s.systime = 123456;
+    strcpy(s.time, "21:42");
+    s.dewTemp = 4.5f;
+    s.dewHum = 82.3f;
+    s.dewPoint = 1.7f;
+    s.dew1 = 40;
+    s.dew1Max = 80;
+    s.dew2 = 20;
+    s.dew2Max = 80;
+    s.dewActive = true;
+    s.lens1 = NAN;
+    s.lens2 = NAN;
+    s.supply = 12.45f;
+    s.powerTotal = 9.6f;
+    strcpy(s.firmware, "20240101");
+    s.closePos = 10.5f;
+    s.openPos = 270.0f;
+    s.curPos = 270.0f;
+    s.inputVoltage = 12.3f;
+    s.brightness = 128;
+    s.connected = true;
+    s.poti = 200;
+}
+
+static char buf[STATUS_JSON_MAX];
+
+void setUp() {}
+void tearDown() {}
+
+// ---------------- Tests ----------------
+
+static void test_worst_case_fits() {
+    StatusSample s;
+    typical(s);
+    JsonBuffer typ(buf, sizeof(buf));
+    status_json_write(typ, s, nullptr);
+    size_t typicalLen = typ.length();
+
+    worstCase(s);
+    JsonBuffer json(buf, sizeof(buf));
+    status_json_write(json, s, nullptr);
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "typical %u, worst case %u of %u bytes",
+             (unsigned)typicalLen, (unsigned)json.length(), (unsigned)STATUS_JSON_MAX);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FALSE(json.overflow());
+    TEST_ASSERT_EQUAL('}', buf[json.length() - 1]);
+}
+
+static void test_typical_document() {
+    StatusSample s;
+    typical(s);
+    JsonBuffer json(buf, sizeof(buf));
+    status_json_write(json, s, nullptr);
+    TEST_ASSERT_FALSE(json.overflow());
+
+    TEST_ASSERT_EQUAL_STRING_LEN("{\"bme\":{\"present\":true,\"temperature\":4.50,", buf, 42);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"lens1Temperature\":null"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "},\"power\":{\"supplyVoltage\":12.45,"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"wanderer\":{\"firmware\":\"20240101\","));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"poti_brightness\":200}}"));
+}
+
+static void test_delta_only_changed_fields() {
+    StatusSample a, b;
+    typical(a);
+    b = a;
+    TEST_ASSERT_FALSE(status_json_changed(b, a));
+
+    b.systime += 500;               // always sent, never a reason for an event
+    b.bmeTemp += 0.01f;             // inside the dead band
+    TEST_ASSERT_FALSE(status_json_changed(b, a));
+
+    b.dew1 = 45;
+    b.curPos = 100.0f;
+    TEST_ASSERT_TRUE(status_json_changed(b, a));
+
+    JsonBuffer json(buf, sizeof(buf));
+    status_json_write(json, b, &a);
+    TEST_ASSERT_EQUAL_STRING("{\"bme\":{\"systime\":123956},\"dew\":{\"dew1Power\":45},"
+                             "\"wanderer\":{\"current_position\":100.00}}", buf);
+
+    status_json_markSent(a, b);
+    TEST_ASSERT_EQUAL_INT32(45, a.dew1);
+    TEST_ASSERT_FALSE(status_json_changed(b, a));
+}
+
+static void test_no_heap_and_time() {
+    StatusSample s;
+    worstCase(s);
+    const uint32_t runs = 20000;
+
+    heapReset();
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < runs; i++) {
+        JsonBuffer json(buf, sizeof(buf));
+        status_json_write(json, s, nullptr);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    size_t calls = heapCalls;
+
+    // Previous path: the document serialised into a growing String
+    heapReset();
+    size_t before = heapBytes;
+    {
+        JsonBuffer json(buf, sizeof(buf));
+        status_json_write(json, s, nullptr);
+        String str;
+        for (size_t i = 0; i < json.length(); i++) str += buf[i];
+    }
+    size_t stringCalls = heapCalls;
+    size_t stringPeak = heapPeak - before;
+
+    char msg[112];
+    snprintf(msg, sizeof(msg), "%.2f us per document, %u heap calls; String output: %u calls, %u bytes peak",
+             std::chrono::duration<double, std::micro>(t1 - t0).count() / runs, (unsigned)calls,
+             (unsigned)stringCalls, (unsigned)stringPeak);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32(0, calls);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_worst_case_fits);
+    RUN_TEST(test_typical_document);
+    RUN_TEST(test_delta_only_changed_fields);
+    RUN_TEST(test_no_heap_and_time);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/**
+ * @file test_main.cpp
+ * @brief Throughput of the incremental cover status parser against the
+ *        previous strcpy/strtok parser (kept here as reference)
+ *
+ * Run alone to get stable numbers: pio test -e native -f test_wanderer_bench
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+#include "wanderer_parser.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#endif
+
+#define BENCH_LINES 20000
+#define BENCH_ROUNDS 5
+
+static const char* const LINES[] = {
+    "WandererCoverV4A20240101A10.5A270.0A-3.25A12.3A128A50A1\n",
+    "WandererCoverV4A20231115A0A180A179.99A11.87A0A0A0\r\n",
+    "WandererCoverV4A20240101A12.25A265.5A88.125A13.05A255A150A1\n",
+};
+#define LINE_COUNT (sizeof(LINES) / sizeof(LINES[0]))
+
+// ---------------- Reference: parser before the incremental one ----------------
+
+/**
+ * @brief usb_manager_update() of the previous version without the USB and
+ *        LOG calls: raw copy on every byte, strtok/atof on the line copy.
+ */
+struct LegacyParser {
+    char current_status[256];
+    char read_buffer[512];
+    size_t buf_idx;
+    WandererStatus parsed_status;
+
+    bool feed(char c) {
+        if (buf_idx < sizeof(read_buffer) - 1) {
+            read_buffer[buf_idx++] = c;
+        }
+        strcpy(current_status, read_buffer);
+        if (c != '\n') return false;
+
+        read_buffer[buf_idx] = '\0';
+        strcpy(current_status, read_buffer);
+
+        char temp[256];
+        strcpy(temp, current_status);
+        bool ok = false;
+        char* token = strtok(temp, "A");
+        if (token && strcmp(token, "WandererCoverV4") == 0) {
+            token = strtok(NULL, "A");
+            if (token) strncpy(parsed_status.firmware, token, sizeof(parsed_status.firmware) - 1);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.close_position = atof(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.open_position = atof(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.current_position = atof(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.input_voltage = atof(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.brightness = (int)atoi(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.dew_heater = (int)atoi(token);
+            token = strtok(NULL, "A");
+            if (token) parsed_status.asiair_enabled = (int)atoi(token);
+            ok = true;
+        }
+        buf_idx = 0;
+        return ok;
+    }
+};
+
+static LegacyParser legacy;
+static WandererParser parser;
+
+// ---------------- Timing ----------------
+
+struct BenchResult {
+    double nsPerByte;
+    double bytesPerCycle;   ///< 0 without a cycle counter
+    uint32_t lines;         ///< Valid lines seen
+};
+
+static uint64_t cycles() {
+#ifdef BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Best of BENCH_ROUNDS runs over BENCH_LINES lines
+ */
+template <typename Feed>
+static BenchResult bench(Feed feed) {
+    BenchResult best = { 1e9, 0, 0 };
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t bytes = 0;
+        uint32_t lines = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = cycles();
+        for (uint32_t i = 0; i < BENCH_LINES; i++) {
+            for (const char* s = LINES[i % LINE_COUNT]; *s; s++) {
+                if (feed(*s)) lines++;
+                bytes++;
+            }
+        }
+        uint64_t c1 = cycles();
+        auto t1 = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (ns / bytes < best.nsPerByte) {
+            best.nsPerByte = ns / bytes;
+            best.bytesPerCycle = c1 > c0 ? (double)bytes / (c1 - c0) : 0;
+            best.lines = lines;
+        }
+    }
+    return best;
+}
+
+static BenchResult benchLegacy() {
+    return bench([](char c) { return legacy.feed(c); });
+}
+
+static BenchResult benchIncremental() {
+    return bench([](char c) { return wparser_feed(parser, c) == WPARSE_OK; });
+}
+
+static void report(const char* name, const BenchResult &r) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%-11s %6.2f ns/byte, %.3f bytes/cycle", name, r.nsPerByte, r.bytesPerCycle);
+    TEST_MESSAGE(msg);
+}
+
+void setUp() {
+    memset(&legacy, 0, sizeof(legacy));
+    memset(&parser, 0, sizeof(parser));
+    wparser_reset(parser);
+}
+
+void tearDown() {}
+
+// ---------------- Tests ----------------
+
+static void test_same_result_as_reference() {
+    for (uint8_t i = 0; i < LINE_COUNT; i++) {
+        bool legacyOk = false;
+        WParseResult r = WPARSE_PENDING;
+        for (const char* s = LINES[i]; *s; s++) {
+            legacyOk |= legacy.feed(*s);
+            WParseResult ri = wparser_feed(parser, *s);
+            if (ri != WPARSE_PENDING) r = ri;
+        }
+        TEST_ASSERT_TRUE(legacyOk);
+        TEST_ASSERT_EQUAL_INT(WPARSE_OK, r);
+
+        // The reference keeps the '\r' of CRLF lines in the last field, atoi() ignores it
+        const WandererStatus &ref = legacy.parsed_status;
+        const WandererStatus &got = parser.status;
+        TEST_ASSERT_EQUAL_STRING(ref.firmware, got.firmware);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, ref.close_position, got.close_position);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, ref.open_position, got.open_position);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, ref.current_position, got.current_position);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, ref.input_voltage, got.input_voltage);
+        TEST_ASSERT_EQUAL_INT(ref.brightness, got.brightness);
+        TEST_ASSERT_EQUAL_INT(ref.dew_heater, got.dew_heater);
+        TEST_ASSERT_EQUAL_INT(ref.asiair_enabled, got.asiair_enabled);
+    }
+}
+
+static void test_throughput_against_reference() {
+    BenchResult old = benchLegacy();
+    BenchResult now = benchIncremental();
+    report("strtok:", old);
+    report("incremental:", now);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "speed-up %.1fx", old.nsPerByte / now.nsPerByte);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCH_LINES, old.lines);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_LINES, now.lines);
+
+    // The reference copies the whole line on every byte, the margin is large
+    TEST_ASSERT_TRUE_MESSAGE(now.nsPerByte < old.nsPerByte / 2, "not faster than the reference");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_same_result_as_reference);
+    RUN_TEST(test_throughput_against_reference);
+    return UNITY_END();
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_main.cpp
+ * @brief Incremental parser of the WandererCoverV4 status line
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "wanderer_parser.h"
+
+static WandererParser p;
+
+/**
+ * @brief Feeds a string, returns the result of the last byte that was not PENDING
+ */
+static WParseResult feed(const char* s) {
+    WParseResult last = WPARSE_PENDING;
+    for (; *s; s++) {
+        WParseResult r = wparser_feed(p, *s);
+        if (r != WPARSE_PENDING) last = r;
+    }
+    return last;
+}
+
+void setUp() {
+    memset(&p, 0, sizeof(p));
+    wparser_reset(p);
+}
+
+void tearDown() {}
+
+static void test_valid_line() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, feed("WandererCoverV4A20240101A10.5A270.0A-3.25A12.3A128A50A1\n"));
+    TEST_ASSERT_EQUAL_STRING("20240101", p.status.firmware);
+    TEST_ASSERT_EQUAL_FLOAT(10.5f, p.status.close_position);
+    TEST_ASSERT_EQUAL_FLOAT(270.0f, p.status.open_position);
+    TEST_ASSERT_EQUAL_FLOAT(-3.25f, p.status.current_position);
+    TEST_ASSERT_EQUAL_FLOAT(12.3f, p.status.input_voltage);
+    TEST_ASSERT_EQUAL_INT(128, p.status.brightness);
+    TEST_ASSERT_EQUAL_INT(50, p.status.dew_heater);
+    TEST_ASSERT_EQUAL_INT(1, p.status.asiair_enabled);
+}
+
+static void test_crlf_and_empty_lines() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_PENDING, feed("\r\n\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, feed("WandererCoverV4A1A1A2A3A4A5A6A0\r\n"));
+}
+
+static void test_result_only_at_newline() {
+    const char* line = "WandererCoverV4A1A1A2A3A4A5A6A0";
+    for (const char* c = line; *c; c++) {
+        TEST_ASSERT_EQUAL_INT(WPARSE_PENDING, wparser_feed(p, *c));
+    }
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, wparser_feed(p, '\n'));
+}
+
+static void test_wrong_header() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV3A1A1A2A3A4A5A6A0\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4xA1A1A2A3A4A5A6A0\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererA1A1A2A3A4A5A6A0\n"));
+}
+
+static void test_field_count() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1A2A3A4A5A6\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1A2A3A4A5A6A0A9\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1AA3A4A5A6A0\n"));
+}
+
+static void test_bad_numbers() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1.2.3A2A3A4A5A6A0\n"));     // two points
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1A2A3A4A5.5A6A0\n"));       // fraction in an int field
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1A2-A3A4A5A6A0\n"));        // sign not first
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("WandererCoverV4A1A1234567890A2A3A4A5A6A0\n")); // too many digits
+}
+
+static void test_recovers_after_error() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_ERROR, feed("garbage\n"));
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, feed("WandererCoverV4A7A1A2A3A4A5A6A0\n"));
+    TEST_ASSERT_EQUAL_STRING("7", p.status.firmware);
+}
+
+static void test_overlong_line() {
+    WParseResult r = WPARSE_PENDING;
+    for (uint16_t i = 0; i < WPARSER_MAX_LINE + 1 && r == WPARSE_PENDING; i++) r = wparser_feed(p, '1');
+    TEST_ASSERT_EQUAL_INT(WPARSE_OVERFLOW, r);
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, feed("WandererCoverV4A1A1A2A3A4A5A6A0\n"));
+}
+
+static void test_long_firmware_truncated() {
+    TEST_ASSERT_EQUAL_INT(WPARSE_OK, feed("WandererCoverV4A12345678901234567890123456789A1A2A3A4A5A6A0\n"));
+    TEST_ASSERT_EQUAL(sizeof(p.status.firmware) - 1, strlen(p.status.firmware));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_valid_line);
+    RUN_TEST(test_crlf_and_empty_lines);
+    RUN_TEST(test_result_only_at_newline);
+    RUN_TEST(test_wrong_header);
+    RUN_TEST(test_field_count);
+    RUN_TEST(test_bad_numbers);
+    RUN_TEST(test_recovers_after_error);
+    RUN_TEST(test_overlong_line);
+    RUN_TEST(test_long_firmware_truncated);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_main.cpp
+ * @brief Argument packing and formatting of log records
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <chrono>
+#include "web_log.h"
+
+static LogRecord rec;
+static char line[LOG_LINE_MAX];
+static char sinkLine[LOG_LINE_MAX];
+
+static void captureSink(const LogRecord &r, const char* text) {
+    strncpy(sinkLine, text, sizeof(sinkLine) - 1);
+}
+
+/**
+ * @brief Packs the arguments into rec like webLogf() and formats it
+ */
+template <typename... Args>
+static const char* pack(const char* fmt, const Args &... args) {
+    rec.argLen = 0;
+    rec.truncated = false;
+    rec.fmt = fmt;
+    LogPacker packer{&rec};
+    (packer.put(args), ...);
+    log_format(rec, line, sizeof(line));
+    return line;
+}
+
+void setUp() {
+    sinkLine[0] = '\0';
+}
+
+void tearDown() {}
+
+static void test_all_arguments_fit() {
+    TEST_ASSERT_EQUAL_STRING("a=1 b=x c=2.50 p=50%", pack("a=%d b=%s c=%.2f p=%u%%", 1, "x", 2.5f, 50u));
+    TEST_ASSERT_FALSE(rec.truncated);
+}
+
+static void test_argument_width_printed_as_written() {
+    // The width/precision arguments are skipped, the following ones stay in place
+    TEST_ASSERT_EQUAL_STRING("[%*d] [%-*.*s] 7", pack("[%*d] [%-*.*s] %d", 5, 1, 4, 2, "abc", 7));
+    TEST_ASSERT_EQUAL_STRING("%*u", pack("%*u", 3, 1u));
+}
+
+static void test_stops_at_first_argument_that_does_not_fit() {
+    // 9 ints (81 bytes) + 10 characters (12): the next int does not fit,
+    // the short string after it would, but must not be packed
+    pack("%d%d%d%d%d%d%d%d%d %s %d %s", 1, 2, 3, 4, 5, 6, 7, 8, 9, "abcdefghij", 10, "x");
+    TEST_ASSERT_TRUE(rec.truncated);
+    TEST_ASSERT_EQUAL_UINT8(93, rec.argLen);
+    TEST_ASSERT_EQUAL_STRING("123456789 abcdefghij " LOG_TRUNCATED_MARK, line);
+}
+
+static void test_cut_string_is_last_argument() {
+    char text[121];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    pack("%s|%d", text, 1);
+    TEST_ASSERT_TRUE(rec.truncated);
+    TEST_ASSERT_EQUAL_UINT8(LOG_ARG_BYTES, rec.argLen);
+    // 98 characters fit, the format text goes on up to the missing %d
+    TEST_ASSERT_EQUAL(LOG_ARG_BYTES - 2 + 1 + strlen(LOG_TRUNCATED_MARK), strlen(line));
+    TEST_ASSERT_EQUAL_STRING("a|" LOG_TRUNCATED_MARK, line + LOG_ARG_BYTES - 3);
+}
+
+static void test_mark_fits_into_short_buffer() {
+    pack("%s %d", "abcdefgh", 1);
+    char small[8];
+    rec.truncated = true;
+    log_format(rec, small, sizeof(small));
+    TEST_ASSERT_EQUAL_STRING("abcd" LOG_TRUNCATED_MARK, small);
+}
+
+static void test_plain_message_truncated() {
+    char text[150];
+    memset(text, 'm', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    webLog(text);
+    TEST_ASSERT_EQUAL(LOG_ARG_BYTES + strlen(LOG_TRUNCATED_MARK), strlen(sinkLine));
+    TEST_ASSERT_EQUAL_STRING(LOG_TRUNCATED_MARK, sinkLine + LOG_ARG_BYTES);
+
+    webLog("short");
+    TEST_ASSERT_EQUAL_STRING("short", sinkLine);
+}
+
+static void test_logf_through_ring() {
+    webLogf(LOG_LEVEL_INFO, LOG_MOD_CORE, "%d%d%d%d%d%d%d%d%d%d%d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2);
+    TEST_ASSERT_EQUAL_STRING("12345678901 " LOG_TRUNCATED_MARK, sinkLine);
+}
+
+static void test_level_api() {
+    TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_OFF, log_getLevel(LOG_MOD_COUNT));
+    TEST_ASSERT_TRUE(log_setLevel(LOG_MOD_DEW, LOG_LEVEL_WARN));
+    TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_WARN, log_getLevel(LOG_MOD_DEW));
+    TEST_ASSERT_FALSE(log_enabled(LOG_MOD_DEW, LOG_LEVEL_INFO));
+    TEST_ASSERT_TRUE(log_enabled(LOG_MOD_DEW, LOG_LEVEL_ERROR));
+    TEST_ASSERT_FALSE(log_setLevel(LOG_MOD_DEW, LOG_LEVEL_OFF + 1));
+    TEST_ASSERT_FALSE(log_setLevel(LOG_MOD_COUNT + 1, LOG_LEVEL_INFO));
+    TEST_ASSERT_TRUE(log_setLevel(LOG_MOD_COUNT, LOG_LEVEL_INFO));     // all
+    TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_INFO, log_getLevel(LOG_MOD_DEW));
+    TEST_ASSERT_EQUAL_INT(LOG_MOD_COUNT, log_moduleFromName("ALL"));
+    TEST_ASSERT_EQUAL_INT(LOG_LEVEL_DEBUG, log_levelFromName("debug"));
+    TEST_ASSERT_EQUAL_INT(-1, log_moduleFromName("nope"));
+}
+
+/**
+ * @brief ns per call of the dew controller cycle message
+ */
+static double dewLineCost(uint32_t calls) {
+    volatile float t = 3.5f, h = 81.2f, td = 0.6f, lens = 4.1f, duty = 35.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; i++) {
+        LOG_AT(LOG_LEVEL_INFO,
+               "DewCtrl: T=%.1fC RH=%.1f%% Td=%.1fC Δ=%.2f (%+.2f/h) %s L1=%.1fC L2=%.1fC → D1=%.1f%% D2=%.1f%%",
+               t, h, td, t - td, 0.1f, "ramp", lens, lens, duty, duty);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / calls;
+}
+
+static void test_filtered_call_is_cheap() {
+    log_setLevel(LOG_MODULE, LOG_LEVEL_OFF);
+    double filtered = dewLineCost(1000000);
+    log_setLevel(LOG_MODULE, LOG_LEVEL_INFO);
+    double enabled = dewLineCost(20000);    // claim, pack, format (drained at once before task start)
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "dew cycle line: %.1f ns filtered at runtime, %.0f ns logged", filtered, enabled);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(filtered * 20 < enabled, "runtime filter is not cheap");
+}
+
+int main(int argc, char** argv) {
+    log_begin();        // tasks not started: records are drained at once
+    log_addSink(captureSink);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_all_arguments_fit);
+    RUN_TEST(test_argument_width_printed_as_written);
+    RUN_TEST(test_stops_at_first_argument_that_does_not_fit);
+    RUN_TEST(test_cut_string_is_last_argument);
+    RUN_TEST(test_mark_fits_into_short_buffer);
+    RUN_TEST(test_plain_message_truncated);
+    RUN_TEST(test_logf_through_ring);
+    RUN_TEST(test_level_api);
+    RUN_TEST(test_filtered_call_is_cheap);
+    return UNITY_END();
+}